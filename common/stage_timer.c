@@ -0,0 +1,47 @@
+/*
+ * stage_timer.c
+ * Host stage timer table shared by the C simulators
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "stage_timer.h"
+
+unsigned long long
+stage_timer_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void
+stage_timer_print(const char *const names[], const unsigned long long stage_ns[],
+                  int count, int cycles, int committed)
+{
+    unsigned long long total = 0;
+    int i;
+
+    if (cycles < 1)
+    {
+        cycles = 1;
+    }
+    for (i = 0; i < count; ++i)
+    {
+        total += stage_ns[i];
+    }
+
+    printf("Host stage timers (cycles = %d instructions = %d):\n", cycles, committed);
+    printf("  %-10s %12s %10s %10s %7s\n", "stage", "total_us", "ns/cycle", "ns/insn",
+           "share");
+    for (i = 0; i < count; ++i)
+    {
+        printf("  %-10s %12.1f %10.1f %10.1f %6.1f%%\n", names[i], stage_ns[i] / 1000.0,
+               (double)stage_ns[i] / cycles,
+               committed ? (double)stage_ns[i] / committed : 0.0,
+               total ? 100.0 * stage_ns[i] / total : 0.0);
+    }
+    printf("  %-10s %12.1f %10.1f %10.1f\n", "total", total / 1000.0, (double)total / cycles,
+           committed ? (double)total / committed : 0.0);
+}
@@ -0,0 +1,35 @@
+/*
+ * stage_timer.h
+ * Host time per pipeline stage, shared by the C simulators (proj1 and
+ * proj2/APEX OOO C). Each simulator keeps its own stage list and
+ * stage_ns array; stages are timed only when ENABLE_STAGE_TIMERS from its
+ * apex_macros.h is set
+ */
+#ifndef _STAGE_TIMER_H_
+#define _STAGE_TIMER_H_
+
+/* CLOCK_MONOTONIC in nanoseconds */
+unsigned long long stage_timer_now_ns(void);
+
+/*
+ * Runs one stage and charges the host time it took to that stage.
+ * ENABLE_STAGE_TIMERS is read where the macro is used, so a build without
+ * timers runs the bare call
+ */
+#define TIMED_STAGE(stage_ns, timer, call)                                  \
+    do                                                                      \
+    {                                                                       \
+        unsigned long long start_ns =                                       \
+            ENABLE_STAGE_TIMERS ? stage_timer_now_ns() : 0;                 \
+        call;                                                               \
+        if (ENABLE_STAGE_TIMERS)                                            \
+        {                                                                   \
+            (stage_ns)[timer] += stage_timer_now_ns() - start_ns;           \
+        }                                                                   \
+    } while (0)
+
+/* Prints host nanoseconds per simulated cycle and per retired instruction */
+void stage_timer_print(const char *const names[], const unsigned long long stage_ns[],
+                       int count, int cycles, int committed);
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "apex_cpu.h"
 #include "apex_macros.h"
+#include "stage_timer.h"
 
 /* Converts the PC(4000 series) into array index for code memory
  *
@@ -159,6 +160,7 @@ APEX_fetch(APEX_CPU *cpu)
         if (cpu->fetch_from_next_cycle == TRUE)
         {
             cpu->fetch_from_next_cycle = FALSE;
+            cpu->control_redirects++;
 
             /* Skip this cycle*/
             return;
@@ -390,6 +392,7 @@ APEX_decode(APEX_CPU *cpu)
         }
         else
         {
+            cpu->decode_stalls++;
             if (ENABLE_DEBUG_MESSAGES)
             {
                 printf("Decode: Instruction stalled\n");
@@ -821,6 +824,10 @@ APEX_writeback(APEX_CPU *cpu)
 
         /* Instruction completed, increment counter */
         cpu->insn_completed++;
+        if (cpu->writeback.opcode >= 0 && cpu->writeback.opcode < NUM_OPCODES)
+        {
+            cpu->opcode_count[cpu->writeback.opcode]++;
+        }
         cpu->writeback.has_insn = FALSE;
 
         if (ENABLE_DEBUG_MESSAGES)
@@ -839,6 +846,85 @@ APEX_writeback(APEX_CPU *cpu)
     return 0;
 }
 
+/*
+ * Prints host nanoseconds per simulated cycle and per retired instruction
+ * for every stage, when ENABLE_STAGE_TIMERS is set
+ */
+void
+print_stage_timers(const APEX_CPU *cpu)
+{
+    static const char *const names[STAGE_TIMER_COUNT] = {"fetch", "decode", "execute",
+                                                         "memory", "writeback"};
+
+    if (!ENABLE_STAGE_TIMERS)
+    {
+        return;
+    }
+    stage_timer_print(names, cpu->stage_ns, STAGE_TIMER_COUNT, cpu->clock,
+                      cpu->insn_completed);
+}
+
+static double
+stat_ipc(const void *ctx)
+{
+    const APEX_CPU *cpu = ctx;
+    return cpu->clock ? (double)cpu->insn_completed / cpu->clock : 0.0;
+}
+
+static double
+stat_cpi(const void *ctx)
+{
+    const APEX_CPU *cpu = ctx;
+    return cpu->insn_completed ? (double)cpu->clock / cpu->insn_completed : 0.0;
+}
+
+static double
+stat_redirect_rate(const void *ctx)
+{
+    const APEX_CPU *cpu = ctx;
+    return cpu->insn_completed ? (double)cpu->control_redirects / cpu->insn_completed : 0.0;
+}
+
+/* Registers the CPU counters, the registry only keeps pointers to them */
+static void
+APEX_register_stats(APEX_CPU *cpu)
+{
+    static const char *const opcode_names[NUM_OPCODES] = {
+        "ADD", "SUB", "MUL", "DIV", "AND", "OR", "XOR", "MOVC", "LOAD",
+        "STORE", "BZ", "BNZ", "HALT", "CMP", "CML", "JALR", "JUMP", "LDR",
+        "STR", "ADDL", "SUBL", "BP", "BNP", "BN", "NOP"};
+
+    stats_init(&cpu->stats);
+    stats_add_scalar(&cpu->stats, "cpu.cycles", "Simulated cycles", &cpu->clock);
+    stats_add_scalar(&cpu->stats, "cpu.instructions", "Retired instructions",
+                     &cpu->insn_completed);
+    stats_add_formula(&cpu->stats, "cpu.ipc", "instructions / cycles", stat_ipc, cpu);
+    stats_add_formula(&cpu->stats, "cpu.cpi", "cycles / instructions", stat_cpi, cpu);
+    stats_add_scalar(&cpu->stats, "decode.stall_cycles", "Cycles decode stalled on a hazard",
+                     &cpu->decode_stalls);
+    stats_add_scalar(&cpu->stats, "fetch.control_redirects", "Taken branches and jumps",
+                     &cpu->control_redirects);
+    stats_add_formula(&cpu->stats, "fetch.redirects_per_insn", "control_redirects / instructions",
+                      stat_redirect_rate, cpu);
+    stats_add_vector(&cpu->stats, "retired", "Retired instructions per opcode",
+                     cpu->opcode_count, NUM_OPCODES, opcode_names);
+}
+
+/* Writes every statistics file given on the command line */
+void
+APEX_dump_stats(const APEX_CPU *cpu)
+{
+    int i;
+
+    for (i = 0; i < cpu->stats_file_count; ++i)
+    {
+        if (stats_dump_file(&cpu->stats, cpu->stats_files[i]) == 0)
+        {
+            printf("APEX_CPU: Statistics written to %s\n", cpu->stats_files[i]);
+        }
+    }
+}
+
 /*
  * This function creates and initializes APEX cpu.
  *
@@ -873,6 +959,7 @@ APEX_cpu_init(const char *filename)
     cpu->data_memory[104] = 42;
 
     cpu->single_step = ENABLE_SINGLE_STEP;
+    APEX_register_stats(cpu);
 
     /* Parse input file and create code memory */
     cpu->code_memory = create_code_memory(filename, &cpu->code_memory_size);
@@ -915,6 +1002,7 @@ void
 APEX_cpu_run(APEX_CPU *cpu)
 {
     char user_prompt_val;
+    int halted;
 
     while (TRUE)
     {
@@ -925,17 +1013,20 @@ APEX_cpu_run(APEX_CPU *cpu)
             printf("--------------------------------------------\n");
         }
 
-        if (APEX_writeback(cpu))
+        TIMED_STAGE(cpu->stage_ns, TIMER_WRITEBACK, halted = APEX_writeback(cpu));
+        if (halted)
         {
             /* Halt in writeback stage */
             printf("APEX_CPU: Simulation Complete, cycles = %d instructions = %d\n", cpu->clock, cpu->insn_completed);
+            print_stage_timers(cpu);
+            APEX_dump_stats(cpu);
             break;
         }
 
-        APEX_memory(cpu);
-        APEX_execute(cpu);
-        APEX_decode(cpu);
-        APEX_fetch(cpu);
+        TIMED_STAGE(cpu->stage_ns, TIMER_MEMORY, APEX_memory(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_EXECUTE, APEX_execute(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_DECODE, APEX_decode(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_FETCH, APEX_fetch(cpu));
 
         print_reg_file(cpu);
 
@@ -956,6 +1047,8 @@ APEX_cpu_run(APEX_CPU *cpu)
 }
 int APEX_cpu_run_single_cycle(APEX_CPU *cpu)
 {
+    int halted;
+
     if (cpu->clock < 1)
     {
         printf("APEX_CPU: Simulation Started\n");
@@ -968,17 +1061,20 @@ int APEX_cpu_run_single_cycle(APEX_CPU *cpu)
         printf("--------------------------------------------\n");
     }
 
-    if (APEX_writeback(cpu))
+    TIMED_STAGE(cpu->stage_ns, TIMER_WRITEBACK, halted = APEX_writeback(cpu));
+    if (halted)
     {
         // HALT instruction encountered
         printf("APEX_CPU: Simulation Complete, cycles = %d instructions = %d\n", cpu->clock, cpu->insn_completed);
+        print_stage_timers(cpu);
+        APEX_dump_stats(cpu);
         return TRUE;
     }
     
-    APEX_memory(cpu);
-    APEX_execute(cpu);
-    APEX_decode(cpu);
-    APEX_fetch(cpu);
+    TIMED_STAGE(cpu->stage_ns, TIMER_MEMORY, APEX_memory(cpu));
+    TIMED_STAGE(cpu->stage_ns, TIMER_EXECUTE, APEX_execute(cpu));
+    TIMED_STAGE(cpu->stage_ns, TIMER_DECODE, APEX_decode(cpu));
+    TIMED_STAGE(cpu->stage_ns, TIMER_FETCH, APEX_fetch(cpu));
 
     if (ENABLE_DEBUG_MESSAGES)
     {
@@ -10,6 +10,10 @@
 #define _APEX_CPU_H_
 
 #include "apex_macros.h"
+#include "stats.h"
+
+#define NUM_OPCODES (OPCODE_NOP + 1)
+#define STATS_MAX_FILES 4
 
 /* Format of an APEX instruction  */
 typedef struct APEX_Instruction
@@ -42,6 +46,17 @@ typedef struct CPU_Stage
 
 
 
+/* Pipeline stages timed by ENABLE_STAGE_TIMERS */
+enum
+{
+    TIMER_FETCH,
+    TIMER_DECODE,
+    TIMER_EXECUTE,
+    TIMER_MEMORY,
+    TIMER_WRITEBACK,
+    STAGE_TIMER_COUNT
+};
+
 /* Model of APEX CPU */
 typedef struct APEX_CPU
 {
@@ -61,6 +76,15 @@ typedef struct APEX_CPU
     int forward_flag[REG_FILE_SIZE];
     int stall;
     int scoreboard[REG_FILE_SIZE];  // Scoreboard to track register availability
+    unsigned long long stage_ns[STAGE_TIMER_COUNT]; /* Host time per stage */
+
+    /* Statistics */
+    int opcode_count[NUM_OPCODES]; /* Retired instructions per opcode */
+    int decode_stalls;             /* Cycles decode held an instruction back */
+    int control_redirects;         /* Fetch bubbles after a taken branch/jump */
+    StatsRegistry stats;
+    const char *stats_files[STATS_MAX_FILES]; /* Dumped at HALT and by Display */
+    int stats_file_count;
     
 
     /* Pipeline stages */
@@ -79,5 +103,7 @@ void print_reg_file(const APEX_CPU *cpu);
 void print_pipeline_state(const APEX_CPU *cpu);
 void print_memory(const APEX_CPU *cpu, int start_address, int num_locations);
 int APEX_cpu_run_single_cycle(APEX_CPU *cpu);
+void print_stage_timers(const APEX_CPU *cpu);
+void APEX_dump_stats(const APEX_CPU *cpu);
 
 #endif
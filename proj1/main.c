@@ -20,7 +20,7 @@ void display_menu() {
     printf("  Initialize - Initialize simulator state\n");
     printf("  Simulate <n> - Simulate n cycles\n");
     printf("  Single_step - Advance simulation by one cycle\n");
-    printf("  Display - Show pipeline, registers, and memory state\n");
+    printf("  Display - Show pipeline, registers, memory state and statistics\n");
     printf("  ShowMem <address> - Display content of specific memory location\n");
     printf("  Exit - Quit the simulator\n");
 }
@@ -48,6 +48,10 @@ void initialize(APEX_CPU *cpu) {
     memset(cpu->regs, 0, sizeof(int) * REG_FILE_SIZE);
     cpu->clock = 0;
     cpu->insn_completed = 0;
+    memset(cpu->stage_ns, 0, sizeof(cpu->stage_ns));
+    memset(cpu->opcode_count, 0, sizeof(cpu->opcode_count));
+    cpu->decode_stalls = 0;
+    cpu->control_redirects = 0;
     cpu->fetch.has_insn = TRUE;
     printf("Simulator state initialized\n");
 }
@@ -75,6 +79,9 @@ void display(APEX_CPU *cpu) {
     print_reg_file(cpu);
     print_pipeline_state(cpu);
     print_memory(cpu, 0, 10);
+    print_stage_timers(cpu);
+    stats_print(&cpu->stats, stdout);
+    APEX_dump_stats(cpu);
 }
 
 void show_mem(APEX_CPU *cpu, int address) {
@@ -93,8 +100,9 @@ int main(int argc, char const *argv[]) {
 
     fprintf(stderr, "APEX CPU Pipeline Simulator v%0.1lf\n", VERSION);
 
-    if (argc != 2) {
-        fprintf(stderr, "APEX_Help: Usage %s <input_file>\n", argv[0]);
+    if (argc < 2) {
+        fprintf(stderr, "APEX_Help: Usage %s <input_file> [--stats=FILE ...]\n", argv[0]);
+        fprintf(stderr, "  --stats=FILE  Dump statistics at HALT and on Display (.csv or JSON)\n");
         exit(1);
     }
 
@@ -104,6 +112,15 @@ int main(int argc, char const *argv[]) {
         exit(1);
     }
 
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--stats=", 8) == 0 && cpu->stats_file_count < STATS_MAX_FILES) {
+            cpu->stats_files[cpu->stats_file_count++] = argv[i] + 8;
+        } else {
+            fprintf(stderr, "APEX_Error: Unknown option %s\n", argv[i]);
+            exit(1);
+        }
+    }
+
     while (1) {
         display_menu();
         printf("Enter command: ");
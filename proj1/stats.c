@@ -0,0 +1,233 @@
+/*
+ * stats.c
+ * Named statistics registry, see stats.h
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "stats.h"
+
+void
+stats_init(StatsRegistry *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+static StatEntry *
+stats_add(StatsRegistry *stats, const char *name, const char *desc, StatKind kind)
+{
+    StatEntry *entry;
+
+    if (stats->count >= STATS_MAX_ENTRIES)
+    {
+        fprintf(stderr, "APEX_Error: Too many statistics, %s not registered\n", name);
+        return NULL;
+    }
+
+    entry = &stats->entries[stats->count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->name = name;
+    entry->desc = desc;
+    entry->kind = kind;
+    return entry;
+}
+
+int
+stats_add_scalar(StatsRegistry *stats, const char *name, const char *desc, const int *value)
+{
+    StatEntry *entry = stats_add(stats, name, desc, STAT_SCALAR);
+
+    if (!entry)
+    {
+        return -1;
+    }
+    entry->values = value;
+    entry->length = 1;
+    return 0;
+}
+
+int
+stats_add_vector(StatsRegistry *stats, const char *name, const char *desc,
+                 const int *values, int length, const char *const *labels)
+{
+    StatEntry *entry = stats_add(stats, name, desc, STAT_VECTOR);
+
+    if (!entry)
+    {
+        return -1;
+    }
+    entry->values = values;
+    entry->length = length;
+    entry->labels = labels;
+    return 0;
+}
+
+int
+stats_add_formula(StatsRegistry *stats, const char *name, const char *desc,
+                  StatFormula formula, const void *ctx)
+{
+    StatEntry *entry = stats_add(stats, name, desc, STAT_FORMULA);
+
+    if (!entry)
+    {
+        return -1;
+    }
+    entry->formula = formula;
+    entry->ctx = ctx;
+    return 0;
+}
+
+/*
+ * Every dump walks the entries the same way: one line per scalar, per
+ * formula and per vector element (named name.label)
+ */
+typedef void (*StatVisitor)(FILE *out, const char *name, const char *label,
+                            const char *desc, int is_formula, double value, int first);
+
+static void
+stats_visit(const StatsRegistry *stats, FILE *out, StatVisitor visit)
+{
+    int i, j, first = 1;
+
+    for (i = 0; i < stats->count; ++i)
+    {
+        const StatEntry *entry = &stats->entries[i];
+
+        switch (entry->kind)
+        {
+            case STAT_SCALAR:
+                visit(out, entry->name, NULL, entry->desc, 0, *entry->values, first);
+                first = 0;
+                break;
+
+            case STAT_VECTOR:
+                for (j = 0; j < entry->length; ++j)
+                {
+                    visit(out, entry->name, entry->labels[j], entry->desc, 0,
+                          entry->values[j], first);
+                    first = 0;
+                }
+                break;
+
+            case STAT_FORMULA:
+                visit(out, entry->name, NULL, entry->desc, 1, entry->formula(entry->ctx), first);
+                first = 0;
+                break;
+        }
+    }
+}
+
+static void
+print_name(FILE *out, const char *name, const char *label)
+{
+    if (label)
+    {
+        fprintf(out, "%s.%s", name, label);
+    }
+    else
+    {
+        fprintf(out, "%s", name);
+    }
+}
+
+static void
+print_value(FILE *out, int is_formula, double value)
+{
+    if (is_formula)
+    {
+        fprintf(out, "%.6g", value);
+    }
+    else
+    {
+        fprintf(out, "%.0f", value);
+    }
+}
+
+static void
+visit_text(FILE *out, const char *name, const char *label, const char *desc,
+           int is_formula, double value, int first)
+{
+    char full_name[64];
+
+    (void)first;
+    if (label)
+    {
+        snprintf(full_name, sizeof(full_name), "%s.%s", name, label);
+    }
+    else
+    {
+        snprintf(full_name, sizeof(full_name), "%s", name);
+    }
+    fprintf(out, "  %-28s ", full_name);
+    print_value(out, is_formula, value);
+    fprintf(out, "  # %s\n", desc);
+}
+
+static void
+visit_json(FILE *out, const char *name, const char *label, const char *desc,
+           int is_formula, double value, int first)
+{
+    (void)desc;
+    fprintf(out, "%s  \"", first ? "" : ",\n");
+    print_name(out, name, label);
+    fprintf(out, "\": ");
+    print_value(out, is_formula, value);
+}
+
+static void
+visit_csv(FILE *out, const char *name, const char *label, const char *desc,
+          int is_formula, double value, int first)
+{
+    (void)first;
+    print_name(out, name, label);
+    fprintf(out, ",");
+    print_value(out, is_formula, value);
+    fprintf(out, ",\"%s\"\n", desc);
+}
+
+void
+stats_print(const StatsRegistry *stats, FILE *out)
+{
+    fprintf(out, "Statistics:\n");
+    stats_visit(stats, out, visit_text);
+}
+
+void
+stats_dump_json(const StatsRegistry *stats, FILE *out)
+{
+    fprintf(out, "{\n");
+    stats_visit(stats, out, visit_json);
+    fprintf(out, "\n}\n");
+}
+
+void
+stats_dump_csv(const StatsRegistry *stats, FILE *out)
+{
+    fprintf(out, "name,value,description\n");
+    stats_visit(stats, out, visit_csv);
+}
+
+/* CSV for a .csv file name, JSON otherwise */
+int
+stats_dump_file(const StatsRegistry *stats, const char *filename)
+{
+    size_t len = strlen(filename);
+    FILE *fp = fopen(filename, "w");
+
+    if (!fp)
+    {
+        printf("Error: Unable to open stats file %s\n", filename);
+        return -1;
+    }
+
+    if (len >= 4 && strcmp(filename + len - 4, ".csv") == 0)
+    {
+        stats_dump_csv(stats, fp);
+    }
+    else
+    {
+        stats_dump_json(stats, fp);
+    }
+    fclose(fp);
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * stats.h
+ * Named statistics registry: counters, vectors and derived formulas that
+ * can be printed or dumped to JSON/CSV at any point of the simulation
+ */
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <stdio.h>
+
+#define STATS_MAX_ENTRIES 32
+
+typedef enum
+{
+    STAT_SCALAR,   /* int counter owned by the CPU */
+    STAT_VECTOR,   /* int array with one label per element */
+    STAT_FORMULA   /* Derived value, e.g. IPC */
+} StatKind;
+
+typedef double (*StatFormula)(const void *ctx);
+
+typedef struct StatEntry
+{
+    const char *name;
+    const char *desc;
+    StatKind kind;
+    const int *values;
+    int length;
+    const char *const *labels;
+    StatFormula formula;
+    const void *ctx;
+} StatEntry;
+
+typedef struct StatsRegistry
+{
+    StatEntry entries[STATS_MAX_ENTRIES];
+    int count;
+} StatsRegistry;
+
+void stats_init(StatsRegistry *stats);
+int stats_add_scalar(StatsRegistry *stats, const char *name, const char *desc,
+                     const int *value);
+int stats_add_vector(StatsRegistry *stats, const char *name, const char *desc,
+                     const int *values, int length, const char *const *labels);
+int stats_add_formula(StatsRegistry *stats, const char *name, const char *desc,
+                      StatFormula formula, const void *ctx);
+void stats_print(const StatsRegistry *stats, FILE *out);
+void stats_dump_json(const StatsRegistry *stats, FILE *out);
+void stats_dump_csv(const StatsRegistry *stats, FILE *out);
+int stats_dump_file(const StatsRegistry *stats, const char *filename);
+
+#endif
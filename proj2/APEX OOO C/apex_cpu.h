@@ -41,6 +41,16 @@ typedef struct BranchPredictor {
     int head;       // Circular head pointer
 } BranchPredictor;
 
+/* Out-of-order stages timed by ENABLE_STAGE_TIMERS */
+enum {
+    TIMER_FETCH,
+    TIMER_DECODE,
+    TIMER_DISPATCH,
+    TIMER_EXECUTE,
+    TIMER_COMMIT,
+    STAGE_TIMER_COUNT
+};
+
 /* Format of an APEX instruction */
 typedef struct APEX_Instruction {
     char opcode_str[128];
@@ -92,6 +102,7 @@ typedef struct APEX_CPU {
     RenameTable rename_table;       /* Rename Table */
     BranchPredictor branch_predictor; /* Branch Predictor */
     int is_halted; /* Flag to stop simulation on HALT */
+    unsigned long long stage_ns[STAGE_TIMER_COUNT]; /* Host time per stage */
 
 } APEX_CPU;
 
@@ -120,6 +131,7 @@ void Dispatch(APEX_CPU *cpu);
 void Execute(APEX_CPU *cpu);
 void Commit(APEX_CPU *cpu);
 void SetMem(int *memory, int size);
+void PrintStageTimers(const APEX_CPU *cpu, int cycles, int committed);
 
 
 
@@ -50,4 +50,10 @@
 /* Set this flag to 1 to enable cycle single-step mode */
 #define ENABLE_SINGLE_STEP 1
 
+/* Set this flag to 1 to measure host time spent in each pipeline stage
+ * (can also be set with make EXTRA_CFLAGS=-DENABLE_STAGE_TIMERS=1) */
+#ifndef ENABLE_STAGE_TIMERS
+#define ENABLE_STAGE_TIMERS 0
+#endif
+
 #endif
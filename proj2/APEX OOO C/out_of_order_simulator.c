@@ -3,6 +3,7 @@
 #include <string.h>
 #include "apex_macros.h"
 #include "apex_cpu.h"
+#include "stage_timer.h"
 
 // Pipeline Stages
 void Fetch(APEX_CPU *cpu);
@@ -56,6 +57,16 @@ void SetMem(int *memory, int size) {
     DisplayMem(memory, size);
 }
 
+// Host nanoseconds per simulated cycle and per committed instruction
+void PrintStageTimers(const APEX_CPU *cpu, int cycles, int committed) {
+    static const char *const names[STAGE_TIMER_COUNT] = {"Fetch", "Decode", "Dispatch", "Execute", "Commit"};
+
+    if (!ENABLE_STAGE_TIMERS) {
+        return;
+    }
+    stage_timer_print(names, cpu->stage_ns, STAGE_TIMER_COUNT, cycles, committed);
+}
+
 void Fetch(APEX_CPU *cpu) {
     // Fetch logic: Fetch instructions using Predictor
 }
@@ -87,18 +98,23 @@ void run_simulator(APEX_CPU *cpu, int *memory) {
     SetMem(memory, memory_size);
 
     // Simulation Loop
-    for (int cycle = 0; cycle < 100; cycle++) {
+    int cycle;
+    int committed = 0;
+    for (cycle = 0; cycle < 100; cycle++) {
         if (cpu->is_halted) { // Stop simulation if HALT is encountered
             printf("Simulation halted at cycle %d.\n", cycle);
             break;
         }
 
-        Commit(cpu);
-        Execute(cpu);
-        Dispatch(cpu);
-        Decode(cpu);
-        Fetch(cpu);
+        int rob_count = cpu->rob.count;
+        TIMED_STAGE(cpu->stage_ns, TIMER_COMMIT, Commit(cpu));
+        committed += rob_count - cpu->rob.count;
+        TIMED_STAGE(cpu->stage_ns, TIMER_EXECUTE, Execute(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_DISPATCH, Dispatch(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_DECODE, Decode(cpu));
+        TIMED_STAGE(cpu->stage_ns, TIMER_FETCH, Fetch(cpu));
     }
+    PrintStageTimers(cpu, cycle, committed);
 
     // Display non-zero memory contents at the end of the simulation
     printf("\nFinal Non-zero Memory State:\n");
@@ -2,32 +2,155 @@
 #define _APEX_CPU_H_
 
 #include <stdint.h>
+#include <deque>
+#include <vector>
 #include "rob.h"
 #include "register_manager.h"
 #include "control_predictor.h"
 #include "lsq.h"
 #include "memory_fu.h" 
 #include "int_fu.h"
+#include "mul_fu.h"
+#include "issue_queue.h"
+#include "physical_register_file.h"
+#include "result_bus.h"
+#include "sim_config.h"
+#include "cpi_stack.h"
+#include "occupancy_histogram.h"
+#include "pipe_trace.h"
+#include "stage_timer.h"
+#include "stats_registry.h"
+#include "interval_stats.h"
+#include "critical_path.h"
+#include "memory_profile.h"
+#include "functional_core.h"
+#include "file_parser.h"
+
+// Instruction travelling through Fetch -> Decode 1 -> Decode 2
+struct FrontendSlot {
+    uint32_t pc;
+    APEX_Instruction insn;
+    uint32_t predicted_npc;   // Next PC chosen by fetch
+    bool predictor_hit;       // Control instruction found in the predictor
+    uint64_t fetch_cycle;
+    uint64_t decode_cycle;
+};
 
 class APEX_CPU {
 private:
-    int cycle;
+    SimConfig config;
+    uint64_t cycle;
+    uint64_t insn_committed;
+    uint64_t next_seq;
+    uint64_t branch_mispredicts;
     bool halt;
+    uint32_t pc;              // Fetch PC
+    bool fetch_stopped;       // HALT fetched on the current path
+    std::vector<APEX_Instruction> code_memory;
+
     ROB rob;
     RegisterManager reg_mgr;
     ControlPredictor predictor;
     LSQ lsq;
     MemoryFU mem_fu;
-    IntegerFU int_fu;
-    
+    std::vector<IntegerFU> int_fus;
+    MultiplyFU mul_fu;
+    IssueQueue iq;
+
+    // Physical register values and the forwarding network
+    PhysicalRegisterFile uprf;
+    PhysicalRegisterFile ucrf;
+    ResultBus result_bus;
+
+    // Pipeline latches
+    std::deque<FrontendSlot> fetch_latch;    // Fetch -> Decode 1
+    std::deque<FrontendSlot> decode_latch;   // Decode 1 -> Decode 2/Dispatch
+
+    // Stall attribution for the CPI stack
+    CpiStack cpi_stack;
+    int committed_this_cycle;
+    StallCause head_stall;      // ROB head state seen by commit
+    StallCause dispatch_stall;  // Structure that blocked dispatch this cycle
+    bool mispredict_recovery;   // Refilling after a mispredict
+
+    // Occupancy sampled at the end of every cycle
+    OccupancyHistogram rob_occupancy;
+    OccupancyHistogram lsq_occupancy;
+    OccupancyHistogram iq_occupancy;
+    OccupancyHistogram uprf_occupancy;        // Renamed registers not on the free list
+    OccupancyHistogram ucrf_occupancy;
+    OccupancyHistogram checkpoint_occupancy;
+    MemoryProfile mem_profile;                // Load latency phases and MLP
+
+    // Per-instruction stage timing for pipeline viewers
+    PipeTrace pipe_trace;
+    int branch_report_size;   // Worst static branches listed in the stats
+
+    // Dependence graph of committed instructions, off unless enabled
+    CriticalPath critical_path;
+
+    // Host time spent simulating each stage
+    StageTimers stage_timers;
+
+    // Every statistic above by name, for JSON/CSV dumps
+    StatsRegistry stats;
+    IntervalStats interval_stats;   // Counter deltas every N cycles or instructions
+
+    // Pipeline stages, called in reverse order every cycle
+    void commit();
+    void writeback();
+    void execute();
+    void issue();
+    void dispatch();
+    void decode();
+    void fetch();
+
+    // Helpers
+    bool is_live(uint32_t rob_idx, uint64_t seq);
+    void add_writeback(uint32_t rob_idx, uint32_t value, bool cc_modified,
+                       uint8_t cc_flags, bool mispredicted);
+    bool resolve_control(uint32_t rob_idx, const IntFUResult& result);
+    void squash_after(uint32_t rob_idx);
+    void squash_frontend();
+    void read_source(uint32_t tag, uint32_t& value, bool& ready);
+    void read_cc_source(uint32_t tag, uint32_t& value, bool& ready);
+    StallCause classify_head();
+    StallCause classify_stall();
+    void sample_occupancy();
+    void register_stats();
+
 public:
-    APEX_CPU();
+    APEX_CPU(const SimConfig& sim_config = SimConfig());
     ~APEX_CPU();
     
-    void initialize();
-    void run_cpu();
+    bool initialize(const char* filename, const char* data_filename);
+    // Starts from an architectural checkpoint instead of the reset state
+    void load_checkpoint(const std::vector<APEX_Instruction>& program,
+                         const ArchCheckpoint& checkpoint);
+    // Predictor and D-cache contents trained by functional warming
+    void load_warm_state(const ControlPredictor& trained, const DataCache& cache);
+    void attach_memory(MemoryPort* port) { mem_fu.attach_port(port); }  // Shared memory
+    // Switches to a config that differs only in what can change mid-run
+    // (pipeline widths, D-cache miss penalty); false if any size differs
+    bool reconfigure(const SimConfig& next);
+    bool enable_trace(const char* text_path, const char* binary_path,
+                      uint64_t from_cycle, uint64_t to_cycle);
+    void set_branch_report_size(int top_n) { branch_report_size = top_n; }
+    void set_stage_timers(bool enabled) { stage_timers.set_enabled(enabled); }
+    void enable_critical_path(int window) { critical_path.enable(window); }
+    bool dump_stats(const char* filename) const { return stats.dump_file(filename); }
+    bool enable_interval_stats(const char* path, uint64_t period, bool by_insns) {
+        return interval_stats.open(path, &stats, period, by_insns);
+    }
+    void run_cpu(uint64_t max_cycles);
+    void run_until(uint64_t committed);  // Or HALT, without the end-of-run report
     void single_step();
     void show_state();
+    void print_stats();
+    bool is_halted() const { return halt; }
+    uint64_t get_cycles() const { return cycle; }
+    uint64_t get_committed() const { return insn_committed; }
+    const StatsRegistry& get_stats() const { return stats; }
 };
 
-#endif
\ No newline at end of file
+#endif
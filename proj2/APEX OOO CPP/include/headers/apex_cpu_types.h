@@ -16,7 +16,23 @@ enum InstructionType {
     RET,
     CMP,
     CML,
-    ADD
+    ADD,
+
+    // Remaining APEX operations executed by the pipeline
+    INT_AND,
+    INT_OR,
+    INT_XOR,
+    INT_LTR,
+    MOVC,
+    BZ,
+    BNZ,
+    BP,
+    BNP,
+    BN,
+    JUMP,
+    JALR,
+    NOP,
+    HALT
 };
 
 // Predictor Types
@@ -26,4 +42,42 @@ enum PredictorType {
     PRED_RET
 };
 
-#endif
\ No newline at end of file
+// Condition code flag bits (as produced by IntegerFU)
+#define CC_ZERO     0x4
+#define CC_NEGATIVE 0x2
+#define CC_POSITIVE 0x1
+
+// APEX code memory starts at this address, one 4-byte instruction per slot
+#define CODE_BASE_ADDRESS 4000
+
+// Marks an unused register operand
+#define REG_NONE ((uint32_t)-1)
+
+// Instruction classification used by the pipeline stages
+inline bool is_memory_op(InstructionType type) {
+    return type == LOAD || type == STORE;
+}
+
+inline bool is_conditional_branch(InstructionType type) {
+    return type == BRANCH || type == BZ || type == BNZ ||
+           type == BP || type == BNP || type == BN;
+}
+
+inline bool is_control_op(InstructionType type) {
+    return is_conditional_branch(type) || type == JUMP || type == JALR ||
+           type == JALP || type == RET;
+}
+
+// Arithmetic operations update the condition code register
+inline bool writes_cc(InstructionType type) {
+    return type == INT_ADD || type == INT_SUB || type == MUL ||
+           type == CMP || type == CML;
+}
+
+inline PredictorType get_predictor_type(InstructionType type) {
+    if (type == RET) return PRED_RET;
+    if (type == JUMP || type == JALR || type == JALP) return PRED_JALP;
+    return PRED_BRANCH;
+}
+
+#endif
@@ -0,0 +1,118 @@
+// include/headers/apex_log.h
+#ifndef _APEX_LOG_H_
+#define _APEX_LOG_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Log levels, lower is more important
+enum LogLevel {
+    LOG_OFF = -1,
+    LOG_ERROR = 0,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG,
+    LOG_TRACE
+};
+
+// Components that can be enabled independently
+enum LogComponent {
+    LOG_CPU,
+    LOG_ROB,
+    LOG_RENAME,
+    LOG_IQ,
+    LOG_LSQ,
+    LOG_INTFU,
+    LOG_MULFU,
+    LOG_MEMFU,
+    LOG_PREDICTOR,
+    LOG_BUS,
+    LOG_COMPONENT_COUNT
+};
+
+// Messages above this level are compiled out (e.g. -DAPEX_LOG_COMPILE_LEVEL=1)
+#ifndef APEX_LOG_COMPILE_LEVEL
+#define APEX_LOG_COMPILE_LEVEL 4
+#endif
+
+#define LOG_MAX_ARGS 6
+
+// Binary log record: the format string is not copied, so it must be a
+// literal; %s arguments must point at static strings as well
+struct LogRecord {
+    const char* fmt;
+    uint8_t component;
+    uint8_t level;
+    uint8_t num_args;
+    uint8_t arg_sizes[LOG_MAX_ARGS];   // sizeof() of each argument
+    uint64_t args[LOG_MAX_ARGS];
+};
+
+class Logger {
+private:
+    static std::atomic<int> component_levels[LOG_COMPONENT_COUNT];
+
+public:
+    // Runtime filter, checked before anything is recorded
+    static bool enabled(LogComponent component, LogLevel level) {
+        return (int)level <= component_levels[component].load(std::memory_order_relaxed);
+    }
+
+    static void set_level(LogLevel level);                        // Every component
+    static void set_component_level(LogComponent component, LogLevel level);
+    static bool configure(const char* spec);  // "debug" or "lsq=trace,rob=off,all=info"
+
+    // Records are formatted inline until start() launches the drain thread,
+    // which it does only when some component logs above warn
+    static void start();
+    static void stop();     // Drains the ring and joins the thread
+    static void flush();    // Waits until every record so far has been written
+    static bool is_async();
+
+    static void write(LogComponent component, LogLevel level, const char* fmt,
+                      int num_args, const uint64_t* args, const uint8_t* sizes);
+};
+
+// Arguments travel as raw 64-bit words
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint64_t>::type
+log_arg(T value) {
+    return (uint64_t)value;
+}
+
+template <typename T>
+inline uint64_t log_arg(T* value) {
+    return (uint64_t)(uintptr_t)value;
+}
+
+inline uint64_t log_arg(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <typename... Args>
+inline void log_write(LogComponent component, LogLevel level, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    const uint64_t packed[sizeof...(Args) + 1] = {log_arg(args)..., 0};
+    const uint8_t sizes[sizeof...(Args) + 1] = {(uint8_t)sizeof(args)..., 0};
+    Logger::write(component, level, fmt, (int)sizeof...(Args), packed, sizes);
+}
+
+#define APEX_LOG(component, level, ...)                                          \
+    do {                                                                         \
+        if ((int)(level) <= APEX_LOG_COMPILE_LEVEL &&                            \
+            Logger::enabled(component, level)) {                                 \
+            log_write(component, level, __VA_ARGS__);                            \
+        }                                                                        \
+    } while (0)
+
+#define APEX_ERROR(component, ...) APEX_LOG(component, LOG_ERROR, __VA_ARGS__)
+#define APEX_WARN(component, ...)  APEX_LOG(component, LOG_WARN, __VA_ARGS__)
+#define APEX_INFO(component, ...)  APEX_LOG(component, LOG_INFO, __VA_ARGS__)
+#define APEX_DEBUG(component, ...) APEX_LOG(component, LOG_DEBUG, __VA_ARGS__)
+#define APEX_TRACE(component, ...) APEX_LOG(component, LOG_TRACE, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,42 @@
+// include/headers/bbv.h
+#ifndef _BBV_H_
+#define _BBV_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
+
+// Basic-block vectors in the SimPoint .bb format: one line per interval of
+// N instructions, "T:id:count :id:count ..." where count is the number of
+// instructions executed in block id (1-based, numbered in order of first
+// execution). Blocks end at control instructions and HALT.
+class BbvCollector {
+private:
+    FILE* out;
+    uint64_t interval;
+    uint64_t in_interval;     // Instructions in the current interval
+    uint64_t intervals;
+    std::unordered_map<uint32_t, int> block_ids;  // Start PC -> id
+    std::vector<uint64_t> counts;                 // By id, current interval
+    std::vector<int> touched;                     // Ids with a count this interval
+    uint32_t block_start;
+    uint64_t block_length;    // Instructions not yet counted
+    bool in_block;            // Between the block's first instruction and its end
+
+    void count_block();
+    void write_interval();
+
+public:
+    BbvCollector();
+    ~BbvCollector();
+
+    bool open(const char* path, uint64_t interval_insns);
+    void on_instruction(uint32_t pc, bool ends_block);
+    void close();             // Writes the partial last interval
+
+    uint64_t get_intervals() const { return intervals; }
+    int get_blocks() const { return (int)block_ids.size(); }
+};
+
+#endif
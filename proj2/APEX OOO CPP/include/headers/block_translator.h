@@ -0,0 +1,64 @@
+// include/headers/block_translator.h
+#ifndef _BLOCK_TRANSLATOR_H_
+#define _BLOCK_TRANSLATOR_H_
+
+#include "file_parser.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Guest state seen by translated code, which keeps its base in RDI
+struct TranslatedContext {
+    uint32_t regs[32];
+    uint32_t pc;              // Next guest PC when a block returns
+    uint32_t memory_words;
+    uint32_t* memory;
+    int64_t budget;           // Instructions left; a block needing more returns
+    uint8_t cc;
+};
+
+typedef void (*TranslatedBlock)(TranslatedContext* context);
+
+/*
+ * Translates hot APEX basic blocks to x86-64 in an executable buffer for
+ * the functional mode. A block runs from its entry PC to the first control
+ * instruction, and its direct exits are patched to jump straight into the
+ * successor's translation once that exists, so loops run without returning
+ * to the caller. Indirect jumps and anything not translated (HALT, unknown
+ * opcodes) return to the interpreter. Results match FunctionalCore::step.
+ * The buffer is never writable and executable at once: it is read-execute
+ * while blocks run and turns read-write only while a block is emitted and
+ * linked. Without an x86-64 host or executable memory nothing is translated.
+ */
+class BlockTranslator {
+private:
+    const std::vector<APEX_Instruction>& code;
+    uint32_t hot_threshold;
+    std::vector<TranslatedBlock> entries;  // Per instruction index, NULL if none
+    std::vector<uint32_t> counts;          // Entries seen by the interpreter
+    std::vector<std::vector<size_t> > waiting;  // Exit jumps to link per target
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used;
+    uint64_t blocks;
+    uint64_t linked;
+
+    bool translatable(const APEX_Instruction& insn) const;
+    TranslatedBlock translate(int index);
+    void link(size_t site, size_t target);
+    bool set_writable(bool writable);  // Drops the buffer if mprotect fails
+
+public:
+    BlockTranslator(const std::vector<APEX_Instruction>& program, uint32_t threshold);
+    ~BlockTranslator();
+
+    // Translation of the block at pc, made once the entry turns hot
+    TranslatedBlock lookup(uint32_t pc);
+
+    bool is_available() const { return buffer != NULL; }
+    uint64_t get_blocks() const { return blocks; }
+    uint64_t get_linked() const { return linked; }
+    size_t get_code_bytes() const;  // Emitted blocks only, not the shared ret stub
+};
+
+#endif
@@ -0,0 +1,43 @@
+// include/headers/capacity.h
+#ifndef _CAPACITY_H_
+#define _CAPACITY_H_
+
+#include <array>
+#include <vector>
+
+// Capacity policies for the circular structures (ROB, LSQ, predictor
+// table, free lists). RuntimeCapacity is sized by SimConfig; FixedCapacity
+// is a compile-time constant so indexing folds into constants and
+// power-of-two sizes wrap with a mask instead of a division.
+
+struct RuntimeCapacity {
+    template <class T> struct Storage { typedef std::vector<T> type; };
+
+    int n;
+
+    explicit RuntimeCapacity(int size) : n(size) {}
+    int size() const { return n; }
+    int wrap(int i) const { return i % n; }
+    int next(int i) const { return i + 1 == n ? 0 : i + 1; }
+    int prev(int i) const { return i == 0 ? n - 1 : i - 1; }
+
+    template <class T> void allocate(std::vector<T>& storage) const { storage.assign(n, T()); }
+};
+
+template <int N>
+struct FixedCapacity {
+    static_assert(N > 0, "capacity must be positive");
+    template <class T> struct Storage { typedef std::array<T, N> type; };
+
+    static constexpr bool is_power_of_two = (N & (N - 1)) == 0;
+
+    explicit FixedCapacity(int = N) {}  // Runtime size is ignored
+    static constexpr int size() { return N; }
+    static constexpr int wrap(int i) { return is_power_of_two ? (i & (N - 1)) : (i % N); }
+    static constexpr int next(int i) { return wrap(i + 1); }
+    static constexpr int prev(int i) { return wrap(i + N - 1); }
+
+    template <class T> void allocate(std::array<T, N>& storage) const { storage.fill(T()); }
+};
+
+#endif
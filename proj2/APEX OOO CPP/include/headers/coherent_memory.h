@@ -0,0 +1,128 @@
+// include/headers/coherent_memory.h
+#ifndef _COHERENT_MEMORY_H_
+#define _COHERENT_MEMORY_H_
+
+#include "memory_port.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#define MAX_COHERENT_CORES 64
+
+enum MesiState { MESI_I, MESI_S, MESI_E, MESI_M };
+
+enum BusOp {
+    BUS_RD,                   // Read miss, others drop to S
+    BUS_RDX,                  // Write miss, others invalidate
+    BUS_UPGR,                 // Write hit on S, others invalidate
+    BUS_WB,                   // Dirty eviction
+    BUS_OP_COUNT
+};
+
+struct BusTransaction {
+    uint64_t cycle;
+    int core;
+    BusOp op;
+    uint32_t line;
+};
+
+struct BufferedStore {
+    uint64_t cycle;
+    int core;
+    uint32_t address;
+    uint32_t data;
+};
+
+class CoherentMemory;
+
+// Private MESI L1 of one core (tags and states only, data lives in the
+// shared memory). During a quantum it touches nothing but its own state
+// and the read-only quantum-start view of the other caches, so cores can
+// run on separate host threads. Bus transactions and stores are queued
+// and applied by CoherentMemory::synchronize.
+class CoherentL1 : public MemoryPort {
+private:
+    CoherentMemory& shared;
+    int core;
+    int sets;
+    int ways;
+    int line_words;
+    std::vector<uint32_t> tags;
+    std::vector<uint8_t> states;       // MesiState
+    std::vector<uint64_t> last_use;
+    uint64_t use_clock;
+    uint64_t now;
+
+    std::vector<BusTransaction> transactions;
+    std::vector<BufferedStore> stores;
+    std::unordered_map<uint32_t, uint32_t> own_stores;  // Not yet visible to others
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t upgrades;
+    uint64_t transfers;       // Misses served by another cache
+    uint64_t invalidations;   // Lines taken away by other cores' writes
+    uint64_t writebacks;
+
+    int find(uint32_t line) const;
+    void request(BusOp op, uint32_t line);
+
+    friend class CoherentMemory;
+
+public:
+    CoherentL1(CoherentMemory& memory, int core_id, int num_sets, int num_ways,
+               int words_per_line);
+
+    void set_cycle(uint64_t cycle) { now = cycle; }
+
+    int access(uint32_t address, bool is_store);
+    uint32_t read(uint32_t address);
+    void write(uint32_t address, uint32_t data);
+
+    MesiState get_state(uint32_t address) const;
+    void print(FILE* out) const;
+};
+
+// Data memory shared by N cores through private L1s kept coherent with
+// MESI on a snooping bus. Time advances in quanta: inside one each core
+// sees memory and the other caches as they were at its start plus its own
+// stores. At the barrier the bus transactions of all cores are applied in
+// (cycle, core) order, then the buffered stores in the same order, so the
+// outcome and the store visibility order do not depend on host thread
+// scheduling.
+class CoherentMemory {
+private:
+    std::vector<uint32_t> memory;
+    std::vector<std::unique_ptr<CoherentL1> > caches;
+    std::unordered_map<uint32_t, uint64_t> sharers;  // Quantum-start copies, core mask by line
+    int memory_latency;
+    int transfer_latency;
+    int upgrade_latency;
+    uint64_t bus_ops[BUS_OP_COUNT];
+    uint64_t flushes;         // Dirty lines supplied to another cache
+    uint64_t stores_applied;
+    uint64_t quanta;
+
+    void rebuild_sharers();
+
+    friend class CoherentL1;
+
+public:
+    CoherentMemory(int cores, int memory_words, int sets, int ways, int line_words,
+                   int miss_cycles, int transfer_cycles, int upgrade_cycles);
+
+    int load_data(const char* filename);
+    int get_cores() const { return (int)caches.size(); }
+    CoherentL1& get_port(int core) { return *caches[core]; }
+    uint32_t read(uint32_t address) const {
+        return address < memory.size() ? memory[address] : 0;
+    }
+
+    // Quantum barrier, single threaded
+    void synchronize();
+    void print(FILE* out) const;
+};
+
+#endif
@@ -3,7 +3,11 @@
 #define _CONTROL_PREDICTOR_H_
 
 #include "apex_cpu_types.h"
+#include "core_variants.h"
 #include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 struct PredictorEntry {
     bool established;         // Entry validity
@@ -15,19 +19,43 @@ struct PredictorEntry {
 };
 
 struct ReturnStack {
-    uint32_t addresses[4];   // 4-entry RAS
+    std::vector<uint32_t> addresses;
     int top;                // Stack pointer
 };
 
-class ControlPredictor {
+// Profile of one static control instruction
+struct BranchProfile {
+    PredictorType type;
+    uint64_t lookups;         // Fetches, including the wrong path
+    uint64_t btb_hits;
+    uint64_t btb_misses;
+    uint64_t resolved;        // Executions that reached the Integer FU
+    uint64_t direction_mispredicts;
+    uint64_t target_mispredicts;
+    uint64_t ras_mispredicts;
+
+    uint64_t mispredicts() const {
+        return direction_mispredicts + target_mispredicts + ras_mispredicts;
+    }
+};
+
+class StatsRegistry;
+
+// Predictor table capacity policy from capacity.h, the RAS is runtime sized
+template <class Capacity>
+class ControlPredictor_T {
 private:
-    PredictorEntry table[8];
+    Capacity capacity;
+    typename Capacity::template Storage<PredictorEntry>::type table;
     ReturnStack ras;
     int head;
     int count;
+    std::unordered_map<uint32_t, BranchProfile> profile;  // Keyed by PC
+
+    BranchProfile& get_profile(uint32_t pc, PredictorType type);
 
     int find_entry(uint32_t pc) const {
-        for (int i = 0; i < 8; i++) {
+        for (int i = 0; i < capacity.size(); i++) {
             if (table[i].established && table[i].pc == pc) {
                 return i;
             }
@@ -37,13 +65,13 @@ private:
 
     int allocate_entry() {
         int index = head;
-        head = (head + 1) % 8;
-        if (count < 8) count++;
+        head = capacity.next(head);
+        if (count < capacity.size()) count++;
         return index;
     }
 
 public:
-    ControlPredictor();
+    ControlPredictor_T(int predictor_size = 8, int ras_size = 4);
     
     // Core prediction functions
     bool lookup_prediction(uint32_t pc, PredictorType type, int32_t offset, uint32_t& target);
@@ -54,9 +82,25 @@ public:
     void push_return_address(uint32_t addr);
     uint32_t pop_return_address();
     
+    // Functional warming: what fetch, dispatch and resolve do for one
+    // executed control instruction, without touching the profile
+    void train(uint32_t pc, InstructionType insn_type, int32_t offset, bool taken,
+               uint32_t target);
+    void copy_state(const ControlPredictor_T& other);  // Table and RAS only
+
     // Query functions
     bool was_predicted_taken(uint32_t pc) const;
+    bool has_entry(uint32_t pc) const { return find_entry(pc) != -1; }
     void display_status() const;
+
+    // Profiling
+    void record_resolution(uint32_t pc, PredictorType type, uint32_t predicted_npc,
+                           bool taken, uint32_t target);
+    void print_profile(uint64_t instructions, int top_n) const;
+    BranchProfile get_totals() const;  // Sum over every static branch
+    void register_stats(StatsRegistry& stats, const std::string& prefix) const;
 };
 
+typedef ControlPredictor_T<CoreVariant::PredictorCapacity> ControlPredictor;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+// include/headers/core_variants.h
+#ifndef _CORE_VARIANTS_H_
+#define _CORE_VARIANTS_H_
+
+#include "capacity.h"
+#include "sim_config.h"
+#include <stdio.h>
+
+// Registry of core variants. Each binary is built for exactly one of them:
+//   (default)            apex_sim         every size and width from SimConfig
+//   -DAPEX_VARIANT_APEX  apex_sim_apex    design document core, 1-wide
+//   -DAPEX_VARIANT_WIDE4 apex_sim_wide4   4-wide core, power-of-two structures
+// Fixed variants compile their structure capacities and pipeline widths in,
+// and force the matching SimConfig fields when the CPU is built. They also
+// pin the remaining machine resources (FUs, ports, IQ, checkpoints, RAS), so
+// a fixed build is exactly the machine of its config file: apex in
+// configs/default.cfg, wide4 in configs/wide4.json.
+
+struct RuntimeVariant {
+    typedef RuntimeCapacity RobCapacity;
+    typedef RuntimeCapacity LsqCapacity;
+    typedef RuntimeCapacity PredictorCapacity;
+    typedef RuntimeCapacity UprfFreeListCapacity;
+    typedef RuntimeCapacity UcrfFreeListCapacity;
+
+    static const char* name() { return "runtime"; }
+    static int fetch_width(const SimConfig& config) { return config.fetch_width; }
+    static int rename_width(const SimConfig& config) { return config.rename_width; }
+    static int issue_width(const SimConfig& config) { return config.issue_width; }
+    static int commit_width(const SimConfig& config) { return config.commit_width; }
+    static void apply(SimConfig&, bool = true) {}
+};
+
+// Forces a SimConfig value, reporting one that a fixed build cannot honour
+inline void fix_config_field(const char* variant, const char* key, int& field, int value,
+                             bool report) {
+    if (field != value) {
+        if (report)
+            printf("Config: %s = %d ignored, the %s build is fixed at %d\n",
+                   key, field, variant, value);
+        field = value;
+    }
+}
+
+template <int FETCH, int RENAME, int ISSUE, int COMMIT,
+          int ROB_N, int LSQ_N, int PRED_N, int UPRF_N, int UCRF_N,
+          int INT_FUS, int WB_PORTS, int IQ_N, int CHECKPOINTS, int RAS_N>
+struct FixedCoreVariant {
+    static_assert(UPRF_N > 32, "UPRF must hold the 32 architectural registers and one rename");
+    typedef FixedCapacity<ROB_N> RobCapacity;
+    typedef FixedCapacity<LSQ_N> LsqCapacity;
+    typedef FixedCapacity<PRED_N> PredictorCapacity;
+    typedef FixedCapacity<UPRF_N> UprfFreeListCapacity;
+    typedef FixedCapacity<UCRF_N> UcrfFreeListCapacity;
+
+    static constexpr int fetch_width(const SimConfig&) { return FETCH; }
+    static constexpr int rename_width(const SimConfig&) { return RENAME; }
+    static constexpr int issue_width(const SimConfig&) { return ISSUE; }
+    static constexpr int commit_width(const SimConfig&) { return COMMIT; }
+
+    static void apply_fixed(const char* variant, SimConfig& config, bool report) {
+        fix_config_field(variant, "fetch_width", config.fetch_width, FETCH, report);
+        fix_config_field(variant, "rename_width", config.rename_width, RENAME, report);
+        fix_config_field(variant, "issue_width", config.issue_width, ISSUE, report);
+        fix_config_field(variant, "commit_width", config.commit_width, COMMIT, report);
+        fix_config_field(variant, "rob_size", config.rob_size, ROB_N, report);
+        fix_config_field(variant, "lsq_size", config.lsq_size, LSQ_N, report);
+        fix_config_field(variant, "predictor_size", config.predictor_size, PRED_N, report);
+        fix_config_field(variant, "uprf_size", config.uprf_size, UPRF_N, report);
+        fix_config_field(variant, "ucrf_size", config.ucrf_size, UCRF_N, report);
+        fix_config_field(variant, "int_fus", config.int_fus, INT_FUS, report);
+        fix_config_field(variant, "wb_ports", config.wb_ports, WB_PORTS, report);
+        fix_config_field(variant, "iq_size", config.iq_size, IQ_N, report);
+        fix_config_field(variant, "checkpoints", config.checkpoints, CHECKPOINTS, report);
+        fix_config_field(variant, "ras_size", config.ras_size, RAS_N, report);
+    }
+};
+
+// Production configurations, sizes in template order: widths, ROB, LSQ,
+// predictor, UPRF, UCRF, int FUs, WB ports, IQ, checkpoints, RAS
+struct ApexVariant : FixedCoreVariant<1, 1, 1, 1, 80, 6, 8, 60, 10, 1, 2, 16, 8, 4> {
+    static const char* name() { return "apex"; }
+    static void apply(SimConfig& config, bool report = true) { apply_fixed(name(), config, report); }
+};
+
+struct Wide4Variant : FixedCoreVariant<4, 4, 4, 4, 128, 16, 32, 128, 16, 2, 4, 32, 16, 8> {
+    static const char* name() { return "wide4"; }
+    static void apply(SimConfig& config, bool report = true) { apply_fixed(name(), config, report); }
+};
+
+#if defined(APEX_VARIANT_APEX)
+typedef ApexVariant CoreVariant;
+#elif defined(APEX_VARIANT_WIDE4)
+typedef Wide4Variant CoreVariant;
+#else
+typedef RuntimeVariant CoreVariant;
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+// include/headers/cpi_stack.h
+#ifndef _CPI_STACK_H_
+#define _CPI_STACK_H_
+
+#include <stdint.h>
+#include <string>
+
+class StatsRegistry;
+
+// Root cause of commit slots lost in a cycle
+enum StallCause {
+    STALL_NONE,            // Slot used by a retiring instruction (base CPI)
+    STALL_ROB_FULL,
+    STALL_LSQ_FULL,
+    STALL_IQ_FULL,
+    STALL_UPRF_EMPTY,      // No free physical register
+    STALL_UCRF_EMPTY,      // No free CC register
+    STALL_CHECKPOINTS,     // All rename checkpoints in use
+    STALL_FETCH,           // Front end delivered nothing
+    STALL_MISPREDICT,      // Refilling after a branch mispredict
+    STALL_MEMFU_BUSY,      // ROB head memory op waiting for the Memory FU
+    STALL_LOAD,            // ROB head waiting on a load
+    STALL_EXECUTE,         // ROB head waiting on operands or a FU latency
+    STALL_CAUSE_COUNT
+};
+
+// Commit slot accounting: every cycle contributes commit_width slots,
+// split between retired instructions and one stall cause
+class CpiStack {
+private:
+    uint64_t slots[STALL_CAUSE_COUNT];
+    uint64_t cycles;
+    int width;
+
+public:
+    CpiStack(int commit_width = 1);
+
+    void record_cycle(int committed, StallCause cause);
+    void set_width(int commit_width) { width = commit_width > 0 ? commit_width : 1; }
+    uint64_t get_slots(StallCause cause) const { return slots[cause]; }
+    uint64_t get_cycles() const { return cycles; }
+    static const char* get_name(StallCause cause);
+    void print(uint64_t instructions) const;
+    void register_stats(StatsRegistry& stats, const std::string& prefix) const;
+};
+
+#endif
@@ -0,0 +1,102 @@
+// include/headers/critical_path.h
+#ifndef _CRITICAL_PATH_H_
+#define _CRITICAL_PATH_H_
+
+#include "apex_cpu_types.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class StatsRegistry;
+
+// What a cycle on the critical path was spent on
+enum CritCause {
+    CRIT_FRONTEND,         // Fetch and decode bandwidth
+    CRIT_MISPREDICT,       // Branch resolution to correct-path dispatch
+    CRIT_WINDOW,           // Dispatch blocked by a full ROB/IQ/LSQ or free list
+    CRIT_ISSUE,            // Ready but waiting for a FU or issue slot
+    CRIT_ALU,              // Integer FU latency
+    CRIT_MUL,              // Multiply FU latency
+    CRIT_MEMORY,           // Memory FU latency and in-order memory issue
+    CRIT_COMMIT,           // Completion to retirement, commit bandwidth
+    CRIT_CAUSE_COUNT
+};
+
+// Stage cycles and dependences of one instruction, kept by ROB entry while
+// in flight and by commit order once retired
+struct CritRecord {
+    uint64_t seq;
+    InstructionType type;
+    bool executes;            // Went through a FU (NOP/HALT complete at dispatch)
+    uint64_t fetch;
+    uint64_t decode;
+    uint64_t dispatch;
+    uint64_t issue;
+    uint64_t complete;        // Writeback, the tag went out the cycle before
+    uint64_t retire;
+    uint64_t producers[4];    // Seq of the register/CC producers, 0 if none
+    uint64_t mem_pred;        // Previous memory op, they issue in order
+    uint64_t redirect;        // Mispredicted branch that redirected fetch here
+};
+
+// Dynamic dependence graph over committed instructions (Fields et al.
+// style: fetch, decode, dispatch, issue, tag, complete and retire nodes).
+// Every `window` commits the critical path from the newest retire back to
+// the previous window's last retire is walked along last-arriving edges
+// and its cycles charged to a cause. Only the last 2 * window commits are
+// kept, so memory is flat whatever the run length.
+class CriticalPath {
+private:
+    enum Node { NODE_FETCH, NODE_DECODE, NODE_DISPATCH, NODE_ISSUE, NODE_TAG,
+                NODE_COMPLETE, NODE_RETIRE };
+
+    bool enabled;
+    int window;
+    std::vector<CritRecord> inflight;     // Indexed by ROB entry
+    std::vector<CritRecord> committed;    // Ring indexed by commit number
+    uint64_t commits;
+    uint64_t analyzed;                    // Commits already covered by a walk
+    uint64_t boundary;                    // Retire cycle where the last walk ended
+    std::vector<uint64_t> reg_producer;   // Seq of the last writer of each UPRF entry
+    std::vector<uint64_t> cc_producer;
+    uint64_t last_mem_seq;
+    uint64_t pending_redirect;
+    uint64_t cycles[CRIT_CAUSE_COUNT];
+
+    const CritRecord* get_committed(uint64_t n) const;
+    int64_t find_committed(uint64_t seq) const;
+    void analyze();
+
+public:
+    CriticalPath(int rob_size, int uprf_size, int ucrf_size);
+
+    void enable(int window_size);
+    bool is_enabled() const { return enabled; }
+
+    void on_dispatch(int rob_idx, uint64_t seq, InstructionType type, uint64_t fetch,
+                     uint64_t decode, uint64_t cycle, const uint32_t* src_tags, uint32_t cc_tag,
+                     uint32_t dest_phys, uint32_t dest_cc);
+    void on_issue(int rob_idx, uint64_t cycle) {
+        if (enabled) {
+            inflight[rob_idx].issue = cycle;
+            inflight[rob_idx].executes = true;
+        }
+    }
+    void on_complete(int rob_idx, uint64_t cycle) {
+        if (enabled) inflight[rob_idx].complete = cycle;
+    }
+    void on_retire(int rob_idx, uint64_t cycle);
+    void on_squash(int rob_idx);
+    void on_redirect(uint64_t branch_seq) {
+        if (enabled) pending_redirect = branch_seq;
+    }
+    void finish();            // Walks the partial last window
+
+    uint64_t get_cycles(CritCause cause) const { return cycles[cause]; }
+    uint64_t get_length() const;
+    static const char* get_name(CritCause cause);
+    void print(uint64_t total_cycles) const;
+    void register_stats(StatsRegistry& stats, const std::string& prefix) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+// include/headers/data_cache.h
+#ifndef _DATA_CACHE_H_
+#define _DATA_CACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class StatsRegistry;
+
+// Tag-only L1 data cache in front of the Memory FU: set-associative, LRU,
+// write-allocate. Data always comes from the flat memory array, the cache
+// only decides how long an access takes. sets = 0 disables it, every
+// access then hits (the original fixed-latency memory).
+class DataCache {
+private:
+    int sets;
+    int ways;
+    int line_words;
+    int miss_penalty;         // Extra cycles in the last Memory FU stage
+    std::vector<uint32_t> tags;        // sets * ways, line address
+    std::vector<uint64_t> last_use;    // 0 = invalid
+    uint64_t use_clock;
+    uint64_t hits[2];         // Loads, stores
+    uint64_t misses[2];
+
+public:
+    DataCache(int num_sets, int num_ways, int words_per_line, int miss_cycles);
+
+    bool is_enabled() const { return sets > 0; }
+    void set_miss_penalty(int miss_cycles) { miss_penalty = miss_cycles; }
+
+    // Looks up and fills the line, returns the extra cycles of a miss
+    int access(uint32_t address, bool is_store);
+    // Contents and LRU order of a cache of the same geometry, not its counters
+    void copy_state(const DataCache& other);
+
+    uint64_t get_hits() const { return hits[0] + hits[1]; }
+    uint64_t get_misses() const { return misses[0] + misses[1]; }
+    void register_stats(StatsRegistry& stats, const std::string& prefix) const;
+};
+
+#endif
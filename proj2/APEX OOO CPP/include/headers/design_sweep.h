@@ -0,0 +1,72 @@
+// include/headers/design_sweep.h
+#ifndef _DESIGN_SWEEP_H_
+#define _DESIGN_SWEEP_H_
+
+#include "file_parser.h"
+#include "sim_config.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// One swept SimConfig key and the values it takes
+struct SweepParam {
+    std::string name;
+    std::vector<int> values;
+};
+
+// One configuration of the sweep and what it measured
+struct SweepPoint {
+    std::vector<int> levels;  // Index into each parameter's values
+    bool valid;               // Passed SimConfig::validate
+    bool halted;              // Ran to HALT, not cut off by a limit
+    bool stalled;             // Stopped after stall_limit cycles without a commit
+    uint64_t cycles;
+    uint64_t committed;
+    double host_seconds;
+    std::vector<double> stats;        // Parallel to the reported stat names
+    std::vector<bool> found;
+};
+
+// Design-space exploration: parameter ranges over a base SimConfig, the
+// full cross product or a Latin-hypercube sample of it, every point run
+// in-process on a pool of host threads (a fresh APEX_CPU each) and one
+// result table written at the end.
+class DesignSweep {
+private:
+    const std::vector<APEX_Instruction>& code;
+    const char* data_file;
+    SimConfig base;
+    std::vector<SweepParam> params;
+    std::vector<std::string> stat_names;
+    std::vector<SweepPoint> points;
+    uint64_t max_insns;
+    uint64_t max_cycles;
+    uint64_t stall_limit;     // Cycles without a commit before a point is given up, 0 = none
+    int threads;
+    double host_seconds;
+
+    SimConfig config_of(const SweepPoint& point) const;
+    void simulate(SweepPoint& point) const;
+
+public:
+    DesignSweep(const std::vector<APEX_Instruction>& program, const char* data_path,
+                const SimConfig& base_config);
+
+    // "key=a,b,c", "key=lo:hi" (step 1), "key=lo:hi:step" or "key=lo:hi:*factor"
+    bool add_param(const char* spec);
+    void add_stat(const char* name) { stat_names.push_back(name); }
+    void set_limits(uint64_t insns, uint64_t cycles) { max_insns = insns; max_cycles = cycles; }
+    void set_stall_limit(uint64_t cycles) { stall_limit = cycles; }
+
+    // Both return the number of points, invalid configurations included
+    size_t make_grid();
+    size_t make_latin_hypercube(int samples, uint64_t seed);
+
+    void run(int jobs);       // jobs <= 0 uses every hardware thread
+    void print_summary(FILE* out) const;
+    bool write(FILE* out, bool json) const;
+    bool write_file(const char* path) const;  // JSON unless the name ends in .csv
+};
+
+#endif
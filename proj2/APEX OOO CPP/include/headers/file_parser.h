@@ -0,0 +1,26 @@
+// include/headers/file_parser.h
+#ifndef _FILE_PARSER_H_
+#define _FILE_PARSER_H_
+
+#include "apex_cpu_types.h"
+#include <stdint.h>
+#include <vector>
+
+// Format of a decoded APEX instruction
+struct APEX_Instruction {
+    char opcode_str[16];     // Mnemonic as written in the .asm file
+    InstructionType type;    // Operation executed by the pipeline
+    uint32_t rd;             // Destination register (REG_NONE if unused)
+    uint32_t rs1;            // Source register 1 (REG_NONE if unused)
+    uint32_t rs2;            // Source register 2 (REG_NONE if unused)
+    uint32_t rs3;            // Source register 3, STR offset (REG_NONE if unused)
+    int32_t imm;             // Literal operand
+};
+
+// Parses an APEX assembly file into code memory, returns false on error
+bool create_code_memory(const char* filename, std::vector<APEX_Instruction>& code);
+
+// Reads comma or newline separated data words into memory starting at address 0
+int load_data_memory(const char* filename, uint32_t* memory, int size);
+
+#endif
@@ -0,0 +1,48 @@
+// include/headers/free_list.h
+#ifndef _FREE_LIST_H_
+#define _FREE_LIST_H_
+
+#include "core_variants.h"
+#include "apex_log.h"
+#include <stdint.h>
+
+// FIFO of free physical registers, a ring buffer over the capacity policy.
+// Same interface as the std::queue it replaces.
+template <class Capacity>
+class FreeList_T {
+private:
+    Capacity capacity;
+    typename Capacity::template Storage<uint32_t>::type slots;
+    int head;
+    int count;
+
+public:
+    FreeList_T(int size = 0) : capacity(size), head(0), count(0) {
+        capacity.allocate(slots);
+    }
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    uint32_t front() const { return slots[head]; }
+
+    void pop() {
+        if (count > 0) {
+            head = capacity.next(head);
+            count--;
+        }
+    }
+
+    void push(uint32_t reg) {
+        if (count == capacity.size()) {
+            APEX_WARN(LOG_RENAME, "FreeList: Overflow, register %u dropped\n", reg);
+            return;
+        }
+        slots[capacity.wrap(head + count)] = reg;
+        count++;
+    }
+};
+
+typedef FreeList_T<CoreVariant::UprfFreeListCapacity> UprfFreeList;
+typedef FreeList_T<CoreVariant::UcrfFreeListCapacity> UcrfFreeList;
+
+#endif
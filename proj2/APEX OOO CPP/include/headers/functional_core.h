@@ -0,0 +1,101 @@
+// include/headers/functional_core.h
+#ifndef _FUNCTIONAL_CORE_H_
+#define _FUNCTIONAL_CORE_H_
+
+#include "block_translator.h"
+#include "file_parser.h"
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+// What one instruction did, for profilers and warming
+struct FunctionalStep {
+    uint32_t pc;
+    InstructionType type;
+    uint32_t next_pc;
+    bool taken;               // Control instruction left the fall-through path
+    uint32_t address;         // Memory word address of a LOAD/STORE
+};
+
+// Architectural state after `insns` instructions, enough to start the
+// detailed core or another FunctionalCore at that point
+struct ArchCheckpoint {
+    uint64_t insns;
+    uint32_t pc;
+    uint32_t regs[32];
+    uint8_t cc;
+    bool halted;
+    std::vector<uint32_t> memory;
+};
+
+// An instruction decoded once for the superblock interpreter. Register
+// fields are 32 for REG_NONE, which reads the always-zero regs[32].
+struct DecodedInsn {
+    InstructionType type;
+    uint8_t rd;
+    uint8_t rs1;
+    uint8_t src2;             // rs2 (the STORE base), or 33 for the literal
+    uint8_t offset;           // STORE: rs3, or 33 for the literal
+    uint32_t imm;
+};
+
+// Architectural (ISA-level) execution of an APEX program, one instruction
+// per step with the same semantics as the function units. Used to run
+// ahead of the detailed core.
+class FunctionalCore {
+private:
+    const std::vector<APEX_Instruction>* code;
+    uint32_t regs[34];        // [32] is zero, [33] holds the current literal
+    uint8_t cc;               // CC_ZERO / CC_NEGATIVE / CC_POSITIVE
+    uint32_t pc;
+    std::vector<uint32_t> memory;
+    bool halted;
+    uint64_t retired;
+    std::vector<DecodedInsn> decoded;       // Program image, decoded on first run() after a load
+    std::vector<uint32_t> superblock_end;   // Per entry index, 0 until first entered
+    std::unique_ptr<BlockTranslator> translator;
+    uint32_t translate_threshold;
+    uint64_t translated;      // Instructions retired in translated blocks
+
+    static uint8_t flags_of(uint32_t value);
+    uint32_t read_reg(uint32_t reg) const { return reg < 32 ? regs[reg] : 0; }
+    void decode_program();
+    uint64_t run_superblock(uint64_t budget);
+    uint64_t run_translated_block(uint64_t budget);
+
+public:
+    FunctionalCore(const std::vector<APEX_Instruction>& program, int memory_words = 4096);
+
+    int load_data(const char* filename);
+
+    // Executes the instruction at pc, false once HALT retired or pc left the program
+    bool step(FunctionalStep& out);
+    // Runs superblocks of pre-decoded instructions (entry to the next control
+    // transfer) and, with translation on, their host code once hot.
+    // 0 = until HALT, returns instructions executed.
+    uint64_t run(uint64_t max_insns);
+
+    // run() executes blocks entered hot_threshold times as host code;
+    // step() always interprets. 0 turns translation off.
+    void enable_translation(uint32_t hot_threshold = 16);
+
+    // Runs program from the next step on, keeping registers, memory and pc.
+    // Any change to the image, even in place, must come through here.
+    void load_program(const std::vector<APEX_Instruction>& program);
+    // Drops decoded superblocks and translations after the program changed
+    void invalidate_decoded();
+    const BlockTranslator* get_translator() const { return translator.get(); }
+    uint64_t get_translated() const { return translated; }
+
+    void save_checkpoint(ArchCheckpoint& checkpoint) const;
+    void restore_checkpoint(const ArchCheckpoint& checkpoint);
+
+    bool is_halted() const { return halted; }
+    uint64_t get_retired() const { return retired; }
+    uint32_t get_pc() const { return pc; }
+    uint32_t get_reg(int reg) const { return regs[reg]; }
+    uint8_t get_cc() const { return cc; }
+    const std::vector<uint32_t>& get_memory() const { return memory; }
+};
+
+#endif
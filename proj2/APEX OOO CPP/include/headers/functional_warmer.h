@@ -0,0 +1,41 @@
+// include/headers/functional_warmer.h
+#ifndef _FUNCTIONAL_WARMER_H_
+#define _FUNCTIONAL_WARMER_H_
+
+#include "control_predictor.h"
+#include "data_cache.h"
+#include "functional_core.h"
+#include "sim_config.h"
+#include <stdint.h>
+#include <vector>
+
+class APEX_CPU;
+
+// Functional warming: while the functional core fast-forwards, every
+// control instruction trains a control predictor and every LOAD/STORE
+// goes through a D-cache of the detailed core's geometry. A copy of both
+// is loaded into the detailed core at a checkpoint, so its first cycles
+// do not see cold tables. Costs one interpreted step per instruction.
+class FunctionalWarmer {
+private:
+    const std::vector<APEX_Instruction>& code;
+    ControlPredictor predictor;
+    DataCache dcache;
+    uint64_t warmed;          // Instructions observed
+    uint64_t branches;
+    uint64_t accesses;
+
+public:
+    FunctionalWarmer(const std::vector<APEX_Instruction>& program, const SimConfig& config);
+
+    void observe(const FunctionalStep& step);
+    // Steps the core up to max_insns (stopping at HALT), observing each
+    uint64_t run(FunctionalCore& core, uint64_t max_insns);
+    void apply(APEX_CPU& cpu) const;
+
+    uint64_t get_warmed() const { return warmed; }
+    uint64_t get_branches() const { return branches; }
+    uint64_t get_accesses() const { return accesses; }
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "apex_cpu_types.h"
 #include "control_predictor.h"
+#include "result_bus.h"
 #include <stdint.h>
 
 struct IntFUResult {
@@ -11,16 +12,20 @@ struct IntFUResult {
     bool cc_modified;
     uint8_t cc_flags;    // Zero, Negative, Positive flags
     bool mispredicted;   // For branch instructions
+    bool taken;          // Resolved direction for control instructions
     uint32_t target;     // Target address for control instructions
 };
 
-class IntegerFU {
+class IntegerFU : public ResultBusListener {
 private:
     ControlPredictor& predictor;
     bool busy;
     uint32_t current_pc;
     uint32_t src1_value;
     uint32_t src2_value;
+    uint32_t src1_tag;        // Operand still on the result bus (REG_NONE if captured)
+    uint32_t src2_tag;
+    bool src1_is_cc;          // Branches read the CC register as source 1
     InstructionType op_type;
     uint32_t rob_index;
     bool executing;
@@ -34,11 +39,17 @@ public:
 
     // Core Functions
     bool can_accept();
-    bool issue(uint32_t pc, InstructionType op, uint32_t s1, uint32_t s2, uint32_t rob_idx);
+    bool issue(uint32_t pc, InstructionType op, uint32_t s1, uint32_t s2, uint32_t rob_idx,
+               uint32_t s1_tag = REG_NONE, uint32_t s2_tag = REG_NONE, bool s1_is_cc = false);
+    bool operands_ready() const { return src1_tag == REG_NONE && src2_tag == REG_NONE; }
     IntFUResult execute();
+
+    // Result bus
+    void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc);
     
     // Status Functions
     bool is_busy() const { return busy; }
+    uint32_t get_rob_index() const { return rob_index; }
     void clear() { busy = false; executing = false; }
     
     // Debug Support
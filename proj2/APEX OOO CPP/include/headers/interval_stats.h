@@ -0,0 +1,66 @@
+// include/headers/interval_stats.h
+#ifndef _INTERVAL_STATS_H_
+#define _INTERVAL_STATS_H_
+
+#include "stats_registry.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Ratio of two counter deltas reported for every interval, e.g. IPC from
+// committed / cycles or a mean occupancy from sum / samples
+struct IntervalRate {
+    std::string name;
+    std::string numerator;
+    std::string denominator;
+    double scale;
+    int num_index;            // Positions in the collected values, -1 if missing
+    int den_index;
+};
+
+// Time series of a StatsRegistry: every period cycles (or committed
+// instructions) all counters are snapshotted and the deltas since the
+// previous snapshot written as one row, so phases and the end of warm-up
+// show up directly. Formulas and histogram percentiles are cumulative and
+// left to the end-of-run dump.
+class IntervalStats {
+private:
+    const StatsRegistry* registry;
+    FILE* out;
+    bool csv;
+    uint64_t period;
+    bool by_insns;            // Period counts committed instructions
+    uint64_t next_boundary;
+    uint64_t intervals;
+
+    std::vector<IntervalRate> rates;
+    std::vector<StatValue> previous;
+    std::vector<StatValue> current;
+
+    void write_header();
+    void write_row(uint64_t cycle, uint64_t committed);
+
+public:
+    IntervalStats();
+    ~IntervalStats();
+
+    void add_rate(const char* name, const char* numerator, const char* denominator,
+                  double scale = 1.0);
+    bool open(const char* path, const StatsRegistry* registry, uint64_t period, bool by_insns);
+    void close(uint64_t cycle, uint64_t committed);
+
+    // Called once per cycle, writes a row when the period has elapsed
+    void sample(uint64_t cycle, uint64_t committed) {
+        uint64_t position = by_insns ? committed : cycle;
+        if (out && position >= next_boundary) {
+            write_row(cycle, committed);
+            next_boundary = (position / period + 1) * period;
+        }
+    }
+
+    bool is_enabled() const { return out != NULL; }
+    uint64_t get_intervals() const { return intervals; }
+};
+
+#endif
@@ -0,0 +1,71 @@
+// include/headers/issue_queue.h
+#ifndef _ISSUE_QUEUE_H_
+#define _ISSUE_QUEUE_H_
+
+#include "apex_cpu_types.h"
+#include "result_bus.h"
+#include <stdint.h>
+#include <vector>
+
+struct RS_Entry {
+    bool valid;              // Slot holds a waiting instruction
+    uint32_t pc;             // Instruction address
+    InstructionType operation;
+    uint32_t src1_tag;       // Source 1 physical register (REG_NONE if unused)
+    uint32_t src2_tag;       // Source 2 physical register (REG_NONE if unused)
+    uint32_t cc_tag;         // CC physical register read by branches
+    bool src1_ready;         // Source 1 tag seen, may issue
+    bool src2_ready;         // Source 2 tag seen, may issue
+    bool cc_ready;           // CC tag seen, may issue
+    bool src1_pending;       // Value still on its way over the result bus
+    bool src2_pending;
+    bool cc_pending;
+    uint32_t src1_value;     // Source 1 value
+    uint32_t src2_value;     // Source 2 value
+    uint32_t cc_value;       // CC flags
+    int32_t imm;             // Literal operand
+    uint32_t rob_index;      // ROB entry index
+    uint64_t timestamp;      // For oldest-first
+
+    RS_Entry() {
+        valid = false;
+        src1_tag = src2_tag = cc_tag = REG_NONE;
+        src1_ready = src2_ready = cc_ready = true;
+        src1_pending = src2_pending = cc_pending = false;
+    }
+
+    bool is_ready() const { return src1_ready && src2_ready && cc_ready; }
+};
+
+// Unified reservation station feeding the Integer and Multiply FUs.
+// A tag broadcast makes a source ready for selection, the value is
+// captured here or by the FU when it follows a cycle later.
+class IssueQueue : public ResultBusListener {
+private:
+    std::vector<RS_Entry> entries;
+    int size;                // Number of reservation stations
+    int count;
+
+public:
+    IssueQueue(int iq_size = 16);
+
+    // Core Functions
+    int add_entry(const RS_Entry& entry);
+    int select_ready(bool int_fu_free, bool mul_fu_free);  // Oldest ready first
+    RS_Entry& get_entry(int index) { return entries[index]; }
+    void remove_entry(int index);
+    void flush(uint64_t timestamp);  // Drop entries younger than timestamp
+
+    // Result bus
+    void on_tag_broadcast(uint32_t tag, bool is_cc);
+    void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc);
+
+    // Utility Functions
+    bool is_full() const { return count == size; }
+    int get_size() const { return size; }
+    bool is_empty() const { return count == 0; }
+    int get_count() const { return count; }
+    void display_status();
+};
+
+#endif
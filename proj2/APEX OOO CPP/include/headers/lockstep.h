@@ -0,0 +1,86 @@
+// include/headers/lockstep.h
+#ifndef _LOCKSTEP_H_
+#define _LOCKSTEP_H_
+
+#include "file_parser.h"
+#include <stdint.h>
+#include <vector>
+
+#define NO_RECONVERGENCE 0xFFFFFFFF
+
+// Immediate post-dominator PC of every instruction, where lanes that split
+// at it meet again. JALP is taken to return to the next instruction;
+// JUMP and JALR whose base register is set once by MOVC go to that target;
+// other RET, JUMP, JALR and HALT lead to the exit (NO_RECONVERGENCE).
+std::vector<uint32_t> compute_reconvergence(const std::vector<APEX_Instruction>& code);
+
+// Lane vector types; GCC needs the size fixed outside the template
+template <int W> struct LaneVector;
+template <> struct LaneVector<8> {
+    typedef uint32_t type __attribute__((vector_size(32)));
+    typedef int32_t signed_type __attribute__((vector_size(32)));
+};
+template <> struct LaneVector<16> {
+    typedef uint32_t type __attribute__((vector_size(64)));
+    typedef int32_t signed_type __attribute__((vector_size(64)));
+};
+
+// W instances of one program executed in lockstep, e.g. the same kernel on
+// W different memory.txt inputs. Registers and memory are stored
+// structure-of-arrays (one vector of W lanes per register or memory word),
+// so one APEX instruction is one vector operation (SSE/AVX with the
+// compiler's vector extensions). Lanes that take different paths are
+// masked off and run under a reconvergence stack (SIMT style) until the
+// immediate post-dominator of the branch. Same results as FunctionalCore
+// per lane.
+template <int W>
+class LockstepCore {
+public:
+    typedef typename LaneVector<W>::type Vec;
+    typedef typename LaneVector<W>::signed_type SVec;
+    typedef uint32_t LaneMask;
+
+private:
+    struct Frame {
+        uint32_t pc;
+        uint32_t reconverge;
+        LaneMask mask;
+    };
+
+    const std::vector<APEX_Instruction>& code;
+    const std::vector<uint32_t>& reconvergence;
+    Vec regs[33];             // REG_NONE reads the zero vector at index 32
+    Vec cc;
+    Vec retired;
+    std::vector<Vec> memory;  // One vector per word address
+    std::vector<Frame> stack;
+    LaneMask lanes;           // Lanes holding an instance
+    LaneMask halted;
+    uint64_t steps;           // Vector instructions executed
+    uint64_t lane_insns;      // Sum over lanes
+
+    static Vec splat(uint32_t value) { return Vec{} + value; }
+    static Vec lane_select(LaneMask mask);
+    static LaneMask to_mask(SVec condition, LaneMask active);
+    void diverge(LaneMask taken, uint32_t target, LaneMask fall, uint32_t fall_pc,
+                 uint32_t reconverge_pc);
+    void step(Frame& top, LaneMask active);
+
+public:
+    LockstepCore(const std::vector<APEX_Instruction>& program,
+                 const std::vector<uint32_t>& reconverge_pcs, int memory_words, int instances);
+
+    int load_data(int lane, const char* filename);
+    uint64_t run(uint64_t max_steps);  // 0 = until every lane halts
+
+    uint32_t get_reg(int lane, int reg) const { return regs[reg][lane]; }
+    uint32_t get_memory(int lane, uint32_t address) const {
+        return address < memory.size() ? memory[address][lane] : 0;
+    }
+    uint64_t get_retired(int lane) const { return retired[lane]; }
+    bool is_halted(int lane) const { return (halted >> lane) & 1; }
+    uint64_t get_steps() const { return steps; }
+    uint64_t get_lane_insns() const { return lane_insns; }
+};
+
+#endif
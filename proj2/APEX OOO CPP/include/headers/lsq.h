@@ -3,6 +3,8 @@
 #define _LSQ_H_
 
 #include "apex_cpu_types.h"
+#include "result_bus.h"
+#include "core_variants.h"
 #include <stdint.h>
 
 struct LSQ_Entry {
@@ -27,39 +29,74 @@ struct LSQ_Entry {
     
     // Control
     uint32_t age;              // For ordering memory operations
+    bool issued;               // Sent to the Memory FU
     bool completed;            // Execution status
+
+    // Cycles for the load latency profile
+    uint64_t dispatch_cycle;
+    uint64_t address_cycle;    // Address became ready
+    uint64_t issue_cycle;
     
     LSQ_Entry() {
+        address = 0;
+        data = 0;
+        is_store = false;
+        rob_index = 0;
+        base_reg_tag = offset_reg_tag = data_reg_tag = REG_NONE;
+        base_value = 0;
+        offset_value = 0;
+        age = 0;
+        dispatch_cycle = 0;
+        address_cycle = 0;
+        issue_cycle = 0;
         address_ready = false;
         base_ready = false;
         offset_ready = false;
         data_ready = false;
+        issued = false;
         completed = false;
     }
 };
 
-class LSQ {
+// Circular load/store queue, capacity policy from capacity.h
+template <class Capacity>
+class LSQ_T : public ResultBusListener {
 private:
-    LSQ_Entry entries[6];      // 6-entry queue
+    Capacity capacity;
+    typename Capacity::template Storage<LSQ_Entry>::type entries;
     int head;                  // Oldest entry
     int tail;                  // Next free entry
     int count;                // Number of valid entries
+    uint64_t now;             // Current cycle, set by the CPU
+
+    void try_calculate_address(int index);
     
 
 public:
-    LSQ();
+    LSQ_T(int lsq_size = 6);
     // Add these getters
     uint32_t get_address(int index) const {
-        return (index >= 0 && index < 6) ? entries[index].address : 0;
+        return (index >= 0 && index < capacity.size()) ? entries[index].address : 0;
     }
     
     bool is_store(int index) const {
-        return (index >= 0 && index < 6) ? entries[index].is_store : false;
+        return (index >= 0 && index < capacity.size()) ? entries[index].is_store : false;
     }
     
     uint32_t get_data(int index) const {
-        return (index >= 0 && index < 6) ? entries[index].data : 0;
+        return (index >= 0 && index < capacity.size()) ? entries[index].data : 0;
+    }
+
+    uint32_t get_rob_index(int index) const {
+        return (index >= 0 && index < capacity.size()) ? entries[index].rob_index : 0;
+    }
+
+    bool is_issued(int index) const {
+        return (index >= 0 && index < capacity.size()) ? entries[index].issued : false;
     }
+
+    const LSQ_Entry& get_entry(int index) const { return entries[index]; }
+    void set_cycle(uint64_t cycle) { now = cycle; }
     
     // Core Functions
     int add_entry(bool is_store, uint32_t rob_idx);
@@ -67,19 +104,32 @@ public:
     void set_address(int index, uint32_t addr);
     void set_data(int index, uint32_t data);
     void complete_entry(int index);
+    void mark_issued(int index);
     void remove_entry();  // Called after commit
+    void rollback(int num_squashed);  // Drop the youngest entries
     int get_head() const { return head; }
+    int get_count() const { return count; }
     
     // Dependency Management
     void set_base_tag(int index, uint32_t tag);
     void set_offset_tag(int index, uint32_t tag);
     void set_data_tag(int index, uint32_t tag);
+    void set_base_value(int index, uint32_t value);
+    void set_offset_value(int index, uint32_t value);
     void update_tag(uint32_t tag, uint32_t value);
+
+    // Result bus, addresses and store data need the value phase only
+    void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) {
+        if (!is_cc) update_tag(tag, value);
+    }
     
     // Utility Functions
-    bool is_full() { return count == 6; }
+    bool is_full() { return count == capacity.size(); }
+    int get_size() const { return capacity.size(); }
     bool is_empty() { return count == 0; }
     void display_status();
 };
 
+typedef LSQ_T<CoreVariant::LsqCapacity> LSQ;
+
 #endif
\ No newline at end of file
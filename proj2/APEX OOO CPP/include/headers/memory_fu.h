@@ -2,39 +2,63 @@
 #define _MEMORY_FU_H_
 
 #include "apex_cpu_types.h"
+#include "data_cache.h"
+#include "memory_port.h"
 #include "lsq.h"
 #include <stdint.h>
+#include <vector>
 
-// Structure to represent each stage of the 3-stage Memory FU
+// Structure to represent each stage of the Memory FU (3 stages by default)
 struct MemStage {
     bool busy;
     int lsq_index;    // Index of LSQ entry being processed
     uint32_t address; // Memory address being accessed
     uint32_t data;    // Data being read/written
     bool is_store;    // Type of operation
+    int stall;        // D-cache miss cycles left in the last stage
+};
+
+// Operation leaving the last stage in a cycle
+struct MemFUResult {
+    bool valid;
+    int lsq_index;
+    uint32_t address;
+    uint32_t data;    // Loaded value for LOADs
+    bool is_store;
 };
 
 class MemoryFU {
 private:
     LSQ& lsq;                 // Reference to LSQ
-    MemStage stages[3];       // 3 pipeline stages
-    uint32_t memory[4096];    // Simple memory array for simulation
+    std::vector<MemStage> stages;    // Pipeline stages
+    std::vector<uint32_t> memory;    // Simple memory array for simulation
+    DataCache dcache;                // Timing only, memory holds the data
+    MemoryPort* port;                // Replaces memory and dcache when set
 
     // Internal function to move operations through stages
-    void advance_stages();
+    MemFUResult advance_stages();
     
 public:
-    MemoryFU(LSQ& lsq_ref);
+    MemoryFU(LSQ& lsq_ref, int num_stages = 3, int memory_words = 4096,
+             int cache_sets = 0, int cache_ways = 1, int line_words = 1, int miss_penalty = 0);
     
     // Core Functions
     bool can_accept();  // Check if FU can accept new operation
+    int get_busy_count() const;  // Operations in flight
     bool issue(int lsq_index);  // Try to issue LSQ entry to FU
-    void execute();  // Execute one cycle
+    MemFUResult execute();  // Execute one cycle
+    void squash(int lsq_index);  // Drop a wrong-path operation
     
     // Memory Access Functions
     uint32_t read_memory(uint32_t address);
     void write_memory(uint32_t address, uint32_t data);
+    int load_data(const char* filename);  // Initialize memory from a data file
+    void load_image(const std::vector<uint32_t>& image);  // Architectural checkpoint
     
+    void attach_port(MemoryPort* memory_port) { port = memory_port; }
+    DataCache& get_cache() { return dcache; }
+    const DataCache& get_cache() const { return dcache; }
+
     // Debug/Display
     void display_status();
 };
@@ -0,0 +1,20 @@
+// include/headers/memory_port.h
+#ifndef _MEMORY_PORT_H_
+#define _MEMORY_PORT_H_
+
+#include <stdint.h>
+
+// Memory seen through something other than the Memory FU's private array,
+// e.g. a coherent L1 in front of memory shared by several cores. Addresses
+// are word addresses.
+class MemoryPort {
+public:
+    virtual ~MemoryPort() {}
+
+    // Timing lookup when the op enters the Memory FU, returns extra cycles
+    virtual int access(uint32_t address, bool is_store) = 0;
+    virtual uint32_t read(uint32_t address) = 0;
+    virtual void write(uint32_t address, uint32_t data) = 0;
+};
+
+#endif
@@ -0,0 +1,60 @@
+// include/headers/memory_profile.h
+#ifndef _MEMORY_PROFILE_H_
+#define _MEMORY_PROFILE_H_
+
+#include "occupancy_histogram.h"
+#include <stdint.h>
+#include <string>
+
+class StatsRegistry;
+
+// Longer waits are counted in the last bucket
+#define LOAD_LATENCY_LIMIT 63
+
+// Where each load spends its time between dispatch and data return, and
+// how many memory operations overlap. A long address wait points at the
+// producers of the address, a long issue wait at the in-order LSQ issue
+// policy (LSQ::can_execute) and a full LSQ with low MLP at the LSQ size.
+class MemoryProfile {
+private:
+    OccupancyHistogram address_wait;   // Dispatch -> address ready
+    OccupancyHistogram issue_wait;     // Address ready -> sent to the Memory FU
+    OccupancyHistogram access;         // Issue -> data return
+    OccupancyHistogram latency;        // Dispatch -> data return
+    OccupancyHistogram outstanding;    // Memory ops in the Memory FU, every cycle
+    uint64_t loads;
+    uint64_t active_cycles;            // Cycles with at least one op outstanding
+    uint64_t outstanding_sum;
+
+public:
+    MemoryProfile(int mem_stages);
+
+    void record_load(uint64_t dispatch, uint64_t address_ready, uint64_t issue,
+                     uint64_t data_return) {
+        address_wait.sample((int)(address_ready - dispatch));
+        issue_wait.sample((int)(issue - address_ready));
+        access.sample((int)(data_return - issue));
+        latency.sample((int)(data_return - dispatch));
+        loads++;
+    }
+
+    void sample_outstanding(int count) {
+        outstanding.sample(count);
+        if (count > 0) {
+            active_cycles++;
+            outstanding_sum += count;
+        }
+    }
+
+    // MLP as average overlap while memory is busy (Chou et al.)
+    double get_mlp() const {
+        return active_cycles ? (double)outstanding_sum / active_cycles : 0.0;
+    }
+    int get_peak_mlp() const { return outstanding.get_percentile(100); }
+    uint64_t get_loads() const { return loads; }
+
+    void print() const;
+    void register_stats(StatsRegistry& stats) const;
+};
+
+#endif
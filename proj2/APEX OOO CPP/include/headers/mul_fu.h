@@ -0,0 +1,53 @@
+// include/headers/mul_fu.h
+#ifndef _MUL_FU_H_
+#define _MUL_FU_H_
+
+#include "apex_cpu_types.h"
+#include "result_bus.h"
+#include <stdint.h>
+#include <vector>
+
+// Structure to represent each stage of the Multiply FU (4 stages by default)
+struct MulStage {
+    bool busy;
+    uint32_t pc;
+    uint32_t src1_value;
+    uint32_t src2_value;
+    uint32_t src1_tag;       // Operand still on the result bus (REG_NONE if captured)
+    uint32_t src2_tag;
+    uint32_t rob_index;
+};
+
+struct MulFUResult {
+    bool valid;          // An operation left the last stage this cycle
+    uint32_t value;
+    uint8_t cc_flags;
+    uint32_t rob_index;
+};
+
+class MultiplyFU : public ResultBusListener {
+private:
+    std::vector<MulStage> stages;   // Pipeline stages
+
+public:
+    MultiplyFU(int num_stages = 4);
+
+    // Core Functions
+    bool can_accept();
+    bool issue(uint32_t pc, uint32_t s1, uint32_t s2, uint32_t rob_idx,
+               uint32_t s1_tag = REG_NONE, uint32_t s2_tag = REG_NONE);
+    MulFUResult execute();    // Advance one cycle
+
+    // Result bus
+    void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc);
+
+    // Status Functions
+    bool is_busy() const;
+    void clear();
+    void squash(uint32_t rob_idx);  // Drop a wrong-path operation
+
+    // Debug Support
+    void display_status();
+};
+
+#endif
@@ -0,0 +1,41 @@
+// include/headers/multicore.h
+#ifndef _MULTICORE_H_
+#define _MULTICORE_H_
+
+#include "apex_cpu.h"
+#include "coherent_memory.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+// N APEX cores sharing one data memory through coherent private L1s.
+// Cores run `quantum` cycles each on host threads, then meet at a barrier
+// where CoherentMemory::synchronize makes the quantum's transactions and
+// stores visible. Results are the same for any number of threads.
+class MulticoreSim {
+private:
+    SimConfig config;
+    CoherentMemory memory;
+    std::vector<std::unique_ptr<APEX_CPU> > cores;
+    uint64_t quantum;
+    int threads;
+    double host_seconds;
+
+public:
+    // Line geometry and memory latency come from the dcache_* keys
+    MulticoreSim(const SimConfig& sim_config, int num_cores, uint64_t quantum_cycles,
+                 int transfer_cycles, int upgrade_cycles);
+
+    int load_data(const char* filename) { return memory.load_data(filename); }
+
+    // Core `core` starts at the first instruction of `program` with its id
+    // in register id_reg (none when id_reg < 0)
+    void load_program(int core, const std::vector<APEX_Instruction>& program, int id_reg);
+
+    void run(int jobs, uint64_t max_cycles);  // Until every core halts
+    void print(FILE* out) const;
+    void dump_memory(FILE* out, uint32_t from, uint32_t to) const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+// include/headers/occupancy_histogram.h
+#ifndef _OCCUPANCY_HISTOGRAM_H_
+#define _OCCUPANCY_HISTOGRAM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Per-cycle occupancy of one structure. Buckets are fixed at construction
+// (one per value, grouped once the capacity exceeds MAX_BUCKETS) so a
+// sample is a single increment.
+class OccupancyHistogram {
+private:
+    static const int MAX_BUCKETS = 64;
+
+    const char* name;
+    int capacity;
+    int bucket_width;
+    std::vector<uint64_t> buckets;
+    uint64_t samples;
+    uint64_t sum;
+    uint64_t at_full;
+    int max_seen;
+
+public:
+    OccupancyHistogram(const char* name, int capacity);
+
+    void sample(int value) {
+        if (value < 0) value = 0;
+        if (value > capacity) value = capacity;
+        buckets[value / bucket_width]++;
+        samples++;
+        sum += value;
+        if (value == capacity) at_full++;
+        if (value > max_seen) max_seen = value;
+    }
+
+    double get_mean() const;
+    int get_percentile(double pct) const;  // Upper bound of the bucket holding pct
+    double get_full_fraction() const;
+    uint64_t get_samples() const { return samples; }
+    uint64_t get_sum() const { return sum; }
+
+    static void print_header();
+    void print() const;
+};
+
+#endif
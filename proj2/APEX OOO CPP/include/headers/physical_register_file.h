@@ -0,0 +1,34 @@
+// include/headers/physical_register_file.h
+#ifndef _PHYSICAL_REGISTER_FILE_H_
+#define _PHYSICAL_REGISTER_FILE_H_
+
+#include "result_bus.h"
+#include <stdint.h>
+#include <vector>
+
+// Holds physical register values and ready bits (UPRF or UCRF).
+// RegisterManager owns the mappings, this class owns the data.
+class PhysicalRegisterFile : public ResultBusListener {
+private:
+    std::vector<uint32_t> values;
+    std::vector<bool> ready;
+    bool holds_cc;            // UCRF listens to CC broadcasts only
+
+public:
+    PhysicalRegisterFile(int size, bool cc_file);
+
+    // Core Functions
+    uint32_t read(uint32_t tag) const { return values[tag]; }
+    bool is_ready(uint32_t tag) const { return ready[tag]; }
+    void write(uint32_t tag, uint32_t value);
+    void allocate(uint32_t tag);   // New producer, value no longer valid
+
+    // Result bus
+    void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc);
+
+    // Utility Functions
+    int get_size() const { return (int)values.size(); }
+    void display_status();
+};
+
+#endif
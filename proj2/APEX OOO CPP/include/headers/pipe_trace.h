@@ -0,0 +1,91 @@
+// include/headers/pipe_trace.h
+#ifndef _PIPE_TRACE_H_
+#define _PIPE_TRACE_H_
+
+#include "file_parser.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// gem5 O3PipeView ticks, one cycle = 1000 ticks (o3-pipeview.py default)
+#define PIPE_TRACE_TICKS_PER_CYCLE 1000
+
+#define PIPE_TRACE_MAGIC "APEXPIPE"
+#define PIPE_TRACE_VERSION 1
+#define PIPE_TRACE_NOT_REACHED 0xFFFFFFFFu
+
+// Stage cycles of one dynamic instruction while it is in the window
+struct PipeRecord {
+    bool active;
+    uint64_t seq;
+    uint32_t pc;
+    InstructionType type;
+    char disasm[32];
+    uint64_t fetch;
+    uint64_t decode;          // 0 for stages not reached, as issue and complete
+    uint64_t dispatch;        // Rename and dispatch share Decode 2
+    uint64_t issue;
+    uint64_t complete;
+};
+
+// Binary trace record, host byte order, written after a 16 byte header
+// (8 byte magic, uint32 version, uint32 record size). Stage cycles are
+// offsets from fetch, PIPE_TRACE_NOT_REACHED when the stage was skipped.
+struct PipeBinaryRecord {
+    uint64_t seq;
+    uint32_t pc;
+    uint8_t type;
+    uint8_t squashed;
+    uint16_t reserved;
+    uint64_t fetch;
+    uint32_t decode;
+    uint32_t rename;
+    uint32_t dispatch;
+    uint32_t issue;
+    uint32_t complete;
+    uint32_t retire;          // Squash cycle when squashed is set
+};
+
+// Streams one record per instruction as it retires or is squashed, so
+// memory use is bounded by the ROB size whatever the run length.
+// Instructions are traced when fetched inside [from, to).
+class PipeTrace {
+private:
+    std::vector<PipeRecord> inflight;   // Indexed by ROB entry
+    FILE* text_file;
+    FILE* binary_file;
+    uint64_t from_cycle;
+    uint64_t to_cycle;                  // 0 = no upper bound
+    uint64_t records;
+
+    void write_record(const PipeRecord& rec, uint64_t end_cycle, bool squashed);
+
+public:
+    PipeTrace(int rob_size);
+    ~PipeTrace();
+
+    bool open(const char* text_path, const char* binary_path, uint64_t from, uint64_t to);
+    void close();
+    bool is_enabled() const { return text_file || binary_file; }
+    uint64_t get_records() const { return records; }
+
+    // Stage events, ignored for instructions outside the window
+    void on_dispatch(int rob_idx, uint64_t seq, uint32_t pc, const APEX_Instruction& insn,
+                     uint64_t fetch, uint64_t decode, uint64_t cycle);
+    void on_issue(int rob_idx, uint64_t cycle) {
+        if (inflight[rob_idx].active) inflight[rob_idx].issue = cycle;
+    }
+    void on_complete(int rob_idx, uint64_t cycle) {
+        if (inflight[rob_idx].active) inflight[rob_idx].complete = cycle;
+    }
+    void on_retire(int rob_idx, uint64_t cycle);
+    void on_squash(int rob_idx, uint64_t cycle);
+    // Wrong-path instruction flushed from the front end, never dispatched;
+    // decode is 0 while it was still in the fetch latch
+    void on_frontend_squash(uint64_t seq, uint32_t pc, const APEX_Instruction& insn,
+                            uint64_t fetch, uint64_t decode, uint64_t cycle);
+
+    static void format_instruction(const APEX_Instruction& insn, char* buffer, size_t size);
+};
+
+#endif
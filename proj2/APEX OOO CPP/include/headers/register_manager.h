@@ -2,7 +2,7 @@
 #define _REGISTER_MANAGER_H_
 
 #include "apex_cpu_types.h"
-#include <queue>
+#include "free_list.h"
 #include <vector>  // Add this for std::vector
 #include <stdint.h>
 #include <stdio.h>
@@ -15,11 +15,12 @@ struct RenameTableEntry {
 struct Checkpoint {
     RenameTableEntry arch_to_phys[32];  // Frontend rename table state
     RenameTableEntry cc_to_phys[1];     // CC flag mapping state
-    std::queue<uint32_t> free_list_uprf;  // Free physical register list state
-    std::queue<uint32_t> free_list_ucrf;  // Free CC register list state
-    bool valid_bits[60];                  // UPRF valid bits
-    bool cc_valid_bits[10];               // UCRF valid bits
+    UprfFreeList free_list_uprf;          // Free physical register list state
+    UcrfFreeList free_list_ucrf;          // Free CC register list state
+    std::vector<bool> valid_bits;         // UPRF valid bits
+    std::vector<bool> cc_valid_bits;      // UCRF valid bits
     uint32_t control_tag;                 // Tag for this checkpoint
+    bool valid;                           // Slot holds a live checkpoint
 };
 
 class RegisterManager {
@@ -31,18 +32,19 @@ private:
     RenameTableEntry backend_cc_rat[1];  // Backend RAT for CC
 
     // Free Lists
-    std::queue<uint32_t> free_list_uprf;  // Free list for physical registers
-    std::queue<uint32_t> free_list_ucrf;  // Free list for CC registers
+    UprfFreeList free_list_uprf;  // Free list for physical registers
+    UcrfFreeList free_list_ucrf;  // Free list for CC registers
 
     // Valid Bits
-    bool uprf_valid[60];   // Valid bits for physical registers
-    bool ucrf_valid[10];   // Valid bits for CC registers
+    std::vector<bool> uprf_valid;   // Valid bits for physical registers
+    std::vector<bool> ucrf_valid;   // Valid bits for CC registers
+    int max_checkpoints;            // Unresolved control instructions allowed
 
     // Checkpoint Management
     std::vector<Checkpoint> checkpoints;
 
 public:
-    RegisterManager();
+    RegisterManager(int uprf_size = 60, int ucrf_size = 10, int checkpoint_limit = 8);
     ~RegisterManager();
 
     // Core Functions
@@ -59,12 +61,17 @@ public:
     int create_checkpoint(uint32_t control_tag);
     void restore_checkpoint(int checkpoint_id);
     void free_checkpoint(int checkpoint_id);
+    bool is_checkpoint_available();
+    int get_checkpoint_count();
 
     // Utility Functions
     bool is_register_available();
     bool is_cc_available();
+    int get_free_register_count() const { return free_list_uprf.size(); }
+    int get_free_cc_count() const { return free_list_ucrf.size(); }
     uint32_t get_physical_register(uint32_t arch_reg);
     uint32_t get_cc_register();
+    uint32_t get_backend_register(uint32_t arch_reg) const { return backend_rat[arch_reg].phys_reg; }
     void display_status();
 
     // Testing Functions (optional)
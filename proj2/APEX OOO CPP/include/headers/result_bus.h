@@ -0,0 +1,58 @@
+// include/headers/result_bus.h
+#ifndef _RESULT_BUS_H_
+#define _RESULT_BUS_H_
+
+#include "apex_cpu_types.h"
+#include <stdint.h>
+#include <vector>
+
+// Consumers of forwarded results (IQ, LSQ, FUs, register files)
+class ResultBusListener {
+public:
+    virtual ~ResultBusListener() {}
+
+    // Phase 1: the tag goes out one cycle before the value
+    virtual void on_tag_broadcast(uint32_t tag, bool is_cc) { (void)tag; (void)is_cc; }
+
+    // Phase 2: the value follows on the next cycle
+    virtual void on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) = 0;
+};
+
+// Result of one instruction travelling over the bus
+struct BusResult {
+    uint32_t rob_index;
+    uint64_t seq;             // Program order, detects squashed producers
+    uint32_t dest_tag;        // UPRF destination (REG_NONE if none)
+    uint32_t value;
+    uint32_t cc_tag;          // UCRF destination (REG_NONE if none)
+    uint8_t cc_flags;
+    bool mispredicted;
+};
+
+// Forwarding network with a fixed number of writeback ports. A result
+// uses one port for its tag broadcast and the same port for its value
+// broadcast on the following cycle.
+class ResultBus {
+private:
+    int num_ports;
+    std::vector<ResultBusListener*> listeners;
+    std::vector<BusResult> pending;     // Waiting for a free port
+    std::vector<BusResult> tag_stage;   // Tag sent, value goes out next cycle
+
+public:
+    ResultBus(int ports);
+
+    // Core Functions
+    void subscribe(ResultBusListener* listener);
+    void request(const BusResult& result);
+    void broadcast_tags();                       // Phase 1, oldest results first
+    std::vector<BusResult> broadcast_values();   // Phase 2, returns delivered results
+    void flush(uint64_t seq);                    // Drop results younger than seq
+
+    // Utility Functions
+    int get_ports() const { return num_ports; }
+    int get_pending_count() const { return (int)pending.size(); }
+    void display_status();
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define _ROB_H_
 
 #include "apex_cpu_types.h"
+#include "core_variants.h"
 #include <stdint.h>
 
 struct ROB_Entry {
@@ -14,25 +15,42 @@ struct ROB_Entry {
     uint32_t value;
     bool exception;
     bool mispredicted;
+    bool taken;               // Resolved direction of a control instruction
     uint32_t target_addr;
     uint32_t control_tag;
+    uint32_t dest_cc_reg;     // Destination CC physical register
+    uint32_t old_cc_reg;      // Previous CC mapping (for rollback)
+    int lsq_index;            // LSQ slot of memory instructions
+    int checkpoint_id;        // Rename checkpoint of control instructions
+    uint32_t predicted_npc;   // Next PC chosen by fetch
+    uint64_t seq;             // Dynamic instruction number, 0 when free
 
     ROB_Entry() {
         completed = false;
         exception = false;
         mispredicted = false;
+        taken = false;
+        dest_cc_reg = REG_NONE;
+        old_cc_reg = REG_NONE;
+        lsq_index = -1;
+        checkpoint_id = -1;
+        predicted_npc = 0;
+        seq = 0;
     }
 };
 
-class ROB {
+// Circular reorder buffer, capacity policy from capacity.h
+template <class Capacity>
+class ROB_T {
 private:
-    ROB_Entry entries[80];
+    Capacity capacity;
+    typename Capacity::template Storage<ROB_Entry>::type entries;
     int head;
     int tail;
     int count;
 
 public:
-    ROB();
+    ROB_T(int rob_size = 80);
     
     int add_entry(uint32_t pc, InstructionType type, 
                  uint32_t dest_arch_reg, uint32_t dest_phys_reg,
@@ -48,7 +66,12 @@ public:
     int get_head() { return head; }
     int get_tail() { return tail; }
     int get_count() { return count; }
+    int get_size() { return capacity.size(); }
+    int next_index(int index) const { return capacity.next(index); }
+    int get_age(int index) const { return capacity.wrap(index - head + capacity.size()); }  // 0 at head
     void display_status();
 };
 
+typedef ROB_T<CoreVariant::RobCapacity> ROB;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+// include/headers/sampled_sim.h
+#ifndef _SAMPLED_SIM_H_
+#define _SAMPLED_SIM_H_
+
+#include "functional_core.h"
+#include "functional_warmer.h"
+#include "sim_config.h"
+#include "simpoint.h"
+#include "stats_registry.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Detailed result of one sample, counters are deltas over the measured
+// interval only
+struct SampleResult {
+    SimPointChoice choice;
+    uint64_t start;           // First measured instruction
+    uint64_t warmup;          // Instructions simulated before start
+    uint64_t insns;
+    uint64_t cycles;
+    std::vector<StatValue> deltas;
+};
+
+// Sampled simulation from checkpoints: one functional pass saves the
+// architectural state at the start of every sample's warm-up, then each
+// sample is simulated in detail on its own host thread (a fresh APEX_CPU
+// per sample, so nothing is shared) and the results merged by weight.
+// With functional warming the fast-forward also trains the predictor and
+// D-cache, copied into each sample's core; the detailed warm-up then only
+// has to refill the window.
+class SampledSim {
+private:
+    const std::vector<APEX_Instruction>& code;
+    SimConfig config;
+    uint64_t interval_size;
+    uint64_t warmup;
+    std::vector<SimPointChoice> samples;
+    std::vector<ArchCheckpoint> checkpoints;   // Parallel to samples
+    std::vector<FunctionalWarmer> warm_states; // Parallel to samples when warming
+    uint64_t functional_warming;  // Instructions warmed before each checkpoint
+    double capture_seconds;   // Functional pass wall time
+    std::vector<SampleResult> results;
+    int threads;
+    double host_seconds;      // Detailed phase wall time
+
+    void simulate(size_t index);
+
+public:
+    SampledSim(const std::vector<APEX_Instruction>& program, const SimConfig& sim_config,
+               uint64_t interval_insns, uint64_t warmup_insns);
+
+    // Last insns of the fast-forward before each checkpoint run with
+    // functional warming, 0 = none; call before capture
+    void set_functional_warming(uint64_t insns) { functional_warming = insns; }
+    // Functional pass, false if the program ends before any sample
+    bool capture(const std::vector<SimPointChoice>& points, const char* data_file);
+    void run(int jobs);       // jobs <= 0 uses every hardware thread
+
+    double get_cpi() const;   // Weighted over the simulated samples
+    const std::vector<SampleResult>& get_results() const { return results; }
+    void print(FILE* out) const;
+    bool write_csv(const char* path) const;  // --intervals layout for apex_simpoint --combine
+};
+
+#endif
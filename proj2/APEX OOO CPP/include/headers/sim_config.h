@@ -0,0 +1,51 @@
+// include/headers/sim_config.h
+#ifndef _SIM_CONFIG_H_
+#define _SIM_CONFIG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Microarchitecture parameters of the OOO core. Defaults match the
+// APEX design document; every field can be set from a key=value or
+// flat JSON file and overridden on the command line.
+struct SimConfig {
+    // Pipeline widths
+    int fetch_width;      // Instructions fetched per cycle
+    int rename_width;     // Instructions renamed/dispatched per cycle
+    int issue_width;      // Instructions issued from the IQ per cycle
+    int commit_width;     // Instructions retired per cycle
+
+    // Function units
+    int int_fus;          // Number of Integer FUs
+    int mul_stages;       // Multiply FU pipeline depth
+    int mem_stages;       // Memory FU pipeline depth
+    int wb_ports;         // Results broadcast on the result bus per cycle
+
+    // Structure sizes
+    int rob_size;
+    int iq_size;
+    int lsq_size;
+    int uprf_size;        // Physical integer registers (>= 33)
+    int ucrf_size;        // Physical CC registers (>= 2)
+    int checkpoints;      // Unresolved control instructions in flight
+    int predictor_size;   // Control predictor entries
+    int ras_size;         // Return address stack entries
+    int memory_size;      // Data memory words
+
+    // L1 data cache, dcache_sets = 0 leaves memory at the fixed mem_stages latency
+    int dcache_sets;
+    int dcache_ways;
+    int dcache_line;      // Words per line
+    int dcache_miss_penalty;  // Extra cycles per miss
+
+    SimConfig();
+
+    // Returns false on an unknown key or malformed value
+    bool set(const char* key, const char* value);
+    bool set(const char* assignment);           // "key=value"
+    bool load_file(const char* filename);       // key=value lines or flat JSON
+    bool validate() const;                      // Prints every violated limit
+    void print(FILE* out = stdout) const;
+};
+
+#endif
@@ -0,0 +1,128 @@
+// include/headers/sim_server.h
+#ifndef _SIM_SERVER_H_
+#define _SIM_SERVER_H_
+
+#include "functional_core.h"
+#include "sim_config.h"
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum JobState {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
+    JOB_CANCELLED,
+    JOB_FAILED
+};
+
+// One detailed simulation submitted by a client
+struct SimJob {
+    uint64_t id;
+    int priority;             // Higher runs first, FIFO within a priority
+    std::string program;
+    std::string data;         // Empty = zeroed memory
+    std::vector<std::string> overrides;  // key=value over the server's base config
+    uint64_t max_cycles;      // 0 = no limit
+    uint64_t max_insns;
+    uint64_t skip;            // Functional fast-forward before the detailed run
+    JobState state;
+    std::atomic<bool> cancel;
+    std::string error;
+    // Results, written under the server lock
+    std::string stats_json;   // StatsRegistry::dump_json of the finished run
+    uint64_t cycles;
+    uint64_t committed;
+    bool halted;
+    double host_seconds;
+};
+
+/*
+ * Long-running simulation daemon on a Unix domain socket. Each connection
+ * carries one request line and gets one JSON reply:
+ *   submit <program> [data] [--cycles=N] [--insns=N] [--skip=N]
+ *          [--priority=P] [--key=value ...]
+ *   status <id> | result <id> (waits for the end) | cancel <id>
+ *   list | cache | shutdown
+ * Parsed programs, memory images and fast-forwarded checkpoints stay
+ * resident between jobs, and jobs run on a pool of worker threads. A
+ * finished job is dropped once its result is fetched, or when more than
+ * keep_jobs finished jobs are waiting. Cached programs and checkpoints are
+ * tied to the device, inode, mtime and size of their files, so an edited
+ * file is read again, and each cache keeps its most recently used entries.
+ */
+class SimServer {
+private:
+    SimConfig base;
+    std::string socket_path;
+    int listen_fd;
+    int workers;
+
+    std::mutex lock;
+    std::condition_variable work_ready;
+    std::condition_variable job_finished;
+    std::map<uint64_t, std::shared_ptr<SimJob> > jobs;
+    std::vector<std::shared_ptr<SimJob> > queue;
+    uint64_t next_id;
+    bool stopping;
+    int clients;              // Connections being served
+
+    std::deque<uint64_t> finished;     // Finished job ids, oldest first
+    int keep_jobs;
+
+    // Keyed by path, valid while the file's stamp is unchanged
+    struct CachedProgram {
+        std::shared_ptr<const std::vector<APEX_Instruction> > code;
+        std::string stamp;
+        uint64_t last_use;
+    };
+    // Keyed by the stamps of the program and data files, memory and skip
+    struct CachedCheckpoint {
+        std::shared_ptr<const ArchCheckpoint> checkpoint;
+        uint64_t last_use;
+    };
+    std::map<std::string, CachedProgram> programs;
+    std::map<std::string, CachedCheckpoint> checkpoints;
+    int program_limit;
+    int checkpoint_limit;
+    uint64_t cache_clock;
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    uint64_t cache_reloads;    // Misses on a path whose file changed
+    uint64_t cache_evictions;
+
+    // Sets stamp to the program's file stamp at the time it was parsed
+    std::shared_ptr<const std::vector<APEX_Instruction> > get_program(const std::string& path,
+                                                                     std::string& stamp);
+    std::shared_ptr<const ArchCheckpoint> get_checkpoint(
+        const std::vector<APEX_Instruction>& code, const std::string& program_stamp,
+        const SimJob& job, int memory_words);
+    std::shared_ptr<SimJob> next_job();
+    void run_job(SimJob& job);
+    void worker_loop();
+    void serve(int fd);
+    std::string handle(const std::string& request);
+    std::string job_json(const SimJob& job, bool with_stats) const;
+    void finish_job(SimJob& job);  // Caller holds lock
+
+public:
+    SimServer(const SimConfig& base_config, const char* path, int worker_threads);
+    ~SimServer();
+
+    void set_limits(int finished_jobs, int cached_programs, int cached_checkpoints);
+    bool start();             // Binds the socket
+    void run();               // Accepts connections until a shutdown request
+};
+
+// Sends one request line to a running server and returns the reply, false
+// when the server cannot be reached
+bool send_server_request(const char* path, const std::string& request, std::string& reply);
+
+#endif
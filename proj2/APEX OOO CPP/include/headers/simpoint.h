@@ -0,0 +1,63 @@
+// include/headers/simpoint.h
+#ifndef _SIMPOINT_H_
+#define _SIMPOINT_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+// Representative interval of one phase; weight is the phase's share of
+// all executed instructions
+struct SimPointChoice {
+    uint64_t interval;
+    int cluster;
+    double weight;
+};
+
+// SimPoint-style phase selection (Sherwood et al.): basic-block vectors are
+// normalised, randomly projected to a few dimensions and clustered with
+// k-means for every k up to max_k. The smallest k whose BIC reaches 90% of
+// the best score wins, and the interval nearest each centroid represents
+// its cluster.
+class SimPoint {
+private:
+    int dims;
+    uint64_t seed;
+    std::vector<std::vector<std::pair<int, double> > > vectors;  // Sparse BBVs
+    std::vector<uint64_t> lengths;                                // Instructions per interval
+    std::vector<std::vector<double> > points;                     // Projected
+    std::vector<int> assignment;
+    std::vector<SimPointChoice> choices;
+
+    void project();
+    double kmeans(int k, uint64_t run_seed, std::vector<int>& assign,
+                  std::vector<std::vector<double> >& centroids) const;
+    double bic(int k, const std::vector<int>& assign, double sse) const;
+
+public:
+    SimPoint(int projected_dims = 15, uint64_t random_seed = 1);
+
+    bool load_bbv(const char* path);
+    int get_intervals() const { return (int)vectors.size(); }
+
+    // Clusters with k fixed, or the BIC choice up to max_k when fixed_k is 0.
+    // Returns the number of clusters.
+    int cluster(int max_k, int fixed_k, bool verbose);
+    const std::vector<SimPointChoice>& get_choices() const { return choices; }
+
+    // SimPoint 3 text formats: "<interval> <cluster>" and "<weight> <cluster>"
+    bool write(const char* simpoints_path, const char* weights_path) const;
+};
+
+// Without a weights file (NULL) every point gets the same weight
+bool read_simpoints(const char* simpoints_path, const char* weights_path,
+                    std::vector<SimPointChoice>& choices);
+
+// Weighted whole-program estimate from per-interval stats in the
+// --intervals CSV layout (an "interval" column plus cpu.cycles and
+// cpu.committed). Every counter is reported per thousand instructions.
+bool combine_interval_stats(const char* csv_path, const std::vector<SimPointChoice>& choices,
+                            FILE* out);
+
+#endif
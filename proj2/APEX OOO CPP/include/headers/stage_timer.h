@@ -0,0 +1,80 @@
+// include/headers/stage_timer.h
+#ifndef _STAGE_TIMER_H_
+#define _STAGE_TIMER_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+
+class StatsRegistry;
+
+// Host-side timers are compiled in unless -DAPEX_STAGE_TIMERS=0, and are
+// switched on at run time with --stage-timers
+#ifndef APEX_STAGE_TIMERS
+#define APEX_STAGE_TIMERS 1
+#endif
+
+// Work done by APEX_CPU::single_step, in the order it runs
+enum TimedStage {
+    TIMED_COMMIT,
+    TIMED_WRITEBACK,
+    TIMED_EXECUTE,
+    TIMED_ISSUE,
+    TIMED_DISPATCH,
+    TIMED_DECODE,
+    TIMED_FETCH,
+    TIMED_STATS,              // CPI stack and occupancy sampling
+    TIMED_STAGE_COUNT
+};
+
+// Accumulated host nanoseconds per stage
+class StageTimers {
+private:
+    uint64_t total_ns[TIMED_STAGE_COUNT];
+    bool enabled;
+
+public:
+    StageTimers();
+
+    static uint64_t now_ns() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    void set_enabled(bool on) { enabled = on; }
+    bool is_enabled() const { return enabled; }
+    void add(TimedStage stage, uint64_t ns) { total_ns[stage] += ns; }
+    uint64_t get_ns(TimedStage stage) const { return total_ns[stage]; }
+    static const char* get_name(TimedStage stage);
+    void print(uint64_t cycles, uint64_t instructions) const;
+    void register_stats(StatsRegistry& stats, const std::string& prefix) const;
+};
+
+// Charges the lifetime of the scope to one stage
+class ScopedStageTimer {
+private:
+    StageTimers& timers;
+    TimedStage stage;
+    uint64_t start;
+
+public:
+    ScopedStageTimer(StageTimers& stage_timers, TimedStage timed_stage)
+        : timers(stage_timers), stage(timed_stage) {
+        start = timers.is_enabled() ? StageTimers::now_ns() : 0;
+    }
+    ~ScopedStageTimer() {
+        if (timers.is_enabled()) {
+            timers.add(stage, StageTimers::now_ns() - start);
+        }
+    }
+};
+
+#if APEX_STAGE_TIMERS
+#define APEX_TIMED_STAGE(timers, stage, call) \
+    do { ScopedStageTimer stage_timer_(timers, stage); call; } while (0)
+#else
+#define APEX_TIMED_STAGE(timers, stage, call) call
+#endif
+
+#endif
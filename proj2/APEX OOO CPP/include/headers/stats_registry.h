@@ -0,0 +1,67 @@
+// include/headers/stats_registry.h
+#ifndef _STATS_REGISTRY_H_
+#define _STATS_REGISTRY_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class OccupancyHistogram;
+
+enum StatKind {
+    STAT_COUNTER,             // uint64_t owned by a component
+    STAT_COUNTER_FN,          // Counter computed on demand, e.g. a sum over a table
+    STAT_VECTOR,              // Array of counters with one label each
+    STAT_HISTOGRAM,           // OccupancyHistogram summary
+    STAT_FORMULA              // Derived value such as IPC or MPKI
+};
+
+// One named value after flattening, vectors and histograms expand to
+// name.label. Counters can be subtracted between two snapshots.
+struct StatValue {
+    std::string name;
+    double value;
+    bool is_counter;
+    const char* desc;         // Valid while the registry is unchanged
+};
+
+// Components register pointers to the counters they already keep, so
+// registration costs nothing per cycle. Values are read only when the
+// registry is dumped.
+class StatsRegistry {
+private:
+    struct Entry {
+        std::string name;
+        std::string desc;
+        StatKind kind;
+        const uint64_t* counter;
+        int length;
+        const char* const* labels;
+        const OccupancyHistogram* histogram;
+        std::function<double()> fn;
+    };
+    std::vector<Entry> entries;
+
+    Entry& add(const std::string& name, const char* desc, StatKind kind);
+
+public:
+    void add_counter(const std::string& name, const char* desc, const uint64_t* counter);
+    void add_counter(const std::string& name, const char* desc, std::function<uint64_t()> fn);
+    void add_vector(const std::string& name, const char* desc, const uint64_t* values,
+                    int length, const char* const* labels);
+    void add_histogram(const std::string& name, const char* desc,
+                       const OccupancyHistogram* histogram);
+    void add_formula(const std::string& name, const char* desc, std::function<double()> fn);
+
+    // Reads every statistic in registration order
+    void collect(std::vector<StatValue>& values) const;
+    int get_count() const { return (int)entries.size(); }
+
+    void dump_json(FILE* out) const;
+    void dump_csv(FILE* out) const;
+    bool dump_file(const char* filename) const;  // Format from the extension, .csv or JSON
+};
+
+#endif
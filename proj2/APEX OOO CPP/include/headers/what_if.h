@@ -0,0 +1,55 @@
+// include/headers/what_if.h
+#ifndef _WHAT_IF_H_
+#define _WHAT_IF_H_
+
+#include "sim_config.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+class APEX_CPU;
+
+// Outcome of one variant, counted from the start of the run
+struct WhatIfResult {
+    std::string spec;         // "key=value,..." as given, empty = unchanged
+    bool ok;
+    std::string error;
+    uint64_t cycles;
+    uint64_t committed;
+    bool halted;
+    double mpki;
+    double host_seconds;      // Child run time after the fork
+};
+
+/*
+ * Copy-on-write what-if: the detailed core runs once up to the fork cycle,
+ * then fork() gives every variant its own copy of the warmed-up state
+ * (caches, predictor, in-flight window) without saving or restoring it.
+ * Each child applies its overrides, runs to HALT or the cycle limit and
+ * reports over a pipe. Only fields APEX_CPU::reconfigure accepts can
+ * change, the structures are already sized.
+ */
+class WhatIfFork {
+private:
+    SimConfig base;
+    uint64_t fork_cycle;
+    uint64_t max_cycles;      // 0 = run every child to HALT
+    std::vector<std::string> specs;
+    std::vector<WhatIfResult> results;
+    uint64_t fork_committed;  // Committed when the core forked
+    double prefix_seconds;    // Shared run up to the fork
+
+    // False, with an error record, when the variant cannot be applied
+    bool run_child(APEX_CPU& cpu, const std::string& spec, int fd);
+
+public:
+    WhatIfFork(const SimConfig& base_config, uint64_t at_cycle, uint64_t cycle_limit);
+
+    void add_variant(const char* spec) { specs.push_back(spec); }
+    bool run(APEX_CPU& cpu);  // False if the core halts first or any variant failed
+    const std::vector<WhatIfResult>& get_results() const { return results; }
+    void print(FILE* out) const;
+};
+
+#endif
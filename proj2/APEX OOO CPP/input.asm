@@ -0,0 +1,16 @@
+MOVC R0,#0
+MOVC R1,#0
+MOVC R2,#8
+MOVC R3,#0
+LOAD R4,R1,#0
+ADD R3,R3,R4
+ADDL R1,R1,#1
+SUBL R2,R2,#1
+BNZ #-16
+STORE R3,R0,#100
+MUL R5,R3,R3
+JALP R6,#12
+STORE R5,R0,#101
+HALT
+ADDL R7,R7,#1
+RET R6
@@ -1,35 +1,805 @@
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include "apex_cpu.h"
+#include "apex_log.h"
 
-APEX_CPU::APEX_CPU()
-    : mem_fu(lsq)  // Initialize mem_fu with reference to lsq
-    , int_fu(predictor)
+// Fixed core variants override the sizes they were compiled with
+static SimConfig variant_config(SimConfig config) {
+    CoreVariant::apply(config);
+    return config;
+}
+
+APEX_CPU::APEX_CPU(const SimConfig& sim_config)
+    : config(variant_config(sim_config))
+    , rob(config.rob_size)
+    , reg_mgr(config.uprf_size, config.ucrf_size, config.checkpoints)
+    , predictor(config.predictor_size, config.ras_size)
+    , lsq(config.lsq_size)
+    , mem_fu(lsq, config.mem_stages, config.memory_size,  // Initialize mem_fu with reference to lsq
+             config.dcache_sets, config.dcache_ways, config.dcache_line, config.dcache_miss_penalty)
+    , mul_fu(config.mul_stages)
+    , iq(config.iq_size)
+    , uprf(config.uprf_size, false)
+    , ucrf(config.ucrf_size, true)
+    , result_bus(config.wb_ports)
+    , cpi_stack(config.commit_width)
+    , rob_occupancy("rob", config.rob_size)
+    , lsq_occupancy("lsq", config.lsq_size)
+    , iq_occupancy("iq", config.iq_size)
+    , uprf_occupancy("uprf", config.uprf_size - 32)
+    , ucrf_occupancy("ucrf", config.ucrf_size - 1)
+    , checkpoint_occupancy("checkpoints", config.checkpoints)
+    , mem_profile(config.mem_stages)
+    , pipe_trace(config.rob_size)
+    , critical_path(config.rob_size, config.uprf_size, config.ucrf_size)
 {
     cycle = 0;
+    insn_committed = 0;
+    next_seq = 1;
+    branch_mispredicts = 0;
     halt = false;
+    pc = CODE_BASE_ADDRESS;
+    fetch_stopped = false;
+    committed_this_cycle = 0;
+    head_stall = STALL_NONE;
+    dispatch_stall = STALL_NONE;
+    mispredict_recovery = false;
+    branch_report_size = 10;
+
+    int_fus.reserve(config.int_fus);
+    for (int i = 0; i < config.int_fus; i++) {
+        int_fus.push_back(IntegerFU(predictor));
+    }
+
+    // Register files first so consumers reading them see the new value
+    result_bus.subscribe(&uprf);
+    result_bus.subscribe(&ucrf);
+    result_bus.subscribe(&iq);
+    result_bus.subscribe(&lsq);
+    result_bus.subscribe(&mul_fu);
+    for (size_t i = 0; i < int_fus.size(); i++) {
+        result_bus.subscribe(&int_fus[i]);
+    }
+
+    register_stats();
+}
+
+void APEX_CPU::register_stats() {
+    stats.add_counter("cpu.cycles", "Simulated cycles", &cycle);
+    stats.add_counter("cpu.committed", "Committed instructions", &insn_committed);
+    stats.add_counter("cpu.branch_mispredicts", "Retired control instructions that mispredicted",
+                      &branch_mispredicts);
+    stats.add_formula("cpu.ipc", "committed / cycles", [this]() {
+        return cycle ? (double)insn_committed / cycle : 0.0;
+    });
+    stats.add_formula("cpu.cpi", "cycles / committed", [this]() {
+        return insn_committed ? (double)cycle / insn_committed : 0.0;
+    });
+    stats.add_formula("cpu.mpki", "Mispredicts per thousand committed instructions", [this]() {
+        return insn_committed ? 1000.0 * branch_mispredicts / insn_committed : 0.0;
+    });
+
+    cpi_stack.register_stats(stats, "cpu.cpi_stack");
+    predictor.register_stats(stats, "predictor");
+    stats.add_histogram("rob.occupancy", "ROB entries in use", &rob_occupancy);
+    stats.add_histogram("lsq.occupancy", "LSQ entries in use", &lsq_occupancy);
+    stats.add_histogram("iq.occupancy", "IQ entries in use", &iq_occupancy);
+    stats.add_histogram("uprf.occupancy", "Renamed registers off the free list", &uprf_occupancy);
+    stats.add_histogram("ucrf.occupancy", "Renamed CC registers off the free list", &ucrf_occupancy);
+    stats.add_histogram("checkpoints.occupancy", "Live rename checkpoints", &checkpoint_occupancy);
+    mem_profile.register_stats(stats);
+    if (mem_fu.get_cache().is_enabled()) {
+        mem_fu.get_cache().register_stats(stats, "dcache");
+    }
+    critical_path.register_stats(stats, "critical_path");
+    stage_timers.register_stats(stats, "host");
+
+    interval_stats.add_rate("ipc", "cpu.committed", "cpu.cycles");
+    interval_stats.add_rate("mpki", "cpu.branch_mispredicts", "cpu.committed", 1000.0);
+    interval_stats.add_rate("btb_miss_rate", "predictor.btb_misses", "predictor.lookups");
+    interval_stats.add_rate("load_latency.mean", "lsq.load.latency.sum",
+                            "lsq.load.latency.samples");
+    interval_stats.add_rate("mlp", "memfu.outstanding.sum", "memfu.active_cycles");
+    const char* structures[] = { "rob", "lsq", "iq", "uprf", "ucrf", "checkpoints" };
+    for (int i = 0; i < 6; i++) {
+        std::string prefix = std::string(structures[i]) + ".occupancy";
+        interval_stats.add_rate((prefix + ".mean").c_str(), (prefix + ".sum").c_str(),
+                                (prefix + ".samples").c_str());
+    }
 }
 
 APEX_CPU::~APEX_CPU() {
     // Cleanup
 }
 
-void APEX_CPU::initialize() {
-    // Initialize components
+void APEX_CPU::load_warm_state(const ControlPredictor& trained, const DataCache& cache) {
+    predictor.copy_state(trained);
+    mem_fu.get_cache().copy_state(cache);
+}
+
+bool APEX_CPU::reconfigure(const SimConfig& next) {
+    SimConfig sized = next;  // Runtime fields copied back, the rest must match
+    sized.fetch_width = config.fetch_width;
+    sized.rename_width = config.rename_width;
+    sized.issue_width = config.issue_width;
+    sized.commit_width = config.commit_width;
+    sized.dcache_miss_penalty = config.dcache_miss_penalty;
+    if (memcmp(&sized, &config, sizeof(SimConfig)) != 0) {
+        return false;
+    }
+    config = next;
+    cpi_stack.set_width(config.commit_width);
+    mem_fu.get_cache().set_miss_penalty(config.dcache_miss_penalty);
+    return true;
+}
+
+bool APEX_CPU::initialize(const char* filename, const char* data_filename) {
+    if (!create_code_memory(filename, code_memory)) {
+        printf("APEX_CPU: Unable to load program %s\n", filename);
+        return false;
+    }
+    printf("APEX_CPU: Loaded %d instructions from %s\n", (int)code_memory.size(), filename);
+
+    if (data_filename) {
+        int words = mem_fu.load_data(data_filename);
+        if (words < 0) {
+            return false;
+        }
+        printf("APEX_CPU: Loaded %d data words from %s\n", words, data_filename);
+    }
+    return true;
+}
+
+// The rename tables still hold the reset mapping, so the backend register
+// of each architectural register is the one to fill
+void APEX_CPU::load_checkpoint(const std::vector<APEX_Instruction>& program,
+                               const ArchCheckpoint& checkpoint) {
+    code_memory = program;
+    pc = checkpoint.pc;
+    for (uint32_t i = 0; i < 32; i++) {
+        uprf.write(reg_mgr.get_backend_register(i), checkpoint.regs[i]);
+    }
+    ucrf.write(reg_mgr.get_cc_register(), checkpoint.cc);
+    mem_fu.load_image(checkpoint.memory);
+    fetch_stopped = checkpoint.halted;
+    halt = checkpoint.halted;
+}
+
+bool APEX_CPU::enable_trace(const char* text_path, const char* binary_path,
+                            uint64_t from_cycle, uint64_t to_cycle) {
+    return pipe_trace.open(text_path, binary_path, from_cycle, to_cycle);
 }
 
-void APEX_CPU::run_cpu() {
-    while (!halt) {
+void APEX_CPU::run_cpu(uint64_t max_cycles) {
+    while (!halt && (max_cycles == 0 || cycle < max_cycles)) {
+        single_step();
+    }
+    uint64_t traced = pipe_trace.get_records();
+    bool tracing = pipe_trace.is_enabled();
+    pipe_trace.close();
+    critical_path.finish();
+    bool intervals = interval_stats.is_enabled();
+    interval_stats.close(cycle, insn_committed);
+    Logger::flush();
+    if (tracing) {
+        printf("APEX_CPU: Pipeline trace records = %lu\n", (unsigned long)traced);
+    }
+    if (intervals) {
+        printf("APEX_CPU: Interval stats rows = %lu\n",
+               (unsigned long)interval_stats.get_intervals());
+    }
+    if (!halt) {
+        printf("APEX_CPU: Simulation Stopped after %lu cycles\n", (unsigned long)cycle);
+    }
+    print_stats();
+}
+
+void APEX_CPU::run_until(uint64_t committed) {
+    while (!halt && insn_committed < committed) {
         single_step();
     }
 }
 
 void APEX_CPU::single_step() {
-    // Will implement pipeline stages here
+    // Stages run back to front so each one sees last cycle's latches
+    lsq.set_cycle(cycle);
+    APEX_TIMED_STAGE(stage_timers, TIMED_COMMIT, commit());
+    head_stall = classify_head();
+    dispatch_stall = STALL_NONE;
+    if (!halt) {
+        APEX_TIMED_STAGE(stage_timers, TIMED_WRITEBACK, writeback());
+        APEX_TIMED_STAGE(stage_timers, TIMED_EXECUTE, execute());
+        APEX_TIMED_STAGE(stage_timers, TIMED_ISSUE, issue());
+        APEX_TIMED_STAGE(stage_timers, TIMED_DISPATCH, dispatch());
+        APEX_TIMED_STAGE(stage_timers, TIMED_DECODE, decode());
+        APEX_TIMED_STAGE(stage_timers, TIMED_FETCH, fetch());
+    }
+    APEX_TIMED_STAGE(stage_timers, TIMED_STATS, {
+        cpi_stack.record_cycle(committed_this_cycle, classify_stall());
+        sample_occupancy();
+    });
     cycle++;
+    interval_stats.sample(cycle, insn_committed);
+}
+
+/*
+ * Commit: retire completed instructions from the ROB head in order
+ */
+void APEX_CPU::commit() {
+    committed_this_cycle = 0;
+    for (int n = 0; n < CoreVariant::commit_width(config) && rob.get_count() > 0; n++) {
+        ROB_Entry* entry = rob.get_entry(rob.get_head());
+        if (!entry->completed) {
+            break;
+        }
+
+        // Backend tables now hold the committed mapping, previous one is freed
+        if (entry->dest_phys_reg != REG_NONE) {
+            reg_mgr.update_backend_table(entry->dest_arch_reg, entry->dest_phys_reg);
+        }
+        if (entry->dest_cc_reg != REG_NONE) {
+            reg_mgr.update_backend_cc(entry->dest_cc_reg);
+        }
+        if (entry->lsq_index >= 0) {
+            lsq.remove_entry();
+        }
+        // Wrong-path branches resolve too, so only retired ones train and count
+        if (is_control_op(entry->type)) {
+            predictor.update_prediction(entry->pc, entry->taken, entry->target_addr);
+            predictor.record_resolution(entry->pc, get_predictor_type(entry->type),
+                                        entry->predicted_npc, entry->taken, entry->target_addr);
+            if (entry->mispredicted) {
+                branch_mispredicts++;
+            }
+        }
+
+        bool is_halt = (entry->type == HALT);
+        APEX_DEBUG(LOG_CPU, "Cycle %lu: Commit PC=%u ROB=%d\n", cycle, entry->pc, rob.get_head());
+        pipe_trace.on_retire(rob.get_head(), cycle);
+        critical_path.on_retire(rob.get_head(), cycle);
+        rob.commit_entry();
+        insn_committed++;
+        committed_this_cycle++;
+
+        if (is_halt) {
+            halt = true;
+            break;
+        }
+    }
+}
+
+/*
+ * Writeback: value phase of the result bus. Register files, IQ, LSQ and
+ * FUs capture the values whose tags went out last cycle; the ROB entries
+ * are marked completed
+ */
+void APEX_CPU::writeback() {
+    std::vector<BusResult> delivered = result_bus.broadcast_values();
+    for (size_t i = 0; i < delivered.size(); i++) {
+        const BusResult& result = delivered[i];
+        if (!is_live(result.rob_index, result.seq)) {
+            continue;  // Squashed after it finished executing
+        }
+        rob.write_result(result.rob_index, result.value, result.mispredicted);
+        pipe_trace.on_complete(result.rob_index, cycle);
+        critical_path.on_complete(result.rob_index, cycle);
+    }
+}
+
+/*
+ * Execute: advance every function unit by one cycle, resolve control
+ * instructions oldest first, then broadcast the tags of the new results
+ * so dependents can issue this cycle
+ */
+void APEX_CPU::execute() {
+    MulFUResult mul_result = mul_fu.execute();
+    if (mul_result.valid) {
+        add_writeback(mul_result.rob_index, mul_result.value, true, mul_result.cc_flags, false);
+    }
+
+    MemFUResult mem_result = mem_fu.execute();
+    if (mem_result.valid) {
+        lsq.complete_entry(mem_result.lsq_index);
+        if (!mem_result.is_store) {
+            const LSQ_Entry& load = lsq.get_entry(mem_result.lsq_index);
+            mem_profile.record_load(load.dispatch_cycle, load.address_cycle, load.issue_cycle,
+                                    cycle);
+        }
+        add_writeback(lsq.get_rob_index(mem_result.lsq_index),
+                      mem_result.is_store ? 0 : mem_result.data, false, 0, false);
+    }
+
+    std::vector<std::pair<int, IntFUResult> > int_results;
+    for (size_t i = 0; i < int_fus.size(); i++) {
+        if (int_fus[i].is_busy() && int_fus[i].operands_ready()) {
+            IntFUResult result = int_fus[i].execute();
+            int_results.push_back(std::make_pair((int)int_fus[i].get_rob_index(), result));
+        }
+    }
+
+    // Oldest control instruction must recover first
+    std::sort(int_results.begin(), int_results.end(),
+              [this](const std::pair<int, IntFUResult>& a,
+                     const std::pair<int, IntFUResult>& b) {
+                  return rob.get_age(a.first) < rob.get_age(b.first);
+              });
+
+    for (size_t i = 0; i < int_results.size(); i++) {
+        uint32_t rob_idx = int_results[i].first;
+        const IntFUResult& result = int_results[i].second;
+        ROB_Entry* entry = rob.get_entry(rob_idx);
+        if (entry->seq == 0) {
+            continue;  // Squashed by an older mispredicted branch this cycle
+        }
+
+        bool mispredicted = false;
+        if (is_control_op(entry->type)) {
+            mispredicted = resolve_control(rob_idx, result);
+        }
+        add_writeback(rob_idx, result.value, result.cc_modified, result.cc_flags, mispredicted);
+    }
+
+    result_bus.broadcast_tags();
+}
+
+/*
+ * Issue: send the oldest ready IQ entries to free function units, and the
+ * LSQ head to the Memory FU
+ */
+void APEX_CPU::issue() {
+    for (int n = 0; n < CoreVariant::issue_width(config); n++) {
+        int free_fu = -1;
+        for (size_t i = 0; i < int_fus.size(); i++) {
+            if (int_fus[i].can_accept()) {
+                free_fu = i;
+                break;
+            }
+        }
+
+        int index = iq.select_ready(free_fu != -1, mul_fu.can_accept());
+        if (index == -1) {
+            break;
+        }
+
+        // Sources woken by a tag broadcast are picked up by the FU next cycle
+        const RS_Entry& entry = iq.get_entry(index);
+        uint32_t s1, s2;
+        uint32_t s1_tag = REG_NONE, s2_tag = REG_NONE;
+        bool is_branch = is_conditional_branch(entry.operation);
+        if (is_branch) {
+            s1 = entry.cc_value;
+            s2 = entry.imm;
+            if (entry.cc_pending) s1_tag = entry.cc_tag;
+        } else {
+            s1 = entry.src1_tag != REG_NONE ? entry.src1_value : 0;
+            s2 = entry.src2_tag != REG_NONE ? entry.src2_value : entry.imm;
+            if (entry.src1_pending) s1_tag = entry.src1_tag;
+            if (entry.src2_pending) s2_tag = entry.src2_tag;
+        }
+
+        if (entry.operation == MUL) {
+            mul_fu.issue(entry.pc, s1, s2, entry.rob_index, s1_tag, s2_tag);
+        } else {
+            int_fus[free_fu].issue(entry.pc, entry.operation, s1, s2, entry.rob_index,
+                                   s1_tag, s2_tag, is_branch);
+        }
+        pipe_trace.on_issue(entry.rob_index, cycle);
+        critical_path.on_issue(entry.rob_index, cycle);
+        iq.remove_entry(index);
+    }
+
+    // Memory operations leave the LSQ in program order
+    int head = lsq.get_head();
+    if (!lsq.is_empty() && !lsq.is_issued(head) && mem_fu.can_accept() &&
+        lsq.can_execute(head)) {
+        // Stores only write memory once they are no longer speculative
+        if (!lsq.is_store(head) || (int)lsq.get_rob_index(head) == rob.get_head()) {
+            mem_fu.issue(head);
+            lsq.mark_issued(head);
+            pipe_trace.on_issue(lsq.get_rob_index(head), cycle);
+            critical_path.on_issue(lsq.get_rob_index(head), cycle);
+        }
+    }
+}
+
+/*
+ * Decode 2/Dispatch: rename registers, allocate ROB/IQ/LSQ entries and take
+ * a checkpoint for every control instruction
+ */
+void APEX_CPU::dispatch() {
+    for (int n = 0; n < CoreVariant::rename_width(config) && !decode_latch.empty(); n++) {
+        const FrontendSlot& slot = decode_latch.front();
+        const APEX_Instruction& insn = slot.insn;
+
+        bool has_dest = insn.rd != REG_NONE;
+        bool sets_cc = writes_cc(insn.type);
+        bool is_mem = is_memory_op(insn.type);
+        bool is_control = is_control_op(insn.type);
+        bool needs_iq = !is_mem && insn.type != NOP && insn.type != HALT;
+
+        // Stall in order until every resource is available
+        if (rob.is_full()) {
+            dispatch_stall = STALL_ROB_FULL;
+        } else if (has_dest && !reg_mgr.is_register_available()) {
+            dispatch_stall = STALL_UPRF_EMPTY;
+        } else if (sets_cc && !reg_mgr.is_cc_available()) {
+            dispatch_stall = STALL_UCRF_EMPTY;
+        } else if (is_mem && lsq.is_full()) {
+            dispatch_stall = STALL_LSQ_FULL;
+        } else if (needs_iq && iq.is_full()) {
+            dispatch_stall = STALL_IQ_FULL;
+        } else if (is_control && !reg_mgr.is_checkpoint_available()) {
+            dispatch_stall = STALL_CHECKPOINTS;
+        }
+        if (dispatch_stall != STALL_NONE) {
+            break;
+        }
+        mispredict_recovery = false;  // Correct path has reached the window
+
+        // Read source mappings before the destination is renamed
+        uint32_t src1_tag = reg_mgr.get_physical_register(insn.rs1);
+        uint32_t src2_tag = reg_mgr.get_physical_register(insn.rs2);
+        uint32_t src3_tag = reg_mgr.get_physical_register(insn.rs3);
+        uint32_t cc_tag = is_conditional_branch(insn.type) ? reg_mgr.get_cc_register() : REG_NONE;
+
+        uint32_t dest_phys = REG_NONE, old_phys = REG_NONE;
+        if (has_dest) {
+            old_phys = reg_mgr.get_physical_register(insn.rd);
+            dest_phys = reg_mgr.allocate_physical_register();
+            reg_mgr.update_frontend_table(insn.rd, dest_phys);
+            uprf.allocate(dest_phys);
+        }
+
+        uint32_t dest_cc = REG_NONE, old_cc = REG_NONE;
+        if (sets_cc) {
+            old_cc = reg_mgr.get_cc_register();
+            dest_cc = reg_mgr.allocate_cc_register();
+            reg_mgr.update_frontend_cc(dest_cc);
+            ucrf.allocate(dest_cc);
+        }
+
+        uint64_t seq = next_seq++;
+        int rob_idx = rob.add_entry(slot.pc, insn.type, insn.rd, dest_phys, old_phys, 0);
+        ROB_Entry* entry = rob.get_entry(rob_idx);
+        entry->dest_cc_reg = dest_cc;
+        entry->old_cc_reg = old_cc;
+        entry->predicted_npc = slot.predicted_npc;
+        entry->seq = seq;
+        pipe_trace.on_dispatch(rob_idx, seq, slot.pc, insn, slot.fetch_cycle, slot.decode_cycle, cycle);
+        const uint32_t src_tags[3] = { src1_tag, src2_tag, src3_tag };
+        critical_path.on_dispatch(rob_idx, seq, insn.type, slot.fetch_cycle, slot.decode_cycle,
+                                  cycle, src_tags, cc_tag, dest_phys, dest_cc);
+
+        if (is_control) {
+            entry->checkpoint_id = reg_mgr.create_checkpoint(seq);
+            entry->control_tag = entry->checkpoint_id;
+            if (!slot.predictor_hit) {
+                predictor.establish_entry(slot.pc, get_predictor_type(insn.type), insn.imm);
+            }
+        }
+
+        if (is_mem) {
+            bool is_store = (insn.type == STORE);
+            int lsq_idx = lsq.add_entry(is_store, rob_idx);
+            entry->lsq_index = lsq_idx;
+
+            // LOAD rd,base,#imm / LDR rd,base,rs2 / STORE data,base,#imm / STR data,base,rs3
+            uint32_t base_tag = is_store ? src2_tag : src1_tag;
+            uint32_t offset_tag = is_store ? src3_tag : src2_tag;
+            uint32_t value;
+            bool ready;
+
+            read_source(base_tag, value, ready);
+            if (ready) lsq.set_base_value(lsq_idx, value);
+            else lsq.set_base_tag(lsq_idx, base_tag);
+
+            if (offset_tag == REG_NONE) {
+                lsq.set_offset_value(lsq_idx, insn.imm);
+            } else {
+                read_source(offset_tag, value, ready);
+                if (ready) lsq.set_offset_value(lsq_idx, value);
+                else lsq.set_offset_tag(lsq_idx, offset_tag);
+            }
+
+            if (is_store) {
+                read_source(src1_tag, value, ready);
+                if (ready) lsq.set_data(lsq_idx, value);
+                else lsq.set_data_tag(lsq_idx, src1_tag);
+            }
+        } else if (needs_iq) {
+            RS_Entry rs;
+            rs.pc = slot.pc;
+            rs.operation = insn.type;
+            rs.imm = insn.imm;
+            rs.rob_index = rob_idx;
+            rs.timestamp = seq;
+            rs.src1_tag = src1_tag;
+            rs.src2_tag = src2_tag;
+            rs.cc_tag = cc_tag;
+            read_source(src1_tag, rs.src1_value, rs.src1_ready);
+            read_source(src2_tag, rs.src2_value, rs.src2_ready);
+            read_cc_source(cc_tag, rs.cc_value, rs.cc_ready);
+            iq.add_entry(rs);
+        } else {
+            // NOP and HALT need no execution
+            rob.write_result(rob_idx, 0, false);
+            pipe_trace.on_complete(rob_idx, cycle);
+            critical_path.on_complete(rob_idx, cycle);
+        }
+
+        decode_latch.pop_front();
+    }
+}
+
+/*
+ * Decode 1: pass fetched instructions on to rename
+ */
+void APEX_CPU::decode() {
+    while (!fetch_latch.empty() && (int)decode_latch.size() < CoreVariant::rename_width(config)) {
+        decode_latch.push_back(fetch_latch.front());
+        decode_latch.back().decode_cycle = cycle;
+        fetch_latch.pop_front();
+    }
+}
+
+/*
+ * Fetch: read up to fetch_width instructions, following the control
+ * predictor; a predicted-taken transfer ends the fetch group
+ */
+void APEX_CPU::fetch() {
+    while (!fetch_stopped && (int)fetch_latch.size() < CoreVariant::fetch_width(config)) {
+        int index = ((int)pc - CODE_BASE_ADDRESS) / 4;
+        if (pc < CODE_BASE_ADDRESS || index >= (int)code_memory.size()) {
+            break;  // Wrong-path fetch ran off the program, wait for redirect
+        }
+
+        FrontendSlot slot;
+        slot.pc = pc;
+        slot.insn = code_memory[index];
+        slot.predictor_hit = false;
+        slot.fetch_cycle = cycle;
+        slot.decode_cycle = 0;  // Set by decode
+        uint32_t next_pc = pc + 4;
+
+        if (is_control_op(slot.insn.type)) {
+            PredictorType type = get_predictor_type(slot.insn.type);
+            uint32_t target;
+            slot.predictor_hit = predictor.has_entry(pc);
+            bool taken = predictor.lookup_prediction(pc, type, slot.insn.imm, target);
+
+            if (type == PRED_RET && !taken) {
+                predictor.pop_return_address();  // Keep the RAS balanced on a miss
+            }
+            if (slot.insn.type == JALP || slot.insn.type == JALR) {
+                predictor.push_return_address(pc + 4);
+            }
+            if (taken) {
+                next_pc = target;
+            }
+        }
+
+        slot.predicted_npc = next_pc;
+        fetch_latch.push_back(slot);
+        pc = next_pc;
+
+        if (slot.insn.type == HALT) {
+            fetch_stopped = true;
+        } else if (next_pc != slot.pc + 4) {
+            break;
+        }
+    }
+}
+
+bool APEX_CPU::is_live(uint32_t rob_idx, uint64_t seq) {
+    ROB_Entry* entry = rob.get_entry(rob_idx);
+    return entry != nullptr && entry->seq == seq;
+}
+
+void APEX_CPU::add_writeback(uint32_t rob_idx, uint32_t value, bool cc_modified,
+                             uint8_t cc_flags, bool mispredicted) {
+    ROB_Entry* entry = rob.get_entry(rob_idx);
+    BusResult result;
+    result.rob_index = rob_idx;
+    result.seq = entry->seq;
+    result.dest_tag = entry->dest_phys_reg;
+    result.value = value;
+    result.cc_tag = cc_modified ? entry->dest_cc_reg : REG_NONE;
+    result.cc_flags = cc_flags;
+    result.mispredicted = mispredicted;
+    result_bus.request(result);
+}
+
+void APEX_CPU::read_source(uint32_t tag, uint32_t& value, bool& ready) {
+    if (tag == REG_NONE) {
+        value = 0;
+        ready = true;
+        return;
+    }
+    ready = uprf.is_ready(tag);
+    value = uprf.read(tag);
+}
+
+void APEX_CPU::read_cc_source(uint32_t tag, uint32_t& value, bool& ready) {
+    if (tag == REG_NONE) {
+        value = 0;
+        ready = true;
+        return;
+    }
+    ready = ucrf.is_ready(tag);
+    value = ucrf.read(tag);
+}
+
+/*
+ * Record the resolved outcome for commit, which trains the predictor, and
+ * recover from the checkpoint when fetch followed the wrong path. Returns
+ * true on mispredict.
+ */
+bool APEX_CPU::resolve_control(uint32_t rob_idx, const IntFUResult& result) {
+    ROB_Entry* entry = rob.get_entry(rob_idx);
+    entry->taken = result.taken;
+    entry->target_addr = result.target;
+
+    bool mispredicted = (result.target != entry->predicted_npc);
+    if (mispredicted) {
+        APEX_DEBUG(LOG_CPU, "Cycle %lu: Mispredict PC=%u predicted=%u actual=%u\n",
+                   cycle, entry->pc, entry->predicted_npc, result.target);
+        mispredict_recovery = true;
+        squash_after(rob_idx);
+        critical_path.on_redirect(entry->seq);
+        reg_mgr.restore_checkpoint(entry->checkpoint_id);
+
+        // Redirect fetch to the correct path
+        squash_frontend();
+        pc = result.target;
+        fetch_stopped = false;
+    }
+
+    reg_mgr.free_checkpoint(entry->checkpoint_id);
+    entry->checkpoint_id = -1;
+    return mispredicted;
+}
+
+/*
+ * Why the ROB head could not retire, sampled right after commit so the
+ * head is seen before this cycle's issue and writeback change it
+ */
+StallCause APEX_CPU::classify_head() {
+    if (rob.get_count() == 0) {
+        return mispredict_recovery ? STALL_MISPREDICT : STALL_FETCH;
+    }
+    ROB_Entry* entry = rob.get_entry(rob.get_head());
+    if (is_memory_op(entry->type) && !entry->completed) {
+        if (entry->lsq_index >= 0 && !lsq.is_issued(entry->lsq_index) && !mem_fu.can_accept()) {
+            return STALL_MEMFU_BUSY;
+        }
+        return entry->type == LOAD ? STALL_LOAD : STALL_EXECUTE;
+    }
+    return STALL_EXECUTE;
+}
+
+/*
+ * Lost commit slots go to the ROB head, except that a stalled dispatch
+ * explains an empty front end or a window that is backed up
+ */
+StallCause APEX_CPU::classify_stall() {
+    if (committed_this_cycle >= CoreVariant::commit_width(config)) {
+        return STALL_NONE;
+    }
+    if ((head_stall == STALL_FETCH || head_stall == STALL_EXECUTE) &&
+        dispatch_stall != STALL_NONE) {
+        return dispatch_stall;
+    }
+    return head_stall;
+}
+
+// Free lists start with every register beyond the architectural mapping
+void APEX_CPU::sample_occupancy() {
+    rob_occupancy.sample(rob.get_count());
+    lsq_occupancy.sample(lsq.get_count());
+    iq_occupancy.sample(iq.get_count());
+    uprf_occupancy.sample(config.uprf_size - 32 - reg_mgr.get_free_register_count());
+    ucrf_occupancy.sample(config.ucrf_size - 1 - reg_mgr.get_free_cc_count());
+    checkpoint_occupancy.sample(reg_mgr.get_checkpoint_count());
+    mem_profile.sample_outstanding(mem_fu.get_busy_count());
+}
+
+/*
+ * Remove every instruction younger than rob_idx from the ROB, IQ, LSQ and
+ * function units
+ */
+void APEX_CPU::squash_after(uint32_t rob_idx) {
+    int squashed_mem = 0;
+
+    for (int idx = rob.next_index(rob_idx); idx != rob.get_tail(); idx = rob.next_index(idx)) {
+        ROB_Entry* entry = rob.get_entry(idx);
+        pipe_trace.on_squash(idx, cycle);
+        critical_path.on_squash(idx);
+        if (entry->lsq_index >= 0) {
+            mem_fu.squash(entry->lsq_index);
+            squashed_mem++;
+        }
+        if (entry->checkpoint_id >= 0) {
+            reg_mgr.free_checkpoint(entry->checkpoint_id);
+        }
+        mul_fu.squash(idx);
+        for (size_t i = 0; i < int_fus.size(); i++) {
+            if (int_fus[i].is_busy() && (int)int_fus[i].get_rob_index() == idx) {
+                int_fus[i].clear();
+            }
+        }
+    }
+
+    lsq.rollback(squashed_mem);
+    iq.flush(rob.get_entry(rob_idx)->seq);
+    result_bus.flush(rob.get_entry(rob_idx)->seq);
+    rob.rollback(rob_idx);
+}
+
+/*
+ * Drop the wrong-path instructions not yet dispatched, oldest first; they
+ * are numbered here since they never got a sequence number at dispatch
+ */
+void APEX_CPU::squash_frontend() {
+    for (size_t i = 0; i < decode_latch.size(); i++) {
+        const FrontendSlot& slot = decode_latch[i];
+        pipe_trace.on_frontend_squash(next_seq++, slot.pc, slot.insn, slot.fetch_cycle,
+                                      slot.decode_cycle, cycle);
+    }
+    for (size_t i = 0; i < fetch_latch.size(); i++) {
+        const FrontendSlot& slot = fetch_latch[i];
+        pipe_trace.on_frontend_squash(next_seq++, slot.pc, slot.insn, slot.fetch_cycle, 0, cycle);
+    }
+    fetch_latch.clear();
+    decode_latch.clear();
+}
+
+void APEX_CPU::print_stats() {
+    double ipc = cycle ? (double)insn_committed / (double)cycle : 0.0;
+    printf("APEX_CPU: Simulation Complete, cycles = %lu instructions = %lu IPC = %.3f\n",
+           (unsigned long)cycle, (unsigned long)insn_committed, ipc);
+    printf("APEX_CPU: Branch mispredictions = %lu\n", (unsigned long)branch_mispredicts);
+    printf("APEX_CPU: Core variant = %s\n", CoreVariant::name());
+    predictor.print_profile(insn_committed, branch_report_size);
+    cpi_stack.print(insn_committed);
+
+    printf("Occupancy (%lu cycles):\n", (unsigned long)rob_occupancy.get_samples());
+    OccupancyHistogram::print_header();
+    rob_occupancy.print();
+    lsq_occupancy.print();
+    iq_occupancy.print();
+    uprf_occupancy.print();
+    ucrf_occupancy.print();
+    checkpoint_occupancy.print();
+    mem_profile.print();
+    if (mem_fu.get_cache().is_enabled()) {
+        const DataCache& dcache = mem_fu.get_cache();
+        uint64_t accesses = dcache.get_hits() + dcache.get_misses();
+        printf("D-cache: %lu accesses, %lu misses (%.1f%%)\n", (unsigned long)accesses,
+               (unsigned long)dcache.get_misses(),
+               accesses ? 100.0 * dcache.get_misses() / accesses : 0.0);
+    }
+    critical_path.print(cycle);
+    stage_timers.print(cycle, insn_committed);
 }
 
 void APEX_CPU::show_state() {
+    Logger::flush();  // Keep queued log output ahead of the dump
     printf("===== CPU State =====\n");
-    printf("Cycle: %d\n", cycle);
-    // Will add more state display
-}
\ No newline at end of file
+    printf("Cycle: %lu\n", (unsigned long)cycle);
+    printf("Committed Instructions: %lu\n", (unsigned long)insn_committed);
+    printf("Fetch PC: %d\n", pc);
+
+    printf("\nArchitectural Registers:\n");
+    for (uint32_t i = 0; i < 32; i++) {
+        printf("R%-3d[%-5d] ", i, (int)uprf.read(reg_mgr.get_backend_register(i)));
+        if (i % 8 == 7) printf("\n");
+    }
+
+    rob.display_status();
+    iq.display_status();
+    lsq.display_status();
+    mem_fu.display_status();
+    mul_fu.display_status();
+    result_bus.display_status();
+}
@@ -0,0 +1,379 @@
+// src/apex_log.cpp
+#include "apex_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Default: warnings and errors only; the component tests raise this
+std::atomic<int> Logger::component_levels[LOG_COMPONENT_COUNT] = {
+    {LOG_WARN}, {LOG_WARN}, {LOG_WARN}, {LOG_WARN}, {LOG_WARN},
+    {LOG_WARN}, {LOG_WARN}, {LOG_WARN}, {LOG_WARN}, {LOG_WARN}
+};
+
+static const char* component_names[LOG_COMPONENT_COUNT] = {
+    "cpu", "rob", "rename", "iq", "lsq", "intfu", "mulfu", "memfu", "predictor", "bus"
+};
+
+static const char* level_names[] = {"error", "warn", "info", "debug", "trace"};
+
+/*
+ * Bounded multi-producer/multi-consumer ring (Vyukov). Each slot carries a
+ * sequence number telling producers and consumers whose turn it is, so no
+ * locks are taken on either side.
+ */
+#define LOG_RING_SIZE (1 << 14)
+
+struct LogSlot {
+    std::atomic<uint64_t> sequence;
+    LogRecord record;
+};
+
+class LogRing {
+private:
+    LogSlot* slots;
+    alignas(64) std::atomic<uint64_t> enqueue_pos;
+    alignas(64) std::atomic<uint64_t> dequeue_pos;
+
+public:
+    LogRing() {
+        slots = new LogSlot[LOG_RING_SIZE];
+        for (uint64_t i = 0; i < LOG_RING_SIZE; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_relaxed);
+    }
+
+    ~LogRing() { delete[] slots; }
+
+    bool try_push(const LogRecord& record) {
+        uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            LogSlot& slot = slots[pos & (LOG_RING_SIZE - 1)];
+            uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(LogRecord& record) {
+        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            LogSlot& slot = slots[pos & (LOG_RING_SIZE - 1)];
+            uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    record = slot.record;
+                    slot.sequence.store(pos + LOG_RING_SIZE, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t get_enqueued() const { return enqueue_pos.load(std::memory_order_acquire); }
+    bool is_empty() const {
+        return dequeue_pos.load(std::memory_order_acquire) >= get_enqueued();
+    }
+};
+
+static LogRing log_ring;
+static std::thread drain_thread;
+static std::atomic<bool> async_running(false);
+static std::atomic<uint64_t> records_written(0);
+
+// An idle drain thread sleeps here; producers only take the mutex to wake
+// it, and the timeout covers a wakeup lost between its check and its wait
+static std::mutex drain_lock;
+static std::condition_variable drain_ready;
+static std::atomic<bool> drain_waiting(false);
+
+static void wake_drain() {
+    if (drain_waiting.load()) {
+        std::lock_guard<std::mutex> guard(drain_lock);
+        drain_ready.notify_one();
+    }
+}
+
+/*
+ * Mini formatter: walks the format string and hands each conversion to
+ * snprintf with the argument widened to the matching 64-bit type
+ */
+static void format_record(const LogRecord& record, FILE* out) {
+    char buffer[1024];
+    int length = 0;
+    int arg = 0;
+    const char* p = record.fmt;
+
+    while (*p && length < (int)sizeof(buffer) - 1) {
+        if (*p != '%') {
+            buffer[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            buffer[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision, drop length modifiers
+        char spec[32];
+        int spec_len = 0;
+        spec[spec_len++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && spec_len < 24) {
+            spec[spec_len++] = *p++;
+        }
+        bool wide = false;
+        while (*p && strchr("hlLzjt", *p)) {
+            if (*p == 'l' || *p == 'z' || *p == 'j' || *p == 't') wide = true;
+            p++;
+        }
+        char conversion = *p ? *p++ : 'd';
+        uint64_t value = arg < record.num_args ? record.args[arg] : 0;
+        int size = arg < record.num_args ? record.arg_sizes[arg] : 8;
+        arg++;
+
+        int room = (int)sizeof(buffer) - length;
+        int written = 0;
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                // Narrow unsigned arguments print as their signed value, like printf
+                if (!wide && size < 8) {
+                    int shift = 64 - size * 8;
+                    value = (uint64_t)((int64_t)(value << shift) >> shift);
+                }
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = conversion;
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec, (long long)(int64_t)value);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                // Narrow signed arguments were sign extended when recorded
+                if (!wide && size < 8) value &= (1ULL << (size * 8)) - 1;
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = conversion;
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec, (unsigned long long)value);
+                break;
+            case 'c':
+                spec[spec_len++] = 'c';
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec, (int)value);
+                break;
+            case 's':
+                spec[spec_len++] = 's';
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec,
+                                   value ? (const char*)(uintptr_t)value : "(null)");
+                break;
+            case 'p':
+                spec[spec_len++] = 'p';
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec, (void*)(uintptr_t)value);
+                break;
+            case 'f':
+            case 'e':
+            case 'g': {
+                double d;
+                memcpy(&d, &value, sizeof(d));
+                spec[spec_len++] = conversion;
+                spec[spec_len] = '\0';
+                written = snprintf(buffer + length, room, spec, d);
+                break;
+            }
+            default:
+                written = 0;
+                break;
+        }
+        if (written > 0) {
+            length += written < room ? written : room - 1;
+        }
+    }
+
+    fwrite(buffer, 1, length, out);
+}
+
+static void drain_loop() {
+    LogRecord record;
+    for (;;) {
+        bool running = async_running.load(std::memory_order_acquire);
+        bool drained_any = false;
+        while (log_ring.try_pop(record)) {
+            format_record(record, stdout);
+            records_written.fetch_add(1, std::memory_order_release);
+            drained_any = true;
+        }
+        if (!running) {
+            break;
+        }
+        if (!drained_any) {
+            fflush(stdout);
+            std::unique_lock<std::mutex> guard(drain_lock);
+            drain_waiting.store(true);
+            drain_ready.wait_for(guard, std::chrono::milliseconds(10), []() {
+                return !log_ring.is_empty() || !async_running.load();
+            });
+            drain_waiting.store(false);
+        }
+    }
+    fflush(stdout);
+}
+
+void Logger::write(LogComponent component, LogLevel level, const char* fmt,
+                   int num_args, const uint64_t* args, const uint8_t* sizes) {
+    LogRecord record;
+    record.fmt = fmt;
+    record.component = (uint8_t)component;
+    record.level = (uint8_t)level;
+    record.num_args = (uint8_t)num_args;
+    for (int i = 0; i < num_args; i++) {
+        record.args[i] = args[i];
+        record.arg_sizes[i] = sizes[i];
+    }
+
+    if (!async_running.load(std::memory_order_relaxed)) {
+        format_record(record, stdout);
+        return;
+    }
+
+    // A full ring back-pressures the simulator instead of losing records
+    while (!log_ring.try_push(record)) {
+        wake_drain();
+        std::this_thread::yield();
+    }
+    wake_drain();
+}
+
+void Logger::set_level(LogLevel level) {
+    for (int i = 0; i < LOG_COMPONENT_COUNT; i++) {
+        component_levels[i].store(level);
+    }
+}
+
+void Logger::set_component_level(LogComponent component, LogLevel level) {
+    component_levels[component].store(level);
+}
+
+static bool parse_level(const char* name, size_t len, LogLevel& level) {
+    if (len == 3 && strncmp(name, "off", 3) == 0) {
+        level = LOG_OFF;
+        return true;
+    }
+    for (int i = 0; i <= LOG_TRACE; i++) {
+        if (strlen(level_names[i]) == len && strncmp(name, level_names[i], len) == 0) {
+            level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Logger::configure(const char* spec) {
+    const char* p = spec;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        const char* eq = (const char*)memchr(p, '=', len);
+        LogLevel level;
+
+        if (!eq) {
+            if (!parse_level(p, len, level)) {
+                printf("Log: Unknown level '%.*s'\n", (int)len, p);
+                return false;
+            }
+            set_level(level);
+        } else {
+            size_t name_len = eq - p;
+            if (!parse_level(eq + 1, len - name_len - 1, level)) {
+                printf("Log: Unknown level '%.*s'\n", (int)(len - name_len - 1), eq + 1);
+                return false;
+            }
+            if (name_len == 3 && strncmp(p, "all", 3) == 0) {
+                set_level(level);
+            } else {
+                int found = -1;
+                for (int i = 0; i < LOG_COMPONENT_COUNT; i++) {
+                    if (strlen(component_names[i]) == name_len &&
+                        strncmp(p, component_names[i], name_len) == 0) {
+                        found = i;
+                    }
+                }
+                if (found < 0) {
+                    printf("Log: Unknown component '%.*s'\n", (int)name_len, p);
+                    return false;
+                }
+                set_component_level((LogComponent)found, level);
+            }
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+    return true;
+}
+
+void Logger::start() {
+    if (async_running.load()) {
+        return;
+    }
+    // Warnings and errors are rare enough to format inline
+    bool verbose = false;
+    for (int i = 0; i < LOG_COMPONENT_COUNT; i++) {
+        if (component_levels[i].load() > LOG_WARN) verbose = true;
+    }
+    if (!verbose) {
+        return;
+    }
+    fflush(stdout);
+    async_running.store(true, std::memory_order_release);
+    drain_thread = std::thread(drain_loop);
+}
+
+void Logger::stop() {
+    if (!async_running.load()) {
+        return;
+    }
+    async_running.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> guard(drain_lock);
+        drain_ready.notify_one();
+    }
+    drain_thread.join();
+}
+
+void Logger::flush() {
+    if (async_running.load(std::memory_order_acquire)) {
+        uint64_t target = log_ring.get_enqueued();
+        while (records_written.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+    fflush(stdout);
+}
+
+bool Logger::is_async() {
+    return async_running.load(std::memory_order_relaxed);
+}
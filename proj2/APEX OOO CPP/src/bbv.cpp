@@ -0,0 +1,95 @@
+// src/bbv.cpp
+#include "bbv.h"
+
+BbvCollector::BbvCollector() {
+    out = NULL;
+    interval = 0;
+    in_interval = 0;
+    intervals = 0;
+    block_start = 0;
+    block_length = 0;
+    in_block = false;
+}
+
+BbvCollector::~BbvCollector() {
+    if (out) {
+        fclose(out);
+    }
+}
+
+bool BbvCollector::open(const char* path, uint64_t interval_insns) {
+    if (interval_insns == 0) {
+        printf("Error: BBV interval must be greater than zero\n");
+        return false;
+    }
+    out = fopen(path, "w");
+    if (!out) {
+        printf("Error: Unable to open BBV file %s\n", path);
+        return false;
+    }
+    interval = interval_insns;
+    return true;
+}
+
+void BbvCollector::on_instruction(uint32_t pc, bool ends_block) {
+    if (!in_block) {
+        block_start = pc;
+        in_block = true;
+    }
+    block_length++;
+    in_interval++;
+    if (ends_block) {
+        count_block();
+        in_block = false;
+    }
+    if (in_interval >= interval) {
+        write_interval();
+    }
+}
+
+// A block cut by an interval boundary counts in both intervals under its
+// start PC
+void BbvCollector::count_block() {
+    if (block_length == 0) {
+        return;
+    }
+    auto it = block_ids.find(block_start);
+    int id;
+    if (it == block_ids.end()) {
+        id = (int)block_ids.size();
+        block_ids[block_start] = id;
+        counts.push_back(0);
+    } else {
+        id = it->second;
+    }
+    if (counts[id] == 0) {
+        touched.push_back(id);
+    }
+    counts[id] += block_length;
+    block_length = 0;
+}
+
+void BbvCollector::write_interval() {
+    count_block();
+
+    fprintf(out, "T");
+    for (size_t i = 0; i < touched.size(); i++) {
+        fprintf(out, ":%d:%lu ", touched[i] + 1, (unsigned long)counts[touched[i]]);
+        counts[touched[i]] = 0;
+    }
+    fprintf(out, "\n");
+    touched.clear();
+    in_interval = 0;
+    intervals++;
+}
+
+void BbvCollector::close() {
+    if (!out) {
+        return;
+    }
+    if (in_interval > 0) {
+        write_interval();
+    }
+    fclose(out);
+    out = NULL;
+}
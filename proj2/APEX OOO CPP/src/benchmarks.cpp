@@ -0,0 +1,306 @@
+// src/benchmarks.cpp
+// Component microbenchmarks: ns/op of the ROB, LSQ, rename checkpoints and
+// control predictor, with JSON baselines and a regression threshold.
+#include "rob.h"
+#include "lsq.h"
+#include "register_manager.h"
+#include "control_predictor.h"
+#include "apex_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+struct BenchResult {
+    std::string name;
+    double ns_per_op;
+};
+
+static std::vector<BenchResult> results;
+static const char* name_filter = NULL;
+static double min_time_ns = 10e6;   // Per repetition
+static const int REPETITIONS = 9;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Keeps the compiler from discarding a value computed by the benchmark
+template <class T>
+static inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Calls body(iterations) with a growing count until one batch takes
+// min_time_ns, then keeps the fastest of REPETITIONS batches. body must
+// perform ops_per_iteration operations per iteration.
+template <class Body>
+static void run_benchmark(const char* name, int ops_per_iteration, Body body) {
+    if (name_filter && !strstr(name, name_filter)) {
+        return;
+    }
+
+    uint64_t iterations = 1;
+    while (true) {
+        uint64_t start = now_ns();
+        body(iterations);
+        uint64_t elapsed = now_ns() - start;
+        if (elapsed >= min_time_ns || iterations >= (1ULL << 40)) break;
+        iterations = elapsed < 1000 ? iterations * 10
+                                    : (uint64_t)(iterations * 1.2 * min_time_ns / elapsed) + 1;
+    }
+
+    double best = 0.0;
+    for (int r = 0; r < REPETITIONS; r++) {
+        uint64_t start = now_ns();
+        body(iterations);
+        double ns = (double)(now_ns() - start) / ((double)iterations * ops_per_iteration);
+        if (r == 0 || ns < best) best = ns;
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.ns_per_op = best;
+    results.push_back(result);
+    printf("  %-36s %10.2f ns/op\n", name, best);
+}
+
+/*
+ * ROB: one add_entry plus one commit_entry per op with the buffer held at
+ * a fixed fill level
+ */
+static void bench_rob_add_commit(int fill) {
+    char name[64];
+    snprintf(name, sizeof(name), "rob_add_commit/fill_%d", fill);
+    run_benchmark(name, 1, [fill](uint64_t n) {
+        ROB rob(80);
+        for (int i = 0; i < fill; i++) {
+            int idx = rob.add_entry(4000 + 4 * i, INT_ADD, 1, 40, 1, 0);
+            rob.get_entry(idx)->completed = true;
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            int idx = rob.add_entry(4000, INT_ADD, 1, 40, 1, 0);
+            rob.get_entry(idx)->completed = true;
+            do_not_optimize(rob.commit_entry());
+        }
+    });
+}
+
+// ROB: squash `depth` younger entries behind the branch at the head;
+// one op is the refill of depth entries plus the rollback
+static void bench_rob_rollback(int depth) {
+    char name[64];
+    snprintf(name, sizeof(name), "rob_refill_rollback/depth_%d", depth);
+    run_benchmark(name, 1, [depth](uint64_t n) {
+        ROB rob(80);
+        int branch = rob.add_entry(4000, BNZ, REG_NONE, REG_NONE, REG_NONE, 0);
+        for (uint64_t i = 0; i < n; i++) {
+            for (int d = 0; d < depth; d++) {
+                rob.add_entry(4004 + 4 * d, INT_ADD, 1, 40, 1, 0);
+            }
+            rob.rollback(branch);
+        }
+        do_not_optimize(rob.get_count());
+    });
+}
+
+// LSQ: a result broadcast scanning `waiting` entries whose operands
+// are still outstanding, none of which match the tag
+static void bench_lsq_update_tag(int waiting) {
+    char name[64];
+    snprintf(name, sizeof(name), "lsq_update_tag/waiting_%d", waiting);
+    run_benchmark(name, 1, [waiting](uint64_t n) {
+        LSQ lsq(waiting);
+        for (int i = 0; i < waiting; i++) {
+            int idx = lsq.add_entry(i % 2 == 1, i);
+            lsq.set_base_tag(idx, 100 + i);
+            lsq.set_offset_value(idx, 4);
+            lsq.set_data_tag(idx, 200 + i);
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            lsq.update_tag(999, (uint32_t)i);
+        }
+        do_not_optimize(lsq.get_count());
+    });
+}
+
+static void bench_checkpoints() {
+    run_benchmark("checkpoint_create_free", 1, [](uint64_t n) {
+        RegisterManager rm(60, 10, 8);
+        for (uint64_t i = 0; i < n; i++) {
+            int id = rm.create_checkpoint((uint32_t)i);
+            rm.free_checkpoint(id);
+        }
+        do_not_optimize(rm.get_checkpoint_count());
+    });
+
+    run_benchmark("checkpoint_restore", 1, [](uint64_t n) {
+        RegisterManager rm(60, 10, 8);
+        int id = rm.create_checkpoint(1);
+        for (uint64_t i = 0; i < n; i++) {
+            rm.restore_checkpoint(id);
+        }
+        do_not_optimize(rm.get_free_register_count());
+    });
+}
+
+// Predictor lookups of conditional branches that are, or are not, in the table
+static void bench_predictor(bool hit) {
+    run_benchmark(hit ? "predictor_lookup/hit" : "predictor_lookup/miss", 8, [hit](uint64_t n) {
+        ControlPredictor predictor(8, 4);
+        for (int i = 0; i < 8; i++) {
+            predictor.establish_entry(4000 + 16 * i, PRED_BRANCH, -8);
+        }
+        uint32_t base = hit ? 4000 : 8000;
+        uint32_t target = 0;
+        bool taken = false;
+        for (uint64_t i = 0; i < n; i++) {
+            for (int b = 0; b < 8; b++) {
+                taken ^= predictor.lookup_prediction(base + 16 * b, PRED_BRANCH, -8, target);
+            }
+        }
+        do_not_optimize(taken);
+        do_not_optimize(target);
+    });
+}
+
+static bool save_results(const char* path) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "Benchmark: Unable to write %s\n", path);
+        return false;
+    }
+    fprintf(fp, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(fp, "    {\"name\": \"%s\", \"ns_per_op\": %.3f}%s\n", results[i].name.c_str(),
+                results[i].ns_per_op, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    printf("Benchmark: Baseline saved to %s\n", path);
+    return true;
+}
+
+// Reads the name/ns_per_op pairs written by save_results
+static bool load_baseline(const char* path, std::vector<BenchResult>& baseline) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        const char* name = strstr(line, "\"name\"");
+        const char* value = strstr(line, "\"ns_per_op\"");
+        if (!name || !value) continue;
+
+        const char* start = strchr(name + 6, '"');
+        const char* end = start ? strchr(start + 1, '"') : NULL;
+        const char* colon = strchr(value + 11, ':');
+        if (!end || !colon) continue;
+
+        BenchResult entry;
+        entry.name.assign(start + 1, end - start - 1);
+        entry.ns_per_op = atof(colon + 1);
+        baseline.push_back(entry);
+    }
+    fclose(fp);
+    return true;
+}
+
+// Returns the number of benchmarks slower than the baseline by more than
+// threshold percent
+static int compare_results(const std::vector<BenchResult>& baseline, double threshold) {
+    int regressions = 0;
+    printf("\n  %-36s %10s %10s %8s\n", "benchmark", "ns/op", "baseline", "change");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult* base = NULL;
+        for (size_t j = 0; j < baseline.size(); j++) {
+            if (baseline[j].name == results[i].name) base = &baseline[j];
+        }
+        if (!base || base->ns_per_op <= 0.0) {
+            printf("  %-36s %10.2f %10s %8s\n", results[i].name.c_str(), results[i].ns_per_op,
+                   "-", "new");
+            continue;
+        }
+
+        double change = 100.0 * (results[i].ns_per_op - base->ns_per_op) / base->ns_per_op;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        printf("  %-36s %10.2f %10.2f %+7.1f%%%s\n", results[i].name.c_str(),
+               results[i].ns_per_op, base->ns_per_op, change, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s [options]\n", prog);
+    fprintf(stderr, "  --save=FILE       Write the results as a JSON baseline\n");
+    fprintf(stderr, "  --compare=FILE    Compare against a JSON baseline\n");
+    fprintf(stderr, "  --threshold=PCT   Slowdown that counts as a regression (default 20)\n");
+    fprintf(stderr, "  --filter=TEXT     Only run benchmarks whose name contains TEXT\n");
+    fprintf(stderr, "  --min-time=MS     Minimum time per measured batch (default 10)\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* save_file = NULL;
+    const char* compare_file = NULL;
+    double threshold = 20.0;
+    double min_time_ms = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--threshold=%lf", &threshold) == 1) continue;
+        if (sscanf(arg, "--min-time=%lf", &min_time_ms) == 1) continue;
+        if (strncmp(arg, "--save=", 7) == 0) {
+            save_file = arg + 7;
+        } else if (strncmp(arg, "--compare=", 10) == 0) {
+            compare_file = arg + 10;
+        } else if (strncmp(arg, "--filter=", 9) == 0) {
+            name_filter = arg + 9;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    min_time_ns = min_time_ms * 1e6;
+    Logger::set_level(LOG_ERROR);  // Full-structure warnings are expected here
+
+    printf("Component microbenchmarks:\n");
+    const int fills[] = { 0, 40, 79 };
+    for (size_t i = 0; i < sizeof(fills) / sizeof(fills[0]); i++) {
+        bench_rob_add_commit(fills[i]);
+    }
+    const int depths[] = { 1, 16, 64 };
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        bench_rob_rollback(depths[i]);
+    }
+    const int waiting[] = { 1, 6, 16, 64 };
+    for (size_t i = 0; i < sizeof(waiting) / sizeof(waiting[0]); i++) {
+        bench_lsq_update_tag(waiting[i]);
+    }
+    bench_checkpoints();
+    bench_predictor(true);
+    bench_predictor(false);
+
+    int regressions = 0;
+    if (compare_file) {
+        std::vector<BenchResult> baseline;
+        if (load_baseline(compare_file, baseline)) {
+            regressions = compare_results(baseline, threshold);
+        } else {
+            printf("Benchmark: No baseline at %s, run with --save to create one\n", compare_file);
+        }
+    }
+    if (save_file && !save_results(save_file)) {
+        return 1;
+    }
+    if (regressions > 0) {
+        printf("Benchmark: %d regression(s) above %.1f%%\n", regressions, threshold);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+// src/block_translator.cpp
+#include "block_translator.h"
+#include <stddef.h>
+#include <string.h>
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#endif
+
+#define TRANSLATION_BUFFER_BYTES (4u << 20)
+#define MAX_BLOCK_INSNS 64
+#define MAX_INSN_BYTES 64   // Longest emitted sequence, two exit stubs included
+#define RET_STUB_BYTES 1    // The ret at offset 0 that unlinked exits jump to
+#define EXIT_STUB_BYTES 15
+
+// Byte writer over the executable buffer
+class CodeWriter {
+private:
+    uint8_t* base;
+    size_t pos;
+
+public:
+    CodeWriter(uint8_t* buffer, size_t start) : base(buffer) {
+        pos = start;
+    }
+
+    size_t get_pos() const { return pos; }
+
+    void byte(uint8_t b) { base[pos++] = b; }
+    void bytes(const uint8_t* b, size_t n) {
+        memcpy(base + pos, b, n);
+        pos += n;
+    }
+    void u32(uint32_t v) {
+        memcpy(base + pos, &v, 4);
+        pos += 4;
+    }
+
+    // opcode [rdi + disp32] with the given ModRM reg field
+    void rdi_operand(uint8_t opcode, int reg, size_t disp) {
+        byte(opcode);
+        byte((uint8_t)(0x80 | (reg << 3) | 7));
+        u32((uint32_t)disp);
+    }
+};
+
+// x86 register numbers used below
+enum { EAX = 0, ECX = 1, EDX = 2 };
+
+static size_t reg_offset(uint32_t reg) {
+    return offsetof(TranslatedContext, regs) + 4 * reg;
+}
+
+// dst = guest register, 0 for REG_NONE as FunctionalCore::read_reg
+static void emit_read(CodeWriter& w, int dst, uint32_t reg) {
+    if (reg < 32) {
+        w.rdi_operand(0x8B, dst, reg_offset(reg));
+    } else {
+        w.byte(0x31);
+        w.byte((uint8_t)(0xC0 | (dst << 3) | dst));
+    }
+}
+
+// ecx = rs2 when present, else the literal
+static void emit_src2(CodeWriter& w, uint32_t reg, int32_t imm) {
+    if (reg != REG_NONE) {
+        emit_read(w, ECX, reg);
+    } else {
+        w.byte(0xB9);
+        w.u32((uint32_t)imm);
+    }
+}
+
+// cc = CC_ZERO / CC_NEGATIVE / CC_POSITIVE of eax
+static void emit_flags(CodeWriter& w) {
+    static const uint8_t test_eax[] = {0x85, 0xC0};
+    static const uint8_t cmovs_ecx_edx[] = {0x0F, 0x48, 0xCA};
+    static const uint8_t cmovz_ecx_edx[] = {0x0F, 0x44, 0xCA};
+    w.bytes(test_eax, sizeof(test_eax));
+    w.byte(0xB9);
+    w.u32(CC_POSITIVE);
+    w.byte(0xBA);
+    w.u32(CC_NEGATIVE);
+    w.bytes(cmovs_ecx_edx, sizeof(cmovs_ecx_edx));
+    w.byte(0xBA);
+    w.u32(CC_ZERO);
+    w.bytes(cmovz_ecx_edx, sizeof(cmovz_ecx_edx));
+    w.rdi_operand(0x88, ECX, offsetof(TranslatedContext, cc));
+}
+
+BlockTranslator::BlockTranslator(const std::vector<APEX_Instruction>& program,
+                                 uint32_t threshold)
+    : code(program) {
+    hot_threshold = threshold > 0 ? threshold : 1;
+    entries.assign(code.size(), (TranslatedBlock)NULL);
+    counts.assign(code.size(), 0);
+    waiting.resize(code.size());
+    buffer = NULL;
+    capacity = 0;
+    used = 0;
+    blocks = 0;
+    linked = 0;
+#if defined(__x86_64__)
+    void* mapping = mmap(NULL, TRANSLATION_BUFFER_BYTES, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping != MAP_FAILED) {
+        buffer = (uint8_t*)mapping;
+        capacity = TRANSLATION_BUFFER_BYTES;
+        buffer[0] = 0xC3;  // Offset 0: ret, where unlinked exits go
+        used = RET_STUB_BYTES;
+        set_writable(false);
+    }
+#endif
+}
+
+BlockTranslator::~BlockTranslator() {
+#if defined(__x86_64__)
+    if (buffer) {
+        munmap(buffer, capacity);
+    }
+#endif
+}
+
+size_t BlockTranslator::get_code_bytes() const {
+    return used > RET_STUB_BYTES ? used - RET_STUB_BYTES : 0;
+}
+
+bool BlockTranslator::translatable(const APEX_Instruction& insn) const {
+    switch (insn.type) {
+        case INT_ADD:
+        case INT_SUB:
+        case MUL:
+        case INT_AND:
+        case INT_OR:
+        case INT_XOR:
+        case INT_LTR:
+        case MOVC:
+        case LOAD:
+        case JALP:
+        case JALR:
+            return insn.rd < 32;
+        case CMP:
+        case CML:
+        case STORE:
+        case BZ:
+        case BNZ:
+        case BP:
+        case BNP:
+        case BN:
+        case JUMP:
+        case RET:
+            return true;
+        default:
+            return false;  // HALT and the rest stay in the interpreter
+    }
+}
+
+// W^X: read-write while emitting, read-execute while running
+bool BlockTranslator::set_writable(bool writable) {
+#if defined(__x86_64__)
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC;
+    if (mprotect(buffer, capacity, protection) == 0) {
+        return true;
+    }
+    munmap(buffer, capacity);
+#endif
+    buffer = NULL;  // Nothing more is translated or handed out
+    return false;
+}
+
+// Points the rel32 at site to target, both buffer offsets
+void BlockTranslator::link(size_t site, size_t target) {
+    int32_t rel = (int32_t)((int64_t)target - (int64_t)(site + 4));
+    memcpy(buffer + site, &rel, 4);
+    if (target != 0) {
+        linked++;
+    }
+}
+
+TranslatedBlock BlockTranslator::lookup(uint32_t pc) {
+    if (!buffer || pc < CODE_BASE_ADDRESS || (pc - CODE_BASE_ADDRESS) % 4 != 0) {
+        return NULL;
+    }
+    size_t index = (pc - CODE_BASE_ADDRESS) / 4;
+    if (index >= code.size()) {
+        return NULL;
+    }
+    if (entries[index] || counts[index] == UINT32_MAX) {
+        return entries[index];
+    }
+    if (++counts[index] < hot_threshold) {
+        return NULL;
+    }
+    TranslatedBlock block = translate((int)index);
+    if (!block) {
+        counts[index] = UINT32_MAX;  // Never retried
+    }
+    return block;
+}
+
+TranslatedBlock BlockTranslator::translate(int index) {
+    int n = (int)code.size();
+    int end = index;
+    while (end < n && end - index < MAX_BLOCK_INSNS && translatable(code[end])) {
+        if (is_control_op(code[end++].type)) break;
+    }
+    int length = end - index;
+    if (length == 0 || used + (size_t)(length + 2) * MAX_INSN_BYTES > capacity) {
+        return NULL;
+    }
+    // Only the last flag write of a block can be observed
+    int last_flags = -1;
+    for (int i = index; i < end; i++) {
+        if (writes_cc(code[i].type)) last_flags = i;
+    }
+
+    if (!set_writable(true)) {
+        return NULL;
+    }
+    CodeWriter w(buffer, used);
+    size_t start = w.get_pos();
+    std::vector<std::pair<size_t, uint32_t> > exits;  // rel32 site, guest target
+
+    // Stores the next PC and jumps on, to the ret at 0 until linked
+    auto exit_stub = [&](uint32_t target) {
+        w.rdi_operand(0xC7, 0, offsetof(TranslatedContext, pc));
+        w.u32(target);
+        w.byte(0xE9);
+        exits.push_back(std::make_pair(w.get_pos(), target));
+        w.u32((uint32_t)(int32_t)(0 - (int64_t)(w.get_pos() + 4)));
+    };
+    auto store_pc_and_return = [&]() {
+        w.rdi_operand(0x89, EAX, offsetof(TranslatedContext, pc));
+        w.byte(0xC3);
+    };
+
+    // Whole block or nothing: cmp budget, length; jl ret; sub budget, length
+    w.byte(0x48);
+    w.rdi_operand(0x81, 7, offsetof(TranslatedContext, budget));
+    w.u32((uint32_t)length);
+    w.byte(0x0F);
+    w.byte(0x8C);
+    w.u32((uint32_t)(int32_t)(0 - (int64_t)(w.get_pos() + 4)));
+    w.byte(0x48);
+    w.rdi_operand(0x81, 5, offsetof(TranslatedContext, budget));
+    w.u32((uint32_t)length);
+
+    for (int i = index; i < end; i++) {
+        const APEX_Instruction& insn = code[i];
+        uint32_t pc = CODE_BASE_ADDRESS + 4 * i;
+        switch (insn.type) {
+            case INT_ADD:
+            case INT_SUB:
+            case MUL:
+            case INT_AND:
+            case INT_OR:
+            case INT_XOR:
+            case CMP:
+            case CML: {
+                emit_read(w, EAX, insn.rs1);
+                emit_src2(w, insn.rs2, insn.imm);
+                if (insn.type == MUL) {
+                    static const uint8_t imul_eax_ecx[] = {0x0F, 0xAF, 0xC1};
+                    w.bytes(imul_eax_ecx, sizeof(imul_eax_ecx));
+                } else {
+                    w.byte(insn.type == INT_ADD ? 0x01 : insn.type == INT_AND ? 0x21 :
+                           insn.type == INT_OR ? 0x09 : insn.type == INT_XOR ? 0x31 : 0x29);
+                    w.byte(0xC8);
+                }
+                if (insn.type != CMP && insn.type != CML) {
+                    w.rdi_operand(0x89, EAX, reg_offset(insn.rd));
+                }
+                if (i == last_flags) {
+                    emit_flags(w);
+                }
+                break;
+            }
+            case INT_LTR: {
+                static const uint8_t cmp_setl_movzx[] = {0x39, 0xC8, 0x0F, 0x9C, 0xC0,
+                                                         0x0F, 0xB6, 0xC0};
+                emit_read(w, EAX, insn.rs1);
+                emit_src2(w, insn.rs2, insn.imm);
+                w.bytes(cmp_setl_movzx, sizeof(cmp_setl_movzx));
+                w.rdi_operand(0x89, EAX, reg_offset(insn.rd));
+                break;
+            }
+            case MOVC:
+                emit_src2(w, insn.rs2, insn.imm);
+                w.rdi_operand(0x89, ECX, reg_offset(insn.rd));
+                break;
+
+            case LOAD: {
+                // Out-of-range addresses read 0
+                static const uint8_t load_rdx_rax[] = {0x8B, 0x04, 0x82, 0xEB, 0x02, 0x31, 0xC0};
+                emit_read(w, EAX, insn.rs1);
+                emit_src2(w, insn.rs2, insn.imm);
+                w.byte(0x01);
+                w.byte(0xC8);
+                w.rdi_operand(0x3B, EAX, offsetof(TranslatedContext, memory_words));
+                w.byte(0x73);
+                w.byte(12);
+                w.byte(0x48);
+                w.rdi_operand(0x8B, EDX, offsetof(TranslatedContext, memory));
+                w.bytes(load_rdx_rax, sizeof(load_rdx_rax));
+                w.rdi_operand(0x89, EAX, reg_offset(insn.rd));
+                break;
+            }
+            case STORE: {
+                // Out-of-range addresses are dropped
+                static const uint8_t store_rdx_rax[] = {0x89, 0x0C, 0x82};
+                emit_src2(w, insn.rs3, insn.imm);
+                emit_read(w, EAX, insn.rs2);
+                w.byte(0x01);
+                w.byte(0xC8);
+                emit_read(w, ECX, insn.rs1);
+                w.rdi_operand(0x3B, EAX, offsetof(TranslatedContext, memory_words));
+                w.byte(0x73);
+                w.byte(10);
+                w.byte(0x48);
+                w.rdi_operand(0x8B, EDX, offsetof(TranslatedContext, memory));
+                w.bytes(store_rdx_rax, sizeof(store_rdx_rax));
+                break;
+            }
+
+            case BZ:
+            case BNZ:
+            case BP:
+            case BNP:
+            case BN: {
+                uint8_t flag = insn.type == BP || insn.type == BNP ? CC_POSITIVE :
+                               insn.type == BN ? CC_NEGATIVE : CC_ZERO;
+                bool taken_if_set = insn.type == BZ || insn.type == BP || insn.type == BN;
+                w.byte(0x0F);
+                w.rdi_operand(0xB6, EAX, offsetof(TranslatedContext, cc));
+                w.byte(0xA8);
+                w.byte(flag);
+                w.byte(taken_if_set ? 0x75 : 0x74);  // jnz / jz over the fall-through exit
+                w.byte(EXIT_STUB_BYTES);
+                exit_stub(pc + 4);
+                exit_stub(pc + insn.imm);
+                break;
+            }
+            case JALP:
+                w.rdi_operand(0xC7, 0, reg_offset(insn.rd));
+                w.u32(pc + 4);
+                exit_stub(pc + insn.imm);
+                break;
+            case JUMP:
+            case JALR:
+                emit_read(w, EAX, insn.rs1);
+                w.byte(0x05);
+                w.u32((uint32_t)insn.imm);
+                if (insn.type == JALR) {
+                    w.rdi_operand(0xC7, 0, reg_offset(insn.rd));
+                    w.u32(pc + 4);
+                }
+                store_pc_and_return();
+                break;
+            case RET:
+                emit_read(w, EAX, insn.rs1);
+                store_pc_and_return();
+                break;
+            default:
+                break;
+        }
+    }
+    if (!is_control_op(code[end - 1].type)) {
+        exit_stub(CODE_BASE_ADDRESS + 4 * end);  // Stopped before HALT or an unknown opcode
+    }
+    used = w.get_pos();
+
+    // Chain this block's exits, and the waiting exits into it
+    for (size_t e = 0; e < exits.size(); e++) {
+        uint32_t target = exits[e].second;
+        size_t target_index = (target - CODE_BASE_ADDRESS) / 4;
+        if (target < CODE_BASE_ADDRESS || (target - CODE_BASE_ADDRESS) % 4 != 0 ||
+            target_index >= code.size()) {
+            continue;
+        }
+        if ((int)target_index == index) {
+            link(exits[e].first, start);
+        } else if (entries[target_index]) {
+            link(exits[e].first, (uint8_t*)entries[target_index] - buffer);
+        } else {
+            waiting[target_index].push_back(exits[e].first);
+        }
+    }
+    for (size_t s = 0; s < waiting[index].size(); s++) {
+        link(waiting[index][s], start);
+    }
+    waiting[index].clear();
+    if (!set_writable(false)) {
+        return NULL;
+    }
+
+    entries[index] = (TranslatedBlock)(buffer + start);
+    blocks++;
+    return entries[index];
+}
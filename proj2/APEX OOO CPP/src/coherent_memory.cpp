@@ -0,0 +1,249 @@
+// src/coherent_memory.cpp
+#include "coherent_memory.h"
+#include "file_parser.h"
+#include <algorithm>
+
+static const uint32_t NO_LINE = 0xFFFFFFFF;
+
+static const char* bus_op_names[BUS_OP_COUNT] = { "BusRd", "BusRdX", "BusUpgr", "WriteBack" };
+
+CoherentL1::CoherentL1(CoherentMemory& memory, int core_id, int num_sets, int num_ways,
+                       int words_per_line)
+    : shared(memory) {
+    core = core_id;
+    sets = num_sets > 0 ? num_sets : 1;
+    ways = num_ways > 0 ? num_ways : 1;
+    line_words = words_per_line > 0 ? words_per_line : 1;
+    tags.assign(sets * ways, NO_LINE);
+    states.assign(sets * ways, MESI_I);
+    last_use.assign(sets * ways, 0);
+    use_clock = 0;
+    now = 0;
+    hits = 0;
+    misses = 0;
+    upgrades = 0;
+    transfers = 0;
+    invalidations = 0;
+    writebacks = 0;
+}
+
+// A way keeps its tag when invalidated by a snoop
+int CoherentL1::find(uint32_t line) const {
+    int base = (int)(line % sets) * ways;
+    for (int w = base; w < base + ways; w++) {
+        if (tags[w] == line) return w;
+    }
+    return -1;
+}
+
+void CoherentL1::request(BusOp op, uint32_t line) {
+    BusTransaction tx;
+    tx.cycle = now;
+    tx.core = core;
+    tx.op = op;
+    tx.line = line;
+    transactions.push_back(tx);
+}
+
+int CoherentL1::access(uint32_t address, bool is_store) {
+    uint32_t line = address / line_words;
+    int way = find(line);
+    use_clock++;
+
+    if (way >= 0 && states[way] != MESI_I) {
+        last_use[way] = use_clock;
+        hits++;
+        if (!is_store || states[way] == MESI_M) {
+            return 0;
+        }
+        if (states[way] == MESI_E) {
+            states[way] = MESI_M;  // Silent upgrade
+            return 0;
+        }
+        upgrades++;
+        request(BUS_UPGR, line);
+        states[way] = MESI_M;
+        return shared.upgrade_latency;
+    }
+
+    misses++;
+    if (way < 0) {
+        // Invalid ways first, then LRU
+        int base = (int)(line % sets) * ways;
+        way = base;
+        for (int w = base; w < base + ways; w++) {
+            if (states[w] == MESI_I) {
+                way = w;
+                break;
+            }
+            if (last_use[w] < last_use[way]) way = w;
+        }
+        if (states[way] == MESI_M) {
+            writebacks++;
+            request(BUS_WB, tags[way]);
+        }
+        tags[way] = line;
+    }
+    last_use[way] = use_clock;
+
+    bool other_copy = false;
+    auto it = shared.sharers.find(line);
+    if (it != shared.sharers.end()) {
+        other_copy = (it->second & ~(1ULL << core)) != 0;
+    }
+    request(is_store ? BUS_RDX : BUS_RD, line);
+    states[way] = is_store ? MESI_M : (other_copy ? MESI_S : MESI_E);
+    if (other_copy) {
+        transfers++;
+        return shared.transfer_latency;
+    }
+    return shared.memory_latency;
+}
+
+uint32_t CoherentL1::read(uint32_t address) {
+    auto it = own_stores.find(address);
+    return it != own_stores.end() ? it->second : shared.read(address);
+}
+
+void CoherentL1::write(uint32_t address, uint32_t data) {
+    BufferedStore store;
+    store.cycle = now;
+    store.core = core;
+    store.address = address;
+    store.data = data;
+    stores.push_back(store);
+    own_stores[address] = data;
+}
+
+MesiState CoherentL1::get_state(uint32_t address) const {
+    int way = find(address / line_words);
+    return way >= 0 ? (MesiState)states[way] : MESI_I;
+}
+
+void CoherentL1::print(FILE* out) const {
+    uint64_t accesses = hits + misses;
+    fprintf(out, "  L1 %-3d %10lu %8lu %6.2f%% %8lu %9lu %13lu %10lu\n", core,
+            (unsigned long)accesses, (unsigned long)misses,
+            accesses ? 100.0 * misses / accesses : 0.0, (unsigned long)upgrades,
+            (unsigned long)transfers, (unsigned long)invalidations, (unsigned long)writebacks);
+}
+
+CoherentMemory::CoherentMemory(int cores, int memory_words, int sets, int ways, int line_words,
+                               int miss_cycles, int transfer_cycles, int upgrade_cycles) {
+    memory.assign(memory_words, 0);
+    for (int c = 0; c < cores && c < MAX_COHERENT_CORES; c++) {
+        caches.push_back(std::unique_ptr<CoherentL1>(
+            new CoherentL1(*this, c, sets, ways, line_words)));
+    }
+    memory_latency = miss_cycles;
+    transfer_latency = transfer_cycles;
+    upgrade_latency = upgrade_cycles;
+    for (int i = 0; i < BUS_OP_COUNT; i++) {
+        bus_ops[i] = 0;
+    }
+    flushes = 0;
+    stores_applied = 0;
+    quanta = 0;
+}
+
+int CoherentMemory::load_data(const char* filename) {
+    return load_data_memory(filename, memory.data(), (int)memory.size());
+}
+
+/*
+ * Each transaction fixes the other caches relative to its requester: a
+ * read drops M/E copies to S, a write invalidates them, and the requester
+ * gets the state the transaction implies if it still holds the line. Two
+ * cores that both saw an uncached line in the same quantum therefore end
+ * up consistent, whichever order their threads ran in.
+ */
+void CoherentMemory::synchronize() {
+    std::vector<BusTransaction> bus;
+    std::vector<BufferedStore> writes;
+    for (size_t c = 0; c < caches.size(); c++) {
+        CoherentL1& l1 = *caches[c];
+        bus.insert(bus.end(), l1.transactions.begin(), l1.transactions.end());
+        writes.insert(writes.end(), l1.stores.begin(), l1.stores.end());
+        l1.transactions.clear();
+        l1.stores.clear();
+        l1.own_stores.clear();
+    }
+
+    // Queues are in cycle order per core and concatenated by core
+    std::stable_sort(bus.begin(), bus.end(),
+                     [](const BusTransaction& a, const BusTransaction& b) {
+                         return a.cycle < b.cycle || (a.cycle == b.cycle && a.core < b.core);
+                     });
+    for (size_t i = 0; i < bus.size(); i++) {
+        const BusTransaction& tx = bus[i];
+        bus_ops[tx.op]++;
+        if (tx.op == BUS_WB) {
+            continue;  // Data already reached memory with the stores
+        }
+        bool other_copy = false;
+        for (size_t c = 0; c < caches.size(); c++) {
+            CoherentL1& other = *caches[c];
+            int way = (int)c == tx.core ? -1 : other.find(tx.line);
+            if (way < 0 || other.states[way] == MESI_I) continue;
+            if (other.states[way] == MESI_M) {
+                flushes++;
+            }
+            if (tx.op == BUS_RD) {
+                other.states[way] = MESI_S;
+                other_copy = true;
+            } else {
+                other.states[way] = MESI_I;
+                other.invalidations++;
+            }
+        }
+        CoherentL1& requester = *caches[tx.core];
+        int way = requester.find(tx.line);
+        if (way >= 0) {
+            if (tx.op != BUS_RD) {
+                requester.states[way] = MESI_M;
+            } else if (requester.states[way] != MESI_M || other_copy) {
+                requester.states[way] = other_copy ? MESI_S : MESI_E;
+            }
+        }
+    }
+
+    std::stable_sort(writes.begin(), writes.end(),
+                     [](const BufferedStore& a, const BufferedStore& b) {
+                         return a.cycle < b.cycle || (a.cycle == b.cycle && a.core < b.core);
+                     });
+    for (size_t i = 0; i < writes.size(); i++) {
+        if (writes[i].address < memory.size()) {
+            memory[writes[i].address] = writes[i].data;
+        }
+    }
+    stores_applied += writes.size();
+    quanta++;
+    rebuild_sharers();
+}
+
+void CoherentMemory::rebuild_sharers() {
+    sharers.clear();
+    for (size_t c = 0; c < caches.size(); c++) {
+        const CoherentL1& l1 = *caches[c];
+        for (size_t w = 0; w < l1.tags.size(); w++) {
+            if (l1.states[w] != MESI_I) {
+                sharers[l1.tags[w]] |= 1ULL << c;
+            }
+        }
+    }
+}
+
+void CoherentMemory::print(FILE* out) const {
+    fprintf(out, "Coherence (%lu quanta, %lu stores made visible):\n", (unsigned long)quanta,
+            (unsigned long)stores_applied);
+    fprintf(out, "  %-6s %10s %8s %7s %8s %9s %13s %10s\n", "cache", "accesses", "misses",
+            "miss%", "upgrades", "transfers", "invalidations", "writebacks");
+    for (size_t c = 0; c < caches.size(); c++) {
+        caches[c]->print(out);
+    }
+    fprintf(out, "  bus:");
+    for (int i = 0; i < BUS_OP_COUNT; i++) {
+        fprintf(out, " %s %lu", bus_op_names[i], (unsigned long)bus_ops[i]);
+    }
+    fprintf(out, ", dirty flushes %lu\n", (unsigned long)flushes);
+}
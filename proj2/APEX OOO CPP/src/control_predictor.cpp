@@ -1,20 +1,33 @@
 #include "control_predictor.h"
+#include "apex_log.h"
+#include "stats_registry.h"
 #include <stdio.h>
 #include <cstdlib> 
+#include <algorithm>
 
-ControlPredictor::ControlPredictor() {
+template <class Capacity>
+ControlPredictor_T<Capacity>::ControlPredictor_T(int predictor_size, int ras_size)
+    : capacity(predictor_size) {
+    capacity.allocate(table);
+    ras.addresses.assign(ras_size, 0);
     head = 0;
     count = 0;
+    ras.top = -1;  // Empty return stack
     
     // Initialize predictor entries
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < capacity.size(); i++) {
         table[i].established = false;
     }
 }
 
-bool ControlPredictor::lookup_prediction(uint32_t pc, PredictorType type, 
+template <class Capacity>
+bool ControlPredictor_T<Capacity>::lookup_prediction(uint32_t pc, PredictorType type, 
                                        int32_t offset, uint32_t& target) {
     const int index = find_entry(pc);
+    BranchProfile& stats = get_profile(pc, type);
+    stats.lookups++;
+    if (index != -1) stats.btb_hits++;
+    else stats.btb_misses++;
     
     if (index != -1) {  // Hit
         if (type == PRED_BRANCH) {  // Change BRANCH to PRED_BRANCH
@@ -46,7 +59,8 @@ bool ControlPredictor::lookup_prediction(uint32_t pc, PredictorType type,
     return false;
 }
 
-void ControlPredictor::establish_entry(uint32_t pc, PredictorType type, int32_t offset) {
+template <class Capacity>
+void ControlPredictor_T<Capacity>::establish_entry(uint32_t pc, PredictorType type, int32_t offset) {
     int index = allocate_entry();
     table[index].established = true;
     table[index].pc = pc;
@@ -63,7 +77,8 @@ void ControlPredictor::establish_entry(uint32_t pc, PredictorType type, int32_t
     }
 }
 
-bool ControlPredictor::was_predicted_taken(uint32_t pc) const {
+template <class Capacity>
+bool ControlPredictor_T<Capacity>::was_predicted_taken(uint32_t pc) const {
     int index = find_entry(pc);
     if (index != -1) {
         if (table[index].type == PRED_BRANCH) {
@@ -74,7 +89,8 @@ bool ControlPredictor::was_predicted_taken(uint32_t pc) const {
     return false;
 }
 
-void ControlPredictor::update_prediction(uint32_t pc, bool actual_outcome, uint32_t target) {
+template <class Capacity>
+void ControlPredictor_T<Capacity>::update_prediction(uint32_t pc, bool actual_outcome, uint32_t target) {
     int index = find_entry(pc);
     if (index != -1) {
         if (target != 0) {  // Only update if valid target provided
@@ -84,32 +100,63 @@ void ControlPredictor::update_prediction(uint32_t pc, bool actual_outcome, uint3
     }
 }
 
-void ControlPredictor::push_return_address(uint32_t addr) {
-    if (ras.top < 3) {  // Ensure we don't exceed array bounds
+template <class Capacity>
+void ControlPredictor_T<Capacity>::push_return_address(uint32_t addr) {
+    if (ras.top < (int)ras.addresses.size() - 1) {  // Ensure we don't exceed array bounds
         ras.top++;
         ras.addresses[ras.top] = addr;
-        printf("RAS Push: Index=%d, Address=0x%x\n", ras.top, addr);
+        APEX_DEBUG(LOG_PREDICTOR, "RAS Push: Index=%d, Address=0x%x\n", ras.top, addr);
     }
 }
 
-uint32_t ControlPredictor::pop_return_address() {  // Changed return type from void to uint32_t
+template <class Capacity>
+uint32_t ControlPredictor_T<Capacity>::pop_return_address() {  // Changed return type from void to uint32_t
     uint32_t addr = 0;
     if (ras.top >= 0) {
         addr = ras.addresses[ras.top];
-        printf("RAS Pop: Index=%d, Address=0x%x\n", ras.top, addr);
+        APEX_DEBUG(LOG_PREDICTOR, "RAS Pop: Index=%d, Address=0x%x\n", ras.top, addr);
         ras.addresses[ras.top] = 0;  // Clear the entry
         ras.top--;
     }
     return addr;
 }
 
-void ControlPredictor::display_status() const {
+// Same order as the pipeline: the RAS moves at fetch, a missing entry is
+// established at dispatch and the outcome recorded at resolve
+template <class Capacity>
+void ControlPredictor_T<Capacity>::train(uint32_t pc, InstructionType insn_type, int32_t offset,
+                                         bool taken, uint32_t target) {
+    PredictorType type = get_predictor_type(insn_type);
+    if (type == PRED_RET) {
+        pop_return_address();
+    }
+    if (insn_type == JALP || insn_type == JALR) {
+        push_return_address(pc + 4);
+    }
+    if (find_entry(pc) == -1) {
+        establish_entry(pc, type, offset);
+    }
+    update_prediction(pc, taken, taken ? target : pc + 4);
+}
+
+template <class Capacity>
+void ControlPredictor_T<Capacity>::copy_state(const ControlPredictor_T& other) {
+    for (int i = 0; i < capacity.size() && i < other.capacity.size(); i++) {
+        table[i] = other.table[i];
+    }
+    ras = other.ras;
+    head = other.head;
+    count = other.count;
+}
+
+template <class Capacity>
+void ControlPredictor_T<Capacity>::display_status() const {
     printf("\nControl Predictor Status:\n");
     printf("Valid Entries: %d\n", count);
     printf("Next replacement index: %d\n", head);
     
     printf("\nPredictor Table:\n");
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < capacity.size(); i++) {
         if (table[i].established) {
             printf("Entry %d: PC=0x%x Type=%d LastOutcome=%d Target=0x%x\n",
                    i, table[i].pc, table[i].type, table[i].last_outcome, 
@@ -122,4 +169,133 @@ void ControlPredictor::display_status() const {
     for (int i = ras.top; i >= 0; i--) {
         printf("RAS[%d] = 0x%x\n", i, ras.addresses[i]);
     }
-}
\ No newline at end of file
+}
+
+template <class Capacity>
+BranchProfile& ControlPredictor_T<Capacity>::get_profile(uint32_t pc, PredictorType type) {
+    typename std::unordered_map<uint32_t, BranchProfile>::iterator it = profile.find(pc);
+    if (it == profile.end()) {
+        BranchProfile fresh = BranchProfile();
+        fresh.type = type;
+        it = profile.insert(std::make_pair(pc, fresh)).first;
+    }
+    return it->second;
+}
+
+// Classifies a resolved control instruction: a wrong RET target is blamed
+// on the RAS, a wrong taken/not-taken guess on the direction, anything
+// else on the BTB target
+template <class Capacity>
+void ControlPredictor_T<Capacity>::record_resolution(uint32_t pc, PredictorType type,
+                                                     uint32_t predicted_npc, bool taken,
+                                                     uint32_t target) {
+    BranchProfile& stats = get_profile(pc, type);
+    stats.resolved++;
+    if (predicted_npc == target) {
+        return;
+    }
+
+    bool predicted_taken = (predicted_npc != pc + 4);
+    if (type == PRED_RET) {
+        stats.ras_mispredicts++;
+    } else if (predicted_taken != taken) {
+        stats.direction_mispredicts++;
+    } else {
+        stats.target_mispredicts++;
+    }
+}
+
+template <class Capacity>
+BranchProfile ControlPredictor_T<Capacity>::get_totals() const {
+    BranchProfile totals = BranchProfile();
+    for (typename std::unordered_map<uint32_t, BranchProfile>::const_iterator it = profile.begin();
+         it != profile.end(); ++it) {
+        totals.lookups += it->second.lookups;
+        totals.btb_hits += it->second.btb_hits;
+        totals.btb_misses += it->second.btb_misses;
+        totals.resolved += it->second.resolved;
+        totals.direction_mispredicts += it->second.direction_mispredicts;
+        totals.target_mispredicts += it->second.target_mispredicts;
+        totals.ras_mispredicts += it->second.ras_mispredicts;
+    }
+    return totals;
+}
+
+// Totals are summed over the profile when the registry is read
+template <class Capacity>
+void ControlPredictor_T<Capacity>::register_stats(StatsRegistry& stats,
+                                                  const std::string& prefix) const {
+    stats.add_counter(prefix + ".lookups", "Predictor lookups at fetch",
+                      [this]() { return get_totals().lookups; });
+    stats.add_counter(prefix + ".btb_hits", "Lookups that found an entry",
+                      [this]() { return get_totals().btb_hits; });
+    stats.add_counter(prefix + ".btb_misses", "Lookups without an entry",
+                      [this]() { return get_totals().btb_misses; });
+    stats.add_counter(prefix + ".resolved", "Control instructions resolved",
+                      [this]() { return get_totals().resolved; });
+    stats.add_counter(prefix + ".direction_mispredicts", "Wrong taken/not-taken guesses",
+                      [this]() { return get_totals().direction_mispredicts; });
+    stats.add_counter(prefix + ".target_mispredicts", "Wrong BTB targets",
+                      [this]() { return get_totals().target_mispredicts; });
+    stats.add_counter(prefix + ".ras_mispredicts", "Wrong RET targets",
+                      [this]() { return get_totals().ras_mispredicts; });
+    stats.add_formula(prefix + ".btb_miss_rate", "btb_misses / lookups", [this]() {
+        BranchProfile t = get_totals();
+        return t.lookups ? (double)t.btb_misses / t.lookups : 0.0;
+    });
+}
+
+template <class Capacity>
+void ControlPredictor_T<Capacity>::print_profile(uint64_t instructions, int top_n) const {
+    static const char* type_names[] = { "branch", "jump", "ret" };
+    std::vector<std::pair<uint32_t, const BranchProfile*> > offenders;
+    uint64_t lookups = 0, hits = 0, direction = 0, targets = 0, returns = 0;
+
+    for (typename std::unordered_map<uint32_t, BranchProfile>::const_iterator it = profile.begin();
+         it != profile.end(); ++it) {
+        const BranchProfile& stats = it->second;
+        lookups += stats.lookups;
+        hits += stats.btb_hits;
+        direction += stats.direction_mispredicts;
+        targets += stats.target_mispredicts;
+        returns += stats.ras_mispredicts;
+        if (stats.mispredicts() > 0) {
+            offenders.push_back(std::make_pair(it->first, &stats));
+        }
+    }
+
+    // Worst first, ties in PC order so the report is stable
+    std::sort(offenders.begin(), offenders.end(),
+              [](const std::pair<uint32_t, const BranchProfile*>& a,
+                 const std::pair<uint32_t, const BranchProfile*>& b) {
+                  if (a.second->mispredicts() != b.second->mispredicts()) {
+                      return a.second->mispredicts() > b.second->mispredicts();
+                  }
+                  return a.first < b.first;
+              });
+
+    uint64_t total = direction + targets + returns;
+    double mpki = instructions ? 1000.0 * total / instructions : 0.0;
+    printf("Control predictor: lookups = %lu BTB hit rate = %.1f%% mispredicts = %lu MPKI = %.2f\n",
+           (unsigned long)lookups, lookups ? 100.0 * hits / lookups : 0.0,
+           (unsigned long)total, mpki);
+    printf("  direction = %lu target = %lu ras = %lu\n",
+           (unsigned long)direction, (unsigned long)targets, (unsigned long)returns);
+    if (offenders.empty() || top_n <= 0) {
+        return;
+    }
+
+    printf("  %-8s %-6s %8s %8s %8s %6s %6s %6s %6s\n", "pc", "type", "lookups", "btb_miss",
+           "resolved", "dir", "target", "ras", "rate");
+    for (size_t i = 0; i < offenders.size() && (int)i < top_n; i++) {
+        const BranchProfile& stats = *offenders[i].second;
+        printf("  %-8u %-6s %8lu %8lu %8lu %6lu %6lu %6lu %5.1f%%\n", offenders[i].first,
+               type_names[stats.type], (unsigned long)stats.lookups,
+               (unsigned long)stats.btb_misses, (unsigned long)stats.resolved,
+               (unsigned long)stats.direction_mispredicts, (unsigned long)stats.target_mispredicts,
+               (unsigned long)stats.ras_mispredicts,
+               stats.resolved ? 100.0 * stats.mispredicts() / stats.resolved : 0.0);
+    }
+}
+
+template class ControlPredictor_T<CoreVariant::PredictorCapacity>;
@@ -0,0 +1,54 @@
+// src/cpi_stack.cpp
+#include "cpi_stack.h"
+#include "stats_registry.h"
+#include <stdio.h>
+
+static const char* stall_names[STALL_CAUSE_COUNT] = {
+    "base", "rob_full", "lsq_full", "iq_full", "uprf_empty", "ucrf_empty",
+    "checkpoints", "fetch", "mispredict", "memfu_busy", "load", "execute"
+};
+
+CpiStack::CpiStack(int commit_width) {
+    width = commit_width > 0 ? commit_width : 1;
+    cycles = 0;
+    for (int i = 0; i < STALL_CAUSE_COUNT; i++) {
+        slots[i] = 0;
+    }
+}
+
+void CpiStack::record_cycle(int committed, StallCause cause) {
+    cycles++;
+    slots[STALL_NONE] += committed;
+    if (committed < width) {
+        slots[cause == STALL_NONE ? STALL_EXECUTE : cause] += width - committed;
+    }
+}
+
+const char* CpiStack::get_name(StallCause cause) {
+    return stall_names[cause];
+}
+
+void CpiStack::register_stats(StatsRegistry& stats, const std::string& prefix) const {
+    stats.add_vector(prefix + ".slots", "Commit slots by stall cause", slots,
+                     STALL_CAUSE_COUNT, stall_names);
+}
+
+// Each component is its share of commit slots expressed in CPI, so the
+// components add up to cycles / instructions
+void CpiStack::print(uint64_t instructions) const {
+    printf("CPI stack (%d commit slots per cycle):\n", width);
+    if (instructions == 0) {
+        printf("  no instructions committed\n");
+        return;
+    }
+
+    double total = 0.0;
+    for (int i = 0; i < STALL_CAUSE_COUNT; i++) {
+        double cpi = (double)slots[i] / width / instructions;
+        total += cpi;
+        if (slots[i] == 0 && i != STALL_NONE) continue;
+        printf("  %-12s %8.3f  %5.1f%%\n", get_name((StallCause)i), cpi,
+               100.0 * slots[i] / ((double)cycles * width));
+    }
+    printf("  %-12s %8.3f\n", "total", total);
+}
@@ -0,0 +1,286 @@
+// src/critical_path.cpp
+#include "critical_path.h"
+#include "stats_registry.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* crit_names[CRIT_CAUSE_COUNT] = {
+    "frontend", "mispredict", "window", "issue", "alu", "mul", "memory", "commit"
+};
+
+CriticalPath::CriticalPath(int rob_size, int uprf_size, int ucrf_size) {
+    enabled = false;
+    window = 0;
+    inflight.resize(rob_size > 0 ? rob_size : 1);
+    reg_producer.assign(uprf_size > 0 ? uprf_size : 1, 0);
+    cc_producer.assign(ucrf_size > 0 ? ucrf_size : 1, 0);
+    commits = 0;
+    analyzed = 0;
+    boundary = 0;
+    last_mem_seq = 0;
+    pending_redirect = 0;
+    for (int i = 0; i < CRIT_CAUSE_COUNT; i++) {
+        cycles[i] = 0;
+    }
+}
+
+// Windows shorter than the ROB would cut most paths at a retire node
+void CriticalPath::enable(int window_size) {
+    window = window_size > (int)inflight.size() ? window_size : (int)inflight.size();
+    committed.resize(2 * window);
+    enabled = true;
+}
+
+void CriticalPath::on_dispatch(int rob_idx, uint64_t seq, InstructionType type, uint64_t fetch,
+                               uint64_t decode, uint64_t cycle, const uint32_t* src_tags,
+                               uint32_t cc_tag, uint32_t dest_phys, uint32_t dest_cc) {
+    if (!enabled) {
+        return;
+    }
+    CritRecord& rec = inflight[rob_idx];
+    memset(&rec, 0, sizeof(rec));
+    rec.seq = seq;
+    rec.type = type;
+    rec.fetch = fetch;
+    rec.decode = decode;
+    rec.dispatch = cycle;
+
+    // Sources are looked up before the destination is renamed
+    for (int i = 0; i < 3; i++) {
+        if (src_tags[i] < reg_producer.size()) rec.producers[i] = reg_producer[src_tags[i]];
+    }
+    if (cc_tag < cc_producer.size()) rec.producers[3] = cc_producer[cc_tag];
+    if (dest_phys < reg_producer.size()) reg_producer[dest_phys] = seq;
+    if (dest_cc < cc_producer.size()) cc_producer[dest_cc] = seq;
+
+    if (is_memory_op(type)) {
+        rec.mem_pred = last_mem_seq;
+        last_mem_seq = seq;
+    }
+    rec.redirect = pending_redirect;  // First correct-path instruction
+    pending_redirect = 0;
+}
+
+void CriticalPath::on_retire(int rob_idx, uint64_t cycle) {
+    if (!enabled) {
+        return;
+    }
+    CritRecord& rec = committed[commits % committed.size()];
+    rec = inflight[rob_idx];
+    rec.retire = cycle;
+    commits++;
+    if (commits - analyzed >= (uint64_t)window) {
+        analyze();
+    }
+}
+
+// Squashed from oldest to youngest, so the first squashed memory op holds
+// the youngest surviving one
+void CriticalPath::on_squash(int rob_idx) {
+    if (!enabled) {
+        return;
+    }
+    const CritRecord& rec = inflight[rob_idx];
+    if (is_memory_op(rec.type) && last_mem_seq >= rec.seq) {
+        last_mem_seq = rec.mem_pred;
+    }
+}
+
+void CriticalPath::finish() {
+    if (enabled) {
+        analyze();
+    }
+}
+
+const CritRecord* CriticalPath::get_committed(uint64_t n) const {
+    if (n >= commits || n + committed.size() < commits) {
+        return NULL;
+    }
+    return &committed[n % committed.size()];
+}
+
+// Commit order is seq order, so the retained window can be bisected
+int64_t CriticalPath::find_committed(uint64_t seq) const {
+    if (seq == 0 || commits == 0) {
+        return -1;
+    }
+    uint64_t lo = commits > committed.size() ? commits - committed.size() : 0;
+    uint64_t hi = commits;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (committed[mid % committed.size()].seq < seq) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < commits && committed[lo % committed.size()].seq == seq) {
+        return (int64_t)lo;
+    }
+    return -1;
+}
+
+static CritCause latency_cause(InstructionType type) {
+    if (type == MUL) return CRIT_MUL;
+    if (is_memory_op(type)) return CRIT_MEMORY;
+    return CRIT_ALU;
+}
+
+/*
+ * Walk back from the newest retire along the last-arriving edge of every
+ * node until the previous walk's end. Each step charges the edge latency to
+ * the edge's cause and any slack before the node fired to the node's cause,
+ * so the charges add up to the retire cycles covered.
+ */
+void CriticalPath::analyze() {
+    if (commits == analyzed) {
+        return;
+    }
+    uint64_t n = commits - 1;
+    Node node = NODE_RETIRE;
+    uint64_t t = get_committed(n)->retire;
+    uint64_t end = t;
+
+    while (t > boundary) {
+        const CritRecord& rec = *get_committed(n);
+        CritCause own = latency_cause(rec.type);
+        CritCause frontend = rec.redirect ? CRIT_MISPREDICT : CRIT_FRONTEND;
+
+        bool found = false;
+        uint64_t best_n = 0, best_time = 0, best_arrival = 0;
+        Node best_node = NODE_FETCH;
+        CritCause best_cause = CRIT_FRONTEND;
+        CritCause slack_cause = own;
+
+        auto consider = [&](int64_t pn, Node pnode, uint64_t latency, CritCause cause) {
+            const CritRecord* p = pn >= 0 ? get_committed((uint64_t)pn) : NULL;
+            if (!p) return;
+            uint64_t time = 0;
+            switch (pnode) {
+                case NODE_FETCH:    time = p->fetch; break;
+                case NODE_DECODE:   time = p->decode; break;
+                case NODE_DISPATCH: time = p->dispatch; break;
+                case NODE_ISSUE:    time = p->issue; break;
+                case NODE_TAG:      time = p->complete > 0 ? p->complete - 1 : 0; break;
+                case NODE_COMPLETE: time = p->complete; break;
+                case NODE_RETIRE:   time = p->retire; break;
+            }
+            if (!found || time + latency > best_arrival) {
+                found = true;
+                best_n = (uint64_t)pn;
+                best_node = pnode;
+                best_time = time;
+                best_arrival = time + latency;
+                best_cause = cause;
+            }
+        };
+
+        int64_t self = (int64_t)n;
+        int64_t prev = (int64_t)n - 1;
+        switch (node) {
+            case NODE_RETIRE:
+                slack_cause = CRIT_COMMIT;
+                consider(self, NODE_COMPLETE, 1, CRIT_COMMIT);
+                consider(prev, NODE_RETIRE, 0, CRIT_COMMIT);
+                break;
+            case NODE_COMPLETE:
+                if (rec.executes) {
+                    consider(self, NODE_TAG, 1, own);
+                } else {
+                    consider(self, NODE_DISPATCH, 0, CRIT_COMMIT);
+                }
+                break;
+            case NODE_TAG:
+                consider(self, NODE_ISSUE, 0, own);
+                break;
+            case NODE_ISSUE: {
+                // IQ sources wake on the tag, LSQ operands on the value
+                bool mem = is_memory_op(rec.type);
+                slack_cause = CRIT_ISSUE;
+                consider(self, NODE_DISPATCH, 1, CRIT_ISSUE);
+                for (int i = 0; i < 4; i++) {
+                    consider(find_committed(rec.producers[i]), mem ? NODE_COMPLETE : NODE_TAG,
+                             0, CRIT_ISSUE);
+                }
+                if (mem) {
+                    consider(find_committed(rec.mem_pred), NODE_COMPLETE, 0, CRIT_MEMORY);
+                }
+                if (rec.type == STORE) {
+                    consider(prev, NODE_RETIRE, 0, CRIT_MEMORY);  // Issues at the ROB head
+                }
+                break;
+            }
+            case NODE_DISPATCH:
+                slack_cause = CRIT_WINDOW;
+                consider(self, NODE_DECODE, 1, frontend);
+                consider(prev, NODE_DISPATCH, 0, CRIT_FRONTEND);
+                break;
+            case NODE_DECODE:
+                slack_cause = frontend;
+                consider(self, NODE_FETCH, 1, frontend);
+                break;
+            case NODE_FETCH:
+                slack_cause = frontend;
+                if (rec.redirect) {
+                    consider(find_committed(rec.redirect), NODE_TAG, 0, CRIT_MISPREDICT);
+                } else {
+                    consider(prev, NODE_FETCH, 0, CRIT_FRONTEND);
+                }
+                break;
+        }
+
+        if (!found) {
+            cycles[slack_cause] += t - boundary;  // Older than the retained window
+            break;
+        }
+
+        // Slack from arrival to t, then the edge itself, both clipped at boundary
+        uint64_t arrival = best_arrival < t ? best_arrival : t;
+        uint64_t time = best_time < arrival ? best_time : arrival;
+        if (arrival < boundary) arrival = boundary;
+        cycles[slack_cause] += t - arrival;
+        if (arrival > boundary) {
+            cycles[best_cause] += arrival - (time > boundary ? time : boundary);
+        }
+
+        t = time;
+        n = best_n;
+        node = best_node;
+    }
+
+    boundary = end;
+    analyzed = commits;
+}
+
+uint64_t CriticalPath::get_length() const {
+    uint64_t total = 0;
+    for (int i = 0; i < CRIT_CAUSE_COUNT; i++) {
+        total += cycles[i];
+    }
+    return total;
+}
+
+const char* CriticalPath::get_name(CritCause cause) {
+    return crit_names[cause];
+}
+
+void CriticalPath::register_stats(StatsRegistry& stats, const std::string& prefix) const {
+    stats.add_vector(prefix + ".cycles", "Critical path cycles by cause", cycles,
+                     CRIT_CAUSE_COUNT, crit_names);
+}
+
+// The walks tile the run from cycle 0 to the last retire, so the length is
+// the execution time and each share is what that latency costs end to end
+void CriticalPath::print(uint64_t total_cycles) const {
+    if (!enabled) {
+        return;
+    }
+    uint64_t length = get_length();
+    printf("Critical path (%d instruction windows): %lu cycles of %lu\n", window,
+           (unsigned long)length, (unsigned long)total_cycles);
+    if (length == 0) {
+        return;
+    }
+    for (int i = 0; i < CRIT_CAUSE_COUNT; i++) {
+        if (cycles[i] == 0) continue;
+        printf("  %-12s %8lu  %5.1f%%\n", get_name((CritCause)i), (unsigned long)cycles[i],
+               100.0 * cycles[i] / length);
+    }
+}
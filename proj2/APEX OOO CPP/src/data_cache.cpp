@@ -0,0 +1,61 @@
+// src/data_cache.cpp
+#include "data_cache.h"
+#include "stats_registry.h"
+
+DataCache::DataCache(int num_sets, int num_ways, int words_per_line, int miss_cycles) {
+    sets = num_sets > 0 ? num_sets : 0;
+    ways = num_ways > 0 ? num_ways : 1;
+    line_words = words_per_line > 0 ? words_per_line : 1;
+    miss_penalty = miss_cycles;
+    tags.assign(sets * ways, 0);
+    last_use.assign(sets * ways, 0);
+    use_clock = 0;
+    hits[0] = hits[1] = 0;
+    misses[0] = misses[1] = 0;
+}
+
+int DataCache::access(uint32_t address, bool is_store) {
+    if (sets == 0) {
+        return 0;
+    }
+    uint32_t line = address / line_words;
+    int base = (int)(line % sets) * ways;
+    use_clock++;
+
+    int victim = base;
+    for (int w = base; w < base + ways; w++) {
+        if (last_use[w] && tags[w] == line) {
+            last_use[w] = use_clock;
+            hits[is_store]++;
+            return 0;
+        }
+        if (last_use[w] < last_use[victim]) {
+            victim = w;
+        }
+    }
+    tags[victim] = line;
+    last_use[victim] = use_clock;
+    misses[is_store]++;
+    return miss_penalty;
+}
+
+void DataCache::copy_state(const DataCache& other) {
+    if (other.sets != sets || other.ways != ways || other.line_words != line_words) {
+        return;
+    }
+    tags = other.tags;
+    last_use = other.last_use;
+    use_clock = other.use_clock;
+}
+
+void DataCache::register_stats(StatsRegistry& stats, const std::string& prefix) const {
+    stats.add_counter(prefix + ".load_hits", "Loads that hit", &hits[0]);
+    stats.add_counter(prefix + ".load_misses", "Loads that missed", &misses[0]);
+    stats.add_counter(prefix + ".store_hits", "Stores that hit", &hits[1]);
+    stats.add_counter(prefix + ".store_misses", "Stores that missed (write-allocate)",
+                      &misses[1]);
+    stats.add_formula(prefix + ".miss_rate", "misses / accesses", [this]() {
+        uint64_t accesses = get_hits() + get_misses();
+        return accesses ? (double)get_misses() / accesses : 0.0;
+    });
+}
@@ -0,0 +1,356 @@
+// src/design_sweep.cpp
+#include "design_sweep.h"
+#include "apex_cpu.h"
+#include "functional_core.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <time.h>
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Same generator as the SimPoint projection, deterministic on every host
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static double unit_random(uint64_t& state) {
+    state = splitmix64(state);
+    return (double)(state >> 11) / (double)(1ULL << 53);
+}
+
+DesignSweep::DesignSweep(const std::vector<APEX_Instruction>& program, const char* data_path,
+                         const SimConfig& base_config)
+    : code(program), base(base_config) {
+    data_file = data_path;
+    max_insns = 0;
+    max_cycles = 0;
+    stall_limit = 100000;
+    threads = 0;
+    host_seconds = 0.0;
+}
+
+bool DesignSweep::add_param(const char* spec) {
+    const char* eq = strchr(spec, '=');
+    if (!eq || eq == spec) {
+        printf("Sweep: Expected key=values, got '%s'\n", spec);
+        return false;
+    }
+    SweepParam param;
+    param.name.assign(spec, eq - spec);
+    for (size_t i = 0; i < param.name.size(); i++) {
+        if (param.name[i] == '-') param.name[i] = '_';
+    }
+    SimConfig probe = base;
+    if (!probe.set(param.name.c_str(), "1")) {
+        return false;
+    }
+
+    const char* range = eq + 1;
+    char* end;
+    if (strchr(range, ':')) {
+        long lo = strtol(range, &end, 0);
+        long hi = *end == ':' ? strtol(end + 1, &end, 0) : lo - 1;
+        long step = 1;
+        bool geometric = false;
+        if (*end == ':') {
+            geometric = end[1] == '*';
+            step = strtol(end + 1 + geometric, &end, 0);
+        }
+        if (*end != '\0' || hi < lo || step < 1 || step > INT_MAX || lo < INT_MIN ||
+            hi > INT_MAX) {
+            printf("Sweep: Invalid range '%s' for %s\n", range, param.name.c_str());
+            return false;
+        }
+        // A geometric range only grows from a positive start by a factor above 1
+        if (geometric && (lo <= 0 || step < 2)) {
+            printf("Sweep: Geometric range '%s' for %s needs lo > 0 and factor > 1\n", range,
+                   param.name.c_str());
+            return false;
+        }
+        for (long v = lo; v <= hi; v = geometric ? v * step : v + step) {
+            param.values.push_back((int)v);
+            if (geometric ? v > hi / step : v > hi - step) break;  // Next one is past hi
+        }
+    } else {
+        for (const char* p = range; *p; p = *end ? end + 1 : end) {
+            long v = strtol(p, &end, 0);
+            if (end == p || (*end != ',' && *end != '\0')) {
+                printf("Sweep: Invalid value list '%s' for %s\n", range, param.name.c_str());
+                return false;
+            }
+            if (v < INT_MIN || v > INT_MAX) {
+                printf("Sweep: Value %.*s for %s is out of range\n", (int)(end - p), p,
+                       param.name.c_str());
+                return false;
+            }
+            param.values.push_back((int)v);
+        }
+    }
+    if (param.values.empty()) {
+        printf("Sweep: No values for %s\n", param.name.c_str());
+        return false;
+    }
+    params.push_back(param);
+    return true;
+}
+
+SimConfig DesignSweep::config_of(const SweepPoint& point) const {
+    SimConfig config = base;
+    for (size_t p = 0; p < params.size(); p++) {
+        char value[16];
+        snprintf(value, sizeof(value), "%d", params[p].values[point.levels[p]]);
+        config.set(params[p].name.c_str(), value);
+    }
+    return config;
+}
+
+size_t DesignSweep::make_grid() {
+    points.clear();
+    std::vector<int> levels(params.size(), 0);
+    while (true) {
+        SweepPoint point;
+        point.levels = levels;
+        points.push_back(point);
+
+        // Odometer, the last parameter varies fastest
+        int p = (int)params.size() - 1;
+        while (p >= 0 && ++levels[p] == (int)params[p].values.size()) {
+            levels[p--] = 0;
+        }
+        if (p < 0) break;
+    }
+    return points.size();
+}
+
+/*
+ * Every parameter's range is cut into `samples` equal strata and each
+ * stratum is used exactly once, with the strata of different parameters
+ * paired at random (McKay et al.). Few points still cover every level of
+ * every parameter.
+ */
+size_t DesignSweep::make_latin_hypercube(int samples, uint64_t seed) {
+    points.assign(samples > 0 ? samples : 0, SweepPoint());
+    uint64_t state = seed;
+    for (size_t p = 0; p < params.size(); p++) {
+        std::vector<int> strata(points.size());
+        for (size_t i = 0; i < strata.size(); i++) {
+            strata[i] = (int)i;
+        }
+        for (size_t i = strata.size(); i > 1; i--) {
+            std::swap(strata[i - 1], strata[(size_t)(unit_random(state) * i)]);
+        }
+        int count = (int)params[p].values.size();
+        for (size_t i = 0; i < points.size(); i++) {
+            double u = (strata[i] + unit_random(state)) / points.size();
+            points[i].levels.push_back(std::min(count - 1, (int)(u * count)));
+        }
+    }
+    return points.size();
+}
+
+void DesignSweep::simulate(SweepPoint& point) const {
+    double begin = host_now();
+    SimConfig config = config_of(point);
+    FunctionalCore loader(code, config.memory_size);
+    if (data_file) {
+        loader.load_data(data_file);
+    }
+    ArchCheckpoint reset;
+    loader.save_checkpoint(reset);
+
+    APEX_CPU cpu(config);
+    cpu.load_checkpoint(code, reset);
+    uint64_t last_commit_cycle = 0, last_committed = 0;
+    point.stalled = false;
+    while (!cpu.is_halted() && (max_insns == 0 || cpu.get_committed() < max_insns) &&
+           (max_cycles == 0 || cpu.get_cycles() < max_cycles)) {
+        cpu.single_step();
+        if (cpu.get_committed() != last_committed) {
+            last_committed = cpu.get_committed();
+            last_commit_cycle = cpu.get_cycles();
+        } else if (stall_limit > 0 && cpu.get_cycles() - last_commit_cycle >= stall_limit) {
+            point.stalled = true;  // Deadlocked configuration, keep the sweep going
+            break;
+        }
+    }
+    point.halted = cpu.is_halted();
+    point.cycles = cpu.get_cycles();
+    point.committed = cpu.get_committed();
+
+    std::vector<StatValue> values;
+    cpu.get_stats().collect(values);
+    point.stats.assign(stat_names.size(), 0.0);
+    point.found.assign(stat_names.size(), false);
+    for (size_t s = 0; s < stat_names.size(); s++) {
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i].name == stat_names[s]) {
+                point.stats[s] = values[i].value;
+                point.found[s] = true;
+                break;
+            }
+        }
+    }
+    point.host_seconds = host_now() - begin;
+}
+
+void DesignSweep::run(int jobs) {
+    // Invalid points are reported once here, not from the workers
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i].valid = config_of(points[i]).validate();
+        points[i].halted = false;
+        points[i].stalled = false;
+        points[i].cycles = 0;
+        points[i].committed = 0;
+        points[i].host_seconds = 0.0;
+        if (points[i].valid) {
+            todo.push_back(i);
+        } else {
+            printf("Sweep: Skipping point %d\n", (int)i);
+        }
+    }
+
+    if (jobs <= 0) {
+        jobs = (int)std::thread::hardware_concurrency();
+    }
+    threads = std::max(1, std::min(jobs, (int)todo.size()));
+    std::atomic<size_t> next(0);
+    auto worker = [this, &next, &todo]() {
+        for (size_t i = next++; i < todo.size(); i = next++) {
+            simulate(points[todo[i]]);
+        }
+    };
+    double begin = host_now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+    host_seconds = host_now() - begin;
+    for (size_t i = 0; i < todo.size(); i++) {
+        if (points[todo[i]].stalled) {
+            printf("Sweep: Point %d stopped, no commit for %lu cycles\n", (int)todo[i],
+                   (unsigned long)stall_limit);
+        }
+    }
+}
+
+// A stalled point's IPC is a partial, deadlocked run, it is never best
+void DesignSweep::print_summary(FILE* out) const {
+    int valid = 0, stalled = 0, best = -1;
+    double best_ipc = 0.0;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!points[i].valid) continue;
+        valid++;
+        if (points[i].stalled) {
+            stalled++;
+            continue;
+        }
+        double ipc = points[i].cycles ? (double)points[i].committed / points[i].cycles : 0.0;
+        if (best < 0 || ipc > best_ipc) {
+            best = (int)i;
+            best_ipc = ipc;
+        }
+    }
+    fprintf(out, "Sweep: %d of %d points simulated, %d stalled, %d threads, %.3f s\n", valid,
+            (int)points.size(), stalled, threads, host_seconds);
+    if (best < 0) {
+        return;
+    }
+    fprintf(out, "Best IPC %.4f at point %d:", best_ipc, best);
+    for (size_t p = 0; p < params.size(); p++) {
+        fprintf(out, " %s=%d", params[p].name.c_str(), params[p].values[points[best].levels[p]]);
+    }
+    fprintf(out, "\n");
+}
+
+bool DesignSweep::write(FILE* out, bool json) const {
+    if (json) {
+        fprintf(out, "[");
+    } else {
+        fprintf(out, "point");
+        for (size_t p = 0; p < params.size(); p++) {
+            fprintf(out, ",%s", params[p].name.c_str());
+        }
+        fprintf(out, ",halted,stalled,cycles,committed,ipc,host_seconds");
+        for (size_t s = 0; s < stat_names.size(); s++) {
+            fprintf(out, ",%s", stat_names[s].c_str());
+        }
+        fprintf(out, "\n");
+    }
+
+    bool first = true;
+    for (size_t i = 0; i < points.size(); i++) {
+        const SweepPoint& point = points[i];
+        if (!point.valid) continue;
+        double ipc = point.cycles ? (double)point.committed / point.cycles : 0.0;
+        if (json) {
+            fprintf(out, "%s\n  {\"point\": %d", first ? "" : ",", (int)i);
+            for (size_t p = 0; p < params.size(); p++) {
+                fprintf(out, ", \"%s\": %d", params[p].name.c_str(),
+                        params[p].values[point.levels[p]]);
+            }
+            fprintf(out, ", \"halted\": %s, \"stalled\": %s, \"cycles\": %lu, "
+                    "\"committed\": %lu, \"ipc\": %.6g, \"host_seconds\": %.6g",
+                    point.halted ? "true" : "false", point.stalled ? "true" : "false",
+                    (unsigned long)point.cycles, (unsigned long)point.committed, ipc,
+                    point.host_seconds);
+            for (size_t s = 0; s < stat_names.size(); s++) {
+                if (point.found[s]) {
+                    fprintf(out, ", \"%s\": %.6g", stat_names[s].c_str(), point.stats[s]);
+                } else {
+                    fprintf(out, ", \"%s\": null", stat_names[s].c_str());
+                }
+            }
+            fprintf(out, "}");
+        } else {
+            fprintf(out, "%d", (int)i);
+            for (size_t p = 0; p < params.size(); p++) {
+                fprintf(out, ",%d", params[p].values[point.levels[p]]);
+            }
+            fprintf(out, ",%d,%d,%lu,%lu,%.6g,%.6g", point.halted, point.stalled,
+                    (unsigned long)point.cycles,
+                    (unsigned long)point.committed, ipc, point.host_seconds);
+            for (size_t s = 0; s < stat_names.size(); s++) {
+                if (point.found[s]) {
+                    fprintf(out, ",%.6g", point.stats[s]);
+                } else {
+                    fprintf(out, ",");  // Not registered in this configuration
+                }
+            }
+            fprintf(out, "\n");
+        }
+        first = false;
+    }
+    if (json) {
+        fprintf(out, "\n]\n");
+    }
+    return true;
+}
+
+bool DesignSweep::write_file(const char* path) const {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        printf("Error: Unable to open sweep results file %s\n", path);
+        return false;
+    }
+    size_t len = strlen(path);
+    bool json = !(len >= 4 && strcmp(path + len - 4, ".csv") == 0);
+    write(out, json);
+    fclose(out);
+    return true;
+}
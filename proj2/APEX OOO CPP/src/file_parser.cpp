@@ -0,0 +1,236 @@
+// src/file_parser.cpp
+#include "file_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Extracts the number from an operand such as "#-16"
+static int get_num_from_string(const char* token) {
+    return token[0] ? atoi(token + 1) : 0;
+}
+
+// A register operand is R0..R31 with nothing after the number
+static bool get_register(const char* token, uint32_t& reg) {
+    char* end = NULL;
+    long value = -1;
+    if (token[0] == 'R' && token[1] >= '0' && token[1] <= '9') {
+        value = strtol(token + 1, &end, 10);
+    }
+    if (value < 0 || value >= 32 || *end != '\0') {
+        printf("Bad register operand: '%s'\n", token);
+        return false;
+    }
+    reg = (uint32_t)value;
+    return true;
+}
+
+struct OpcodeInfo {
+    const char* mnemonic;
+    InstructionType type;
+};
+
+static const OpcodeInfo opcode_table[] = {
+    {"ADD", INT_ADD},   {"SUB", INT_SUB},   {"MUL", MUL},
+    {"AND", INT_AND},   {"OR", INT_OR},     {"EXOR", INT_XOR},
+    {"XOR", INT_XOR},   {"LTR", INT_LTR},   {"ADDL", INT_ADD},
+    {"SUBL", INT_SUB},  {"MOVC", MOVC},     {"LOAD", LOAD},
+    {"LDR", LOAD},      {"STORE", STORE},   {"STR", STORE},
+    {"CMP", CMP},       {"CML", CML},       {"BZ", BZ},
+    {"BNZ", BNZ},       {"BP", BP},         {"BNP", BNP},
+    {"BN", BN},         {"JUMP", JUMP},     {"JALR", JALR},
+    {"JALP", JALP},     {"RET", RET},       {"NOP", NOP},
+    {"HALT", HALT}
+};
+
+static bool set_opcode(APEX_Instruction& ins, const char* opcode_str) {
+    for (size_t i = 0; i < sizeof(opcode_table) / sizeof(opcode_table[0]); i++) {
+        if (strcmp(opcode_str, opcode_table[i].mnemonic) == 0) {
+            ins.type = opcode_table[i].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Creates an APEX instruction from one line of assembly
+static bool create_APEX_instruction(APEX_Instruction& ins, char* buffer) {
+    char tokens[4][32];
+    int token_num = 0;
+
+    for (int i = 0; i < 4; i++) {
+        tokens[i][0] = '\0';
+    }
+    ins.rd = ins.rs1 = ins.rs2 = ins.rs3 = REG_NONE;
+    ins.imm = 0;
+    ins.opcode_str[0] = '\0';
+
+    // Opcode is separated from the operand list by a space
+    char* opcode = strtok(buffer, " \t\r\n");
+    if (opcode == NULL) {
+        return false;
+    }
+    char* operands = strtok(NULL, " \t\r\n");
+
+    strncpy(ins.opcode_str, opcode, sizeof(ins.opcode_str) - 1);
+    ins.opcode_str[sizeof(ins.opcode_str) - 1] = '\0';
+    if (!set_opcode(ins, ins.opcode_str)) {
+        printf("Unknown opcode: %s\n", ins.opcode_str);
+        return false;
+    }
+
+    char* token = operands ? strtok(operands, ",") : NULL;
+    while (token != NULL && token_num < 4) {
+        strncpy(tokens[token_num], token, sizeof(tokens[0]) - 1);
+        tokens[token_num][sizeof(tokens[0]) - 1] = '\0';
+        token_num++;
+        token = strtok(NULL, ",");
+    }
+
+    const char* mnemonic = ins.opcode_str;
+    bool ok = true;
+    switch (ins.type) {
+        case INT_ADD:
+        case INT_SUB:
+            ok = ok && get_register(tokens[0], ins.rd);
+            if (tokens[1][0] == '#') {  // Short form "ADDL Rd,#imm" updates Rd in place
+                ins.rs1 = ins.rd;
+                ins.imm = get_num_from_string(tokens[1]);
+                break;
+            }
+            ok = ok && get_register(tokens[1], ins.rs1);
+            if (tokens[2][0] == '#') {  // ADDL/SUBL
+                ins.imm = get_num_from_string(tokens[2]);
+            } else {
+                ok = ok && get_register(tokens[2], ins.rs2);
+            }
+            break;
+
+        case MUL:
+        case INT_AND:
+        case INT_OR:
+        case INT_XOR:
+        case INT_LTR:
+            ok = ok && get_register(tokens[0], ins.rd);
+            ok = ok && get_register(tokens[1], ins.rs1);
+            ok = ok && get_register(tokens[2], ins.rs2);
+            break;
+
+        case MOVC:
+            ok = ok && get_register(tokens[0], ins.rd);
+            ins.imm = get_num_from_string(tokens[1]);
+            break;
+
+        case LOAD:
+            ok = ok && get_register(tokens[0], ins.rd);
+            ok = ok && get_register(tokens[1], ins.rs1);
+            if (strcmp(mnemonic, "LDR") == 0) {
+                ok = ok && get_register(tokens[2], ins.rs2);
+            } else {
+                ins.imm = get_num_from_string(tokens[2]);
+            }
+            break;
+
+        case STORE:
+            // rs1 holds the data, rs2 the base address
+            ok = ok && get_register(tokens[0], ins.rs1);
+            ok = ok && get_register(tokens[1], ins.rs2);
+            if (strcmp(mnemonic, "STR") == 0) {
+                ok = ok && get_register(tokens[2], ins.rs3);
+            } else {
+                ins.imm = get_num_from_string(tokens[2]);
+            }
+            break;
+
+        case CMP:
+            ok = ok && get_register(tokens[0], ins.rs1);
+            ok = ok && get_register(tokens[1], ins.rs2);
+            break;
+
+        case CML:
+            ok = ok && get_register(tokens[0], ins.rs1);
+            ins.imm = get_num_from_string(tokens[1]);
+            break;
+
+        case BZ:
+        case BNZ:
+        case BP:
+        case BNP:
+        case BN:
+            ins.imm = get_num_from_string(tokens[0]);
+            break;
+
+        case JUMP:
+            ok = ok && get_register(tokens[0], ins.rs1);
+            ins.imm = get_num_from_string(tokens[1]);
+            break;
+
+        case JALR:
+            ok = ok && get_register(tokens[0], ins.rd);
+            ok = ok && get_register(tokens[1], ins.rs1);
+            ins.imm = get_num_from_string(tokens[2]);
+            break;
+
+        case JALP:
+            ok = ok && get_register(tokens[0], ins.rd);
+            ins.imm = get_num_from_string(tokens[1]);
+            break;
+
+        case RET:
+            ok = ok && get_register(tokens[0], ins.rs1);
+            break;
+
+        default:
+            break;
+    }
+    return ok;
+}
+
+bool create_code_memory(const char* filename, std::vector<APEX_Instruction>& code) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Error: Unable to open file %s\n", filename);
+        return false;
+    }
+
+    code.clear();
+    char line[256];
+    int line_num = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_num++;
+
+        // Skip blank lines
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\n' || *p == '\r' || *p == '\0') {
+            continue;
+        }
+
+        APEX_Instruction ins;
+        if (!create_APEX_instruction(ins, p)) {
+            printf("Error: Invalid instruction at %s:%d\n", filename, line_num);
+            fclose(fp);
+            return false;
+        }
+        code.push_back(ins);
+    }
+
+    fclose(fp);
+    return !code.empty();
+}
+
+int load_data_memory(const char* filename, uint32_t* memory, int size) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Error: Unable to open file %s\n", filename);
+        return -1;
+    }
+
+    int address = 0;
+    int value;
+    while (address < size && fscanf(fp, "%d,", &value) == 1) {
+        memory[address++] = (uint32_t)value;
+    }
+
+    fclose(fp);
+    return address;
+}
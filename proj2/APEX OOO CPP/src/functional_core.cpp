@@ -0,0 +1,307 @@
+// src/functional_core.cpp
+#include "functional_core.h"
+
+FunctionalCore::FunctionalCore(const std::vector<APEX_Instruction>& program, int memory_words)
+    : code(&program)
+{
+    for (int i = 0; i < 34; i++) {
+        regs[i] = 0;
+    }
+    cc = 0;
+    pc = CODE_BASE_ADDRESS;
+    memory.assign(memory_words, 0);
+    halted = false;
+    retired = 0;
+    translate_threshold = 0;
+    translated = 0;
+}
+
+int FunctionalCore::load_data(const char* filename) {
+    return load_data_memory(filename, memory.data(), (int)memory.size());
+}
+
+uint8_t FunctionalCore::flags_of(uint32_t value) {
+    if (value == 0) return CC_ZERO;
+    return (int32_t)value < 0 ? CC_NEGATIVE : CC_POSITIVE;
+}
+
+// Operands follow the issue stage: src2 is rs2 when present, else the literal
+bool FunctionalCore::step(FunctionalStep& out) {
+    size_t index = (pc - CODE_BASE_ADDRESS) / 4;  // Wraps past the end below the base
+    if (halted || pc < CODE_BASE_ADDRESS || index >= code->size()) {
+        halted = true;
+        return false;
+    }
+    const APEX_Instruction& insn = (*code)[index];
+    uint32_t s1 = read_reg(insn.rs1);
+    uint32_t s2 = insn.rs2 != REG_NONE ? read_reg(insn.rs2) : (uint32_t)insn.imm;
+    uint32_t next_pc = pc + 4;
+
+    out.pc = pc;
+    out.type = insn.type;
+    out.taken = false;
+    out.address = 0;
+
+    switch (insn.type) {
+        case INT_ADD:
+            regs[insn.rd] = s1 + s2;
+            cc = flags_of(regs[insn.rd]);
+            break;
+        case INT_SUB:
+            regs[insn.rd] = s1 - s2;
+            cc = flags_of(regs[insn.rd]);
+            break;
+        case MUL:
+            regs[insn.rd] = s1 * s2;
+            cc = flags_of(regs[insn.rd]);
+            break;
+        case CMP:
+        case CML:
+            cc = flags_of(s1 - s2);
+            break;
+        case INT_AND: regs[insn.rd] = s1 & s2; break;
+        case INT_OR:  regs[insn.rd] = s1 | s2; break;
+        case INT_XOR: regs[insn.rd] = s1 ^ s2; break;
+        case INT_LTR: regs[insn.rd] = (int32_t)s1 < (int32_t)s2 ? 1 : 0; break;
+        case MOVC:    regs[insn.rd] = s2; break;
+
+        case LOAD: {
+            // LOAD rd,base,#imm / LDR rd,base,rs2
+            out.address = s1 + s2;
+            regs[insn.rd] = out.address < memory.size() ? memory[out.address] : 0;
+            break;
+        }
+        case STORE: {
+            // STORE data,base,#imm / STR data,base,rs3
+            uint32_t offset = insn.rs3 != REG_NONE ? read_reg(insn.rs3) : (uint32_t)insn.imm;
+            out.address = read_reg(insn.rs2) + offset;
+            if (out.address < memory.size()) memory[out.address] = s1;
+            break;
+        }
+
+        case BZ:  out.taken = (cc & CC_ZERO) != 0; break;
+        case BNZ: out.taken = (cc & CC_ZERO) == 0; break;
+        case BP:  out.taken = (cc & CC_POSITIVE) != 0; break;
+        case BNP: out.taken = (cc & CC_POSITIVE) == 0; break;
+        case BN:  out.taken = (cc & CC_NEGATIVE) != 0; break;
+        case JALP:
+            regs[insn.rd] = pc + 4;
+            next_pc = pc + insn.imm;
+            out.taken = true;
+            break;
+        case JALR:
+            next_pc = s1 + insn.imm;
+            regs[insn.rd] = pc + 4;
+            out.taken = true;
+            break;
+        case JUMP:
+            next_pc = s1 + insn.imm;
+            out.taken = true;
+            break;
+        case RET:
+            next_pc = s1;
+            out.taken = true;
+            break;
+        case HALT:
+            halted = true;
+            break;
+        default:
+            break;
+    }
+    if (is_conditional_branch(insn.type) && out.taken) {
+        next_pc = pc + insn.imm;
+    }
+
+    out.next_pc = next_pc;
+    pc = next_pc;
+    retired++;
+    return true;
+}
+
+void FunctionalCore::save_checkpoint(ArchCheckpoint& checkpoint) const {
+    checkpoint.insns = retired;
+    checkpoint.pc = pc;
+    for (int i = 0; i < 32; i++) {
+        checkpoint.regs[i] = regs[i];
+    }
+    checkpoint.cc = cc;
+    checkpoint.halted = halted;
+    checkpoint.memory = memory;
+}
+
+void FunctionalCore::restore_checkpoint(const ArchCheckpoint& checkpoint) {
+    retired = checkpoint.insns;
+    pc = checkpoint.pc;
+    for (int i = 0; i < 32; i++) {
+        regs[i] = checkpoint.regs[i];
+    }
+    cc = checkpoint.cc;
+    halted = checkpoint.halted;
+    memory = checkpoint.memory;
+}
+
+void FunctionalCore::enable_translation(uint32_t hot_threshold) {
+    translate_threshold = hot_threshold;
+    translator.reset(hot_threshold > 0 ? new BlockTranslator(*code, hot_threshold) : NULL);
+}
+
+void FunctionalCore::load_program(const std::vector<APEX_Instruction>& program) {
+    code = &program;
+    invalidate_decoded();
+}
+
+void FunctionalCore::invalidate_decoded() {
+    decoded.clear();
+    superblock_end.clear();
+    enable_translation(translate_threshold);
+}
+
+static uint8_t decode_reg(uint32_t reg) {
+    return reg < 32 ? (uint8_t)reg : 32;
+}
+
+void FunctionalCore::decode_program() {
+    decoded.resize(code->size());
+    for (size_t i = 0; i < code->size(); i++) {
+        const APEX_Instruction& insn = (*code)[i];
+        DecodedInsn& d = decoded[i];
+        d.type = insn.type;
+        d.rd = decode_reg(insn.rd);
+        d.rs1 = decode_reg(insn.rs1);
+        d.src2 = insn.rs2 != REG_NONE || insn.type == STORE ? decode_reg(insn.rs2) : 33;
+        d.offset = insn.rs3 != REG_NONE ? decode_reg(insn.rs3) : 33;
+        d.imm = (uint32_t)insn.imm;
+    }
+    superblock_end.assign(code->size(), 0);
+}
+
+/*
+ * Executes up to budget instructions of the superblock at pc, the same
+ * work as step() without the per-instruction PC checks and FunctionalStep
+ * records. 0 when pc is not an instruction slot, for step() to handle.
+ */
+uint64_t FunctionalCore::run_superblock(uint64_t budget) {
+    uint32_t offset = pc - CODE_BASE_ADDRESS;
+    size_t first = offset / 4;
+    if (pc < CODE_BASE_ADDRESS || offset % 4 != 0 || first >= decoded.size()) {
+        return 0;
+    }
+    uint32_t& end = superblock_end[first];
+    if (end == 0) {
+        end = (uint32_t)first;
+        while (end < decoded.size()) {
+            InstructionType type = decoded[end++].type;
+            if (is_control_op(type) || type == HALT) break;
+        }
+    }
+    size_t last = end;
+    if (budget < last - first) {
+        last = first + budget;
+    }
+
+    uint32_t next_pc = CODE_BASE_ADDRESS + 4 * (uint32_t)last;
+    for (size_t i = first; i < last; i++) {
+        const DecodedInsn& d = decoded[i];
+        regs[33] = d.imm;
+        uint32_t s1 = regs[d.rs1];
+        uint32_t s2 = regs[d.src2];
+        switch (d.type) {
+            case INT_ADD: regs[d.rd] = s1 + s2; cc = flags_of(s1 + s2); break;
+            case INT_SUB: regs[d.rd] = s1 - s2; cc = flags_of(s1 - s2); break;
+            case MUL:     regs[d.rd] = s1 * s2; cc = flags_of(s1 * s2); break;
+            case CMP:
+            case CML:     cc = flags_of(s1 - s2); break;
+            case INT_AND: regs[d.rd] = s1 & s2; break;
+            case INT_OR:  regs[d.rd] = s1 | s2; break;
+            case INT_XOR: regs[d.rd] = s1 ^ s2; break;
+            case INT_LTR: regs[d.rd] = (int32_t)s1 < (int32_t)s2 ? 1 : 0; break;
+            case MOVC:    regs[d.rd] = s2; break;
+            case LOAD: {
+                uint32_t address = s1 + s2;
+                regs[d.rd] = address < memory.size() ? memory[address] : 0;
+                break;
+            }
+            case STORE: {
+                uint32_t address = regs[d.src2] + regs[d.offset];
+                if (address < memory.size()) memory[address] = s1;
+                break;
+            }
+
+            // Only the last instruction of a superblock moves the PC
+            case BZ:  if (cc & CC_ZERO) next_pc = next_pc - 4 + d.imm; break;
+            case BNZ: if (!(cc & CC_ZERO)) next_pc = next_pc - 4 + d.imm; break;
+            case BP:  if (cc & CC_POSITIVE) next_pc = next_pc - 4 + d.imm; break;
+            case BNP: if (!(cc & CC_POSITIVE)) next_pc = next_pc - 4 + d.imm; break;
+            case BN:  if (cc & CC_NEGATIVE) next_pc = next_pc - 4 + d.imm; break;
+            case JALP:
+                regs[d.rd] = next_pc;
+                next_pc = next_pc - 4 + d.imm;
+                break;
+            case JALR:
+                regs[d.rd] = next_pc;
+                next_pc = s1 + d.imm;
+                break;
+            case JUMP:    next_pc = s1 + d.imm; break;
+            case RET:     next_pc = s1; break;
+            case HALT:    halted = true; break;
+            default:
+                break;
+        }
+        regs[32] = 0;
+    }
+    pc = next_pc;
+    retired += last - first;
+    return last - first;
+}
+
+// The hot block at pc as host code, 0 when cold or longer than the budget
+uint64_t FunctionalCore::run_translated_block(uint64_t budget) {
+    TranslatedBlock block = translator->lookup(pc);
+    if (!block) {
+        return 0;
+    }
+    TranslatedContext context;
+    for (int i = 0; i < 32; i++) {
+        context.regs[i] = regs[i];
+    }
+    context.pc = pc;
+    context.cc = cc;
+    context.memory = memory.data();
+    context.memory_words = (uint32_t)memory.size();
+    context.budget = budget < (uint64_t)INT64_MAX ? (int64_t)budget : INT64_MAX;
+    int64_t start = context.budget;
+    block(&context);
+    for (int i = 0; i < 32; i++) {
+        regs[i] = context.regs[i];
+    }
+    pc = context.pc;
+    cc = context.cc;
+    uint64_t done = (uint64_t)(start - context.budget);
+    retired += done;
+    translated += done;
+    return done;
+}
+
+// Every iteration starts at a block entry: superblocks and translated
+// blocks both end at a control transfer
+uint64_t FunctionalCore::run(uint64_t max_insns) {
+    if (decoded.empty()) {
+        decode_program();  // Again only after load_program
+    }
+    bool translate = translator && translator->is_available();
+    FunctionalStep step_info;
+    uint64_t executed = 0;
+    while ((max_insns == 0 || executed < max_insns) && !halted) {
+        uint64_t budget = max_insns ? max_insns - executed : UINT64_MAX;
+        uint64_t done = translate ? run_translated_block(budget) : 0;
+        if (done == 0) {
+            done = run_superblock(budget);
+        }
+        if (done == 0) {
+            if (!step(step_info)) break;
+            done = 1;
+        }
+        executed += done;
+    }
+    return executed;
+}
@@ -0,0 +1,40 @@
+// src/functional_warmer.cpp
+#include "functional_warmer.h"
+#include "apex_cpu.h"
+
+FunctionalWarmer::FunctionalWarmer(const std::vector<APEX_Instruction>& program,
+                                   const SimConfig& config)
+    : code(program)
+    , predictor(config.predictor_size, config.ras_size)
+    , dcache(config.dcache_sets, config.dcache_ways, config.dcache_line,
+             config.dcache_miss_penalty) {
+    warmed = 0;
+    branches = 0;
+    accesses = 0;
+}
+
+void FunctionalWarmer::observe(const FunctionalStep& step) {
+    warmed++;
+    if (is_control_op(step.type)) {
+        const APEX_Instruction& insn = code[(step.pc - CODE_BASE_ADDRESS) / 4];
+        predictor.train(step.pc, step.type, insn.imm, step.taken, step.next_pc);
+        branches++;
+    } else if (step.type == LOAD || step.type == STORE) {
+        dcache.access(step.address, step.type == STORE);
+        accesses++;
+    }
+}
+
+uint64_t FunctionalWarmer::run(FunctionalCore& core, uint64_t max_insns) {
+    FunctionalStep step;
+    uint64_t done = 0;
+    while (done < max_insns && core.step(step)) {
+        observe(step);
+        done++;
+    }
+    return done;
+}
+
+void FunctionalWarmer::apply(APEX_CPU& cpu) const {
+    cpu.load_warm_state(predictor, dcache);
+}
@@ -1,16 +1,20 @@
 // src/int_fu.cpp
 #include "int_fu.h"
+#include "apex_log.h"
 #include <stdio.h>
 
 IntegerFU::IntegerFU(ControlPredictor& pred_ref) 
     : predictor(pred_ref), busy(false), executing(false) {
+    src1_tag = src2_tag = REG_NONE;
+    src1_is_cc = false;
 }
 
 bool IntegerFU::can_accept() {
     return !busy;
 }
 
-bool IntegerFU::issue(uint32_t pc, InstructionType op, uint32_t s1, uint32_t s2, uint32_t rob_idx) {
+bool IntegerFU::issue(uint32_t pc, InstructionType op, uint32_t s1, uint32_t s2, uint32_t rob_idx,
+                      uint32_t s1_tag, uint32_t s2_tag, bool s1_is_cc) {
     if (busy) {
         return false;
     }
@@ -20,14 +24,32 @@ bool IntegerFU::issue(uint32_t pc, InstructionType op, uint32_t s1, uint32_t s2,
     src2_value = s2;
     op_type = op;
     rob_index = rob_idx;
+    src1_tag = s1_tag;
+    src2_tag = s2_tag;
+    src1_is_cc = s1_is_cc;
     busy = true;
     executing = false;
 
-    printf("IntFU: Issued %d operation, PC=0x%x, src1=0x%x, src2=0x%x\n",
+    APEX_DEBUG(LOG_INTFU, "IntFU: Issued %d operation, PC=0x%x, src1=0x%x, src2=0x%x\n",
            op_type, current_pc, src1_value, src2_value);
     return true;
 }
 
+// Late operands arrive on the value broadcast, before this cycle's execute
+void IntegerFU::on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) {
+    if (!busy) {
+        return;
+    }
+    if (src1_tag == tag && src1_is_cc == is_cc) {
+        src1_value = value;
+        src1_tag = REG_NONE;
+    }
+    if (src2_tag == tag && !is_cc) {
+        src2_value = value;
+        src2_tag = REG_NONE;
+    }
+}
+
 uint8_t IntegerFU::calculate_flags(uint32_t result) {
     uint8_t flags = 0;
     if (result == 0) flags |= 0x4;  // Zero flag
@@ -43,12 +65,12 @@ uint32_t IntegerFU::calculate_branch_target(uint32_t pc, int32_t offset) {
 IntFUResult IntegerFU::execute() {
     IntFUResult result = {0};
     
-    if (!busy || executing) {
+    if (!busy || executing || !operands_ready()) {
         return result;
     }
 
     executing = true;
-    printf("IntFU: Executing operation type %d\n", op_type);
+    APEX_TRACE(LOG_INTFU, "IntFU: Executing operation type %d\n", op_type);
 
     // Declare variables outside switch to avoid crossing initialization
     uint32_t target;
@@ -82,37 +104,98 @@ IntFUResult IntegerFU::execute() {
             }
 
             result.mispredicted = (taken != predictor.was_predicted_taken(current_pc));
+            result.taken = taken;
+            result.target = taken ? target : current_pc + 4;
+            break;
+        }
+
+        case BZ:
+        case BNZ:
+        case BP:
+        case BNP:
+        case BN: {
+            // src1 carries the CC flags, src2 the branch offset
+            target = calculate_branch_target(current_pc, (int32_t)src2_value);
+            if (op_type == BZ) taken = (src1_value & CC_ZERO) != 0;
+            else if (op_type == BNZ) taken = (src1_value & CC_ZERO) == 0;
+            else if (op_type == BP) taken = (src1_value & CC_POSITIVE) != 0;
+            else if (op_type == BNP) taken = (src1_value & CC_POSITIVE) == 0;
+            else taken = (src1_value & CC_NEGATIVE) != 0;
+
+            result.taken = taken;
             result.target = taken ? target : current_pc + 4;
             break;
         }
 
         case JALP: {
+            // Return address stack is pushed by fetch when the call is predicted
             result.target = calculate_branch_target(current_pc, (int32_t)src2_value);
             result.value = current_pc + 4;  // Return address
-            predictor.push_return_address(result.value);
+            result.taken = true;
+            break;
+        }
+
+        case JALR: {
+            result.target = src1_value + src2_value;
+            result.value = current_pc + 4;  // Return address
+            result.taken = true;
+            break;
+        }
+
+        case JUMP: {
+            result.target = src1_value + src2_value;
+            result.taken = true;
             break;
         }
 
         case RET: {
             result.target = src1_value;  // Return address from register
+            result.taken = true;
             break;
         }
 
+        case CMP:
+        case CML:
+            result.value = src1_value - src2_value;
+            result.cc_modified = true;
+            result.cc_flags = calculate_flags(result.value);
+            break;
+
+        case INT_AND:
+            result.value = src1_value & src2_value;
+            break;
+
+        case INT_OR:
+            result.value = src1_value | src2_value;
+            break;
+
+        case INT_XOR:
+            result.value = src1_value ^ src2_value;
+            break;
+
+        case INT_LTR:
+            result.value = ((int32_t)src1_value < (int32_t)src2_value) ? 1 : 0;
+            break;
+
+        case MOVC:
+            result.value = src2_value;
+            break;
+
         // Handle other instruction types...
         case INT:
         case MUL:
         case LOAD:
         case STORE:
-        case CMP:
-        case CML:
         case ADD:
-            printf("IntFU: Unsupported operation type %d\n", op_type);
+        case NOP:
+        case HALT:
+            APEX_WARN(LOG_INTFU, "IntFU: Unsupported operation type %d\n", op_type);
             break;
     }
 
     busy = false;
     executing = false;
-    printf("IntFU: Completed operation, result=0x%x\n", result.value);
+    APEX_DEBUG(LOG_INTFU, "IntFU: Completed operation, result=0x%x\n", result.value);
     return result;
 }
 
@@ -0,0 +1,142 @@
+// src/interval_stats.cpp
+#include "interval_stats.h"
+#include <string.h>
+
+IntervalStats::IntervalStats() {
+    registry = NULL;
+    out = NULL;
+    csv = true;
+    period = 0;
+    by_insns = false;
+    next_boundary = 0;
+    intervals = 0;
+}
+
+IntervalStats::~IntervalStats() {
+    if (out) {
+        fclose(out);
+    }
+}
+
+void IntervalStats::add_rate(const char* name, const char* numerator, const char* denominator,
+                             double scale) {
+    IntervalRate rate;
+    rate.name = name;
+    rate.numerator = numerator;
+    rate.denominator = denominator;
+    rate.scale = scale;
+    rate.num_index = -1;
+    rate.den_index = -1;
+    rates.push_back(rate);
+}
+
+bool IntervalStats::open(const char* path, const StatsRegistry* registry, uint64_t period,
+                         bool by_insns) {
+    if (period == 0) {
+        printf("Error: Interval length must be greater than zero\n");
+        return false;
+    }
+    out = fopen(path, "w");
+    if (!out) {
+        printf("Error: Unable to open interval stats file %s\n", path);
+        return false;
+    }
+    size_t len = strlen(path);
+    csv = len >= 4 && strcmp(path + len - 4, ".csv") == 0;
+
+    this->registry = registry;
+    this->period = period;
+    this->by_insns = by_insns;
+    next_boundary = period;
+    intervals = 0;
+
+    // Value positions are fixed once the registry is complete
+    registry->collect(previous);
+    for (size_t r = 0; r < rates.size(); r++) {
+        for (size_t i = 0; i < previous.size(); i++) {
+            if (!previous[i].is_counter) continue;
+            if (previous[i].name == rates[r].numerator) rates[r].num_index = (int)i;
+            if (previous[i].name == rates[r].denominator) rates[r].den_index = (int)i;
+        }
+    }
+    write_header();
+    return true;
+}
+
+void IntervalStats::close(uint64_t cycle, uint64_t committed) {
+    if (!out) {
+        return;
+    }
+    // Flush the partial last interval
+    registry->collect(current);
+    for (size_t i = 0; i < current.size() && i < previous.size(); i++) {
+        if (current[i].is_counter && current[i].value != previous[i].value) {
+            write_row(cycle, committed);
+            break;
+        }
+    }
+    if (!csv) {
+        fprintf(out, "\n]\n");
+    }
+    fclose(out);
+    out = NULL;
+}
+
+void IntervalStats::write_header() {
+    if (!csv) {
+        fprintf(out, "[");
+        return;
+    }
+    fprintf(out, "interval,end_cycle,end_committed");
+    for (size_t r = 0; r < rates.size(); r++) {
+        fprintf(out, ",%s", rates[r].name.c_str());
+    }
+    for (size_t i = 0; i < previous.size(); i++) {
+        if (previous[i].is_counter) {
+            fprintf(out, ",%s", previous[i].name.c_str());
+        }
+    }
+    fprintf(out, "\n");
+}
+
+void IntervalStats::write_row(uint64_t cycle, uint64_t committed) {
+    registry->collect(current);
+
+    if (csv) {
+        fprintf(out, "%lu,%lu,%lu", (unsigned long)intervals, (unsigned long)cycle,
+                (unsigned long)committed);
+    } else {
+        fprintf(out, "%s\n  {\"interval\": %lu, \"end_cycle\": %lu, \"end_committed\": %lu",
+                intervals ? "," : "", (unsigned long)intervals, (unsigned long)cycle,
+                (unsigned long)committed);
+    }
+
+    for (size_t r = 0; r < rates.size(); r++) {
+        const IntervalRate& rate = rates[r];
+        double value = 0.0;
+        if (rate.num_index >= 0 && rate.den_index >= 0) {
+            double num = current[rate.num_index].value - previous[rate.num_index].value;
+            double den = current[rate.den_index].value - previous[rate.den_index].value;
+            value = den > 0.0 ? rate.scale * num / den : 0.0;
+        }
+        if (csv) {
+            fprintf(out, ",%.6g", value);
+        } else {
+            fprintf(out, ", \"%s\": %.6g", rate.name.c_str(), value);
+        }
+    }
+
+    for (size_t i = 0; i < current.size(); i++) {
+        if (!current[i].is_counter) continue;
+        double delta = current[i].value - previous[i].value;
+        if (csv) {
+            fprintf(out, ",%.0f", delta);
+        } else {
+            fprintf(out, ", \"%s\": %.0f", current[i].name.c_str(), delta);
+        }
+    }
+    fprintf(out, csv ? "\n" : "}");
+
+    previous.swap(current);
+    intervals++;
+}
@@ -0,0 +1,116 @@
+// src/issue_queue.cpp
+#include "issue_queue.h"
+#include <stdio.h>
+
+IssueQueue::IssueQueue(int iq_size) {
+    size = iq_size;
+    entries.assign(size, RS_Entry());
+    count = 0;
+}
+
+int IssueQueue::add_entry(const RS_Entry& entry) {
+    if (is_full()) {
+        return -1;
+    }
+
+    for (int i = 0; i < size; i++) {
+        if (!entries[i].valid) {
+            entries[i] = entry;
+            entries[i].valid = true;
+            count++;
+            return i;
+        }
+    }
+    return -1;
+}
+
+int IssueQueue::select_ready(bool int_fu_free, bool mul_fu_free) {
+    int selected = -1;
+    for (int i = 0; i < size; i++) {
+        const RS_Entry& entry = entries[i];
+        if (!entry.valid || !entry.is_ready()) {
+            continue;
+        }
+        bool fu_free = (entry.operation == MUL) ? mul_fu_free : int_fu_free;
+        if (fu_free && (selected == -1 || entry.timestamp < entries[selected].timestamp)) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+void IssueQueue::remove_entry(int index) {
+    if (index >= 0 && index < size && entries[index].valid) {
+        entries[index].valid = false;
+        count--;
+    }
+}
+
+void IssueQueue::flush(uint64_t timestamp) {
+    for (int i = 0; i < size; i++) {
+        if (entries[i].valid && entries[i].timestamp > timestamp) {
+            remove_entry(i);
+        }
+    }
+}
+
+void IssueQueue::on_tag_broadcast(uint32_t tag, bool is_cc) {
+    for (int i = 0; i < size; i++) {
+        RS_Entry& entry = entries[i];
+        if (!entry.valid) continue;
+
+        if (is_cc) {
+            if (!entry.cc_ready && entry.cc_tag == tag) {
+                entry.cc_ready = entry.cc_pending = true;
+            }
+            continue;
+        }
+        if (!entry.src1_ready && entry.src1_tag == tag) {
+            entry.src1_ready = entry.src1_pending = true;
+        }
+        if (!entry.src2_ready && entry.src2_tag == tag) {
+            entry.src2_ready = entry.src2_pending = true;
+        }
+    }
+}
+
+void IssueQueue::on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) {
+    for (int i = 0; i < size; i++) {
+        RS_Entry& entry = entries[i];
+        if (!entry.valid) continue;
+
+        if (is_cc) {
+            if ((!entry.cc_ready || entry.cc_pending) && entry.cc_tag == tag) {
+                entry.cc_value = value;
+                entry.cc_ready = true;
+                entry.cc_pending = false;
+            }
+            continue;
+        }
+        if ((!entry.src1_ready || entry.src1_pending) && entry.src1_tag == tag) {
+            entry.src1_value = value;
+            entry.src1_ready = true;
+            entry.src1_pending = false;
+        }
+        if ((!entry.src2_ready || entry.src2_pending) && entry.src2_tag == tag) {
+            entry.src2_value = value;
+            entry.src2_ready = true;
+            entry.src2_pending = false;
+        }
+    }
+}
+
+void IssueQueue::display_status() {
+    printf("\nIssue Queue Status:\n");
+    printf("Count: %d\n", count);
+    for (int i = 0; i < size; i++) {
+        const RS_Entry& entry = entries[i];
+        if (entry.valid) {
+            printf("Index %d: PC=0x%x Type=%d ROB=%d Src1=%s Src2=%s CC=%s\n",
+                   i, entry.pc, entry.operation, entry.rob_index,
+                   entry.src1_pending ? "TAG" : (entry.src1_ready ? "READY" : "WAIT"),
+                   entry.src2_pending ? "TAG" : (entry.src2_ready ? "READY" : "WAIT"),
+                   entry.cc_pending ? "TAG" : (entry.cc_ready ? "READY" : "WAIT"));
+        }
+    }
+}
@@ -0,0 +1,351 @@
+// src/lockstep.cpp
+#include "lockstep.h"
+#include <string.h>
+
+/*
+ * Post-dominators are the dominators of the reversed CFG rooted at a
+ * virtual exit node, found with the Cooper-Harvey-Kennedy iteration over
+ * a reverse postorder of that graph.
+ */
+std::vector<uint32_t> compute_reconvergence(const std::vector<APEX_Instruction>& code) {
+    int n = (int)code.size();
+    int exit = n;
+
+    // A register written once in the program, by MOVC, is a known jump base
+    int writes[32] = {0};
+    bool known[32] = {false};  // Apart from the value, which may well be 0
+    uint32_t constant[32] = {0};
+    for (int i = 0; i < n; i++) {
+        if (code[i].rd < 32) {
+            writes[code[i].rd]++;
+            known[code[i].rd] = code[i].type == MOVC;
+            constant[code[i].rd] = known[code[i].rd] ? (uint32_t)code[i].imm : 0;
+        }
+    }
+
+    std::vector<std::vector<int> > succ(n + 1), pred(n + 1);
+    for (int i = 0; i < n; i++) {
+        InstructionType type = code[i].type;
+        std::vector<int> next;
+        uint32_t base = code[i].rs1;
+        if ((type == JUMP || type == JALR) && base < 32 && writes[base] == 1 &&
+            code[i].rd != base && known[base]) {
+            int target = ((int)(constant[base] + code[i].imm) - CODE_BASE_ADDRESS) / 4;
+            next.push_back(target >= 0 && target < n ? target : exit);
+        } else if (type == HALT || type == RET || type == JUMP || type == JALR) {
+            next.push_back(exit);
+        } else {
+            next.push_back(i + 1 < n ? i + 1 : exit);
+            if (is_conditional_branch(type)) {
+                int target = i + code[i].imm / 4;
+                next.push_back(target >= 0 && target < n ? target : exit);
+            }
+        }
+        for (size_t s = 0; s < next.size(); s++) {
+            succ[i].push_back(next[s]);
+            pred[next[s]].push_back(i);
+        }
+    }
+
+    // Postorder of the reversed graph from the exit
+    std::vector<int> order(n + 1, -1), postorder;
+    std::vector<std::pair<int, size_t> > dfs;
+    std::vector<bool> seen(n + 1, false);
+    dfs.push_back(std::make_pair(exit, (size_t)0));
+    seen[exit] = true;
+    while (!dfs.empty()) {
+        int v = dfs.back().first;
+        size_t& edge = dfs.back().second;
+        if (edge < pred[v].size()) {
+            int p = pred[v][edge++];
+            if (!seen[p]) {
+                seen[p] = true;
+                dfs.push_back(std::make_pair(p, (size_t)0));
+            }
+        } else {
+            order[v] = (int)postorder.size();
+            postorder.push_back(v);
+            dfs.pop_back();
+        }
+    }
+
+    std::vector<int> ipdom(n + 1, -1);
+    ipdom[exit] = exit;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int k = (int)postorder.size() - 2; k >= 0; k--) {
+            int v = postorder[k];
+            int best = -1;
+            for (size_t s = 0; s < succ[v].size(); s++) {
+                int a = succ[v][s];
+                if (ipdom[a] < 0) continue;
+                if (best < 0) {
+                    best = a;
+                    continue;
+                }
+                int b = best;
+                while (a != b) {
+                    while (order[a] < order[b]) a = ipdom[a];
+                    while (order[b] < order[a]) b = ipdom[b];
+                }
+                best = a;
+            }
+            if (ipdom[v] != best) {
+                ipdom[v] = best;
+                changed = true;
+            }
+        }
+    }
+
+    // Instructions that never reach the exit (endless loops) get none
+    std::vector<uint32_t> pcs(n, NO_RECONVERGENCE);
+    for (int i = 0; i < n; i++) {
+        if (ipdom[i] >= 0 && ipdom[i] != exit) {
+            pcs[i] = CODE_BASE_ADDRESS + 4 * ipdom[i];
+        }
+    }
+    return pcs;
+}
+
+template <int W>
+LockstepCore<W>::LockstepCore(const std::vector<APEX_Instruction>& program,
+                              const std::vector<uint32_t>& reconverge_pcs, int memory_words,
+                              int instances)
+    : code(program), reconvergence(reconverge_pcs) {
+    for (int r = 0; r < 33; r++) {
+        regs[r] = Vec{};
+    }
+    cc = Vec{};
+    retired = Vec{};
+    memory.assign(memory_words, Vec{});
+    lanes = instances >= W ? (LaneMask)((1ULL << W) - 1) : (LaneMask)((1ULL << instances) - 1);
+    halted = ~lanes;
+    steps = 0;
+    lane_insns = 0;
+
+    Frame start;
+    start.pc = CODE_BASE_ADDRESS;
+    start.reconverge = NO_RECONVERGENCE;
+    start.mask = lanes;
+    stack.push_back(start);
+}
+
+template <int W>
+int LockstepCore<W>::load_data(int lane, const char* filename) {
+    std::vector<uint32_t> words(memory.size(), 0);
+    int loaded = load_data_memory(filename, words.data(), (int)words.size());
+    for (int a = 0; a < loaded; a++) {
+        memory[a][lane] = words[a];
+    }
+    return loaded;
+}
+
+// All-ones in the lanes of mask
+template <int W>
+typename LockstepCore<W>::Vec LockstepCore<W>::lane_select(LaneMask mask) {
+    Vec bits;
+    for (int i = 0; i < W; i++) {
+        bits[i] = 1u << i;
+    }
+    return (Vec)((bits & splat(mask)) != Vec{});
+}
+
+template <int W>
+typename LockstepCore<W>::LaneMask LockstepCore<W>::to_mask(SVec condition, LaneMask active) {
+    LaneMask mask = 0;
+    for (int i = 0; i < W; i++) {
+        mask |= (LaneMask)(condition[i] & 1) << i;
+    }
+    return mask & active;
+}
+
+// The current frame waits at the reconvergence point while both sides run
+template <int W>
+void LockstepCore<W>::diverge(LaneMask taken, uint32_t target, LaneMask fall, uint32_t fall_pc,
+                              uint32_t reconverge_pc) {
+    if (reconverge_pc == NO_RECONVERGENCE) {
+        reconverge_pc = stack.back().reconverge;  // Paths that leave go to HALT
+    }
+    stack.back().pc = reconverge_pc;
+    Frame frame;
+    frame.reconverge = reconverge_pc;
+    if (fall) {
+        frame.pc = fall_pc;
+        frame.mask = fall;
+        stack.push_back(frame);
+    }
+    frame.pc = target;
+    frame.mask = taken;
+    stack.push_back(frame);
+}
+
+template <int W>
+void LockstepCore<W>::step(Frame& top, LaneMask active) {
+    size_t index = (top.pc - CODE_BASE_ADDRESS) / 4;
+    if (top.pc < CODE_BASE_ADDRESS || index >= code.size()) {
+        halted |= active;  // Ran off the program, as FunctionalCore
+        return;
+    }
+    const APEX_Instruction& insn = code[index];
+    const Vec m = lane_select(active);
+    const uint32_t rd = insn.rd < 32 ? insn.rd : 32;
+    const Vec s1 = regs[insn.rs1 < 32 ? insn.rs1 : 32];
+    const Vec s2 = insn.rs2 != REG_NONE ? regs[insn.rs2 < 32 ? insn.rs2 : 32]
+                                        : splat((uint32_t)insn.imm);
+    uint32_t pc = top.pc;
+    uint32_t next_pc = pc + 4;
+    bool indirect = false;
+    Vec targets = Vec{};
+    Vec result = Vec{};
+    bool writes = false, flags = false;
+
+    steps++;
+    lane_insns += __builtin_popcount(active);
+    retired += m & splat(1);
+
+    switch (insn.type) {
+        case INT_ADD: result = s1 + s2; writes = flags = true; break;
+        case INT_SUB: result = s1 - s2; writes = flags = true; break;
+        case MUL:     result = s1 * s2; writes = flags = true; break;
+        case CMP:
+        case CML:     result = s1 - s2; flags = true; break;
+        case INT_AND: result = s1 & s2; writes = true; break;
+        case INT_OR:  result = s1 | s2; writes = true; break;
+        case INT_XOR: result = s1 ^ s2; writes = true; break;
+        case INT_LTR: result = (Vec)((SVec)s1 < (SVec)s2) & splat(1); writes = true; break;
+        case MOVC:    result = s2; writes = true; break;
+
+        case LOAD: {
+            Vec address = s1 + s2;
+            uint32_t first = address[__builtin_ctz(active)];
+            LaneMask same = to_mask((SVec)(address == splat(first)), active);
+            if (same == active && first < memory.size()) {
+                result = memory[first];  // Common case, one vector load
+            } else {
+                for (int i = 0; i < W; i++) {
+                    if ((active >> i) & 1) {
+                        result[i] = address[i] < memory.size() ? memory[address[i]][i] : 0;
+                    }
+                }
+            }
+            writes = true;
+            break;
+        }
+        case STORE: {
+            Vec offset = insn.rs3 != REG_NONE ? regs[insn.rs3 < 32 ? insn.rs3 : 32]
+                                              : splat((uint32_t)insn.imm);
+            Vec address = regs[insn.rs2 < 32 ? insn.rs2 : 32] + offset;
+            uint32_t first = address[__builtin_ctz(active)];
+            LaneMask same = to_mask((SVec)(address == splat(first)), active);
+            if (same == active && first < memory.size()) {
+                memory[first] = (s1 & m) | (memory[first] & ~m);
+            } else {
+                for (int i = 0; i < W; i++) {
+                    if (((active >> i) & 1) && address[i] < memory.size()) {
+                        memory[address[i]][i] = s1[i];
+                    }
+                }
+            }
+            break;
+        }
+
+        case BZ:
+        case BNZ:
+        case BP:
+        case BNP:
+        case BN: {
+            uint32_t flag = insn.type == BP || insn.type == BNP ? CC_POSITIVE :
+                            insn.type == BN ? CC_NEGATIVE : CC_ZERO;
+            LaneMask taken = to_mask((SVec)((cc & splat(flag)) != Vec{}), active);
+            if (insn.type == BNZ || insn.type == BNP) {
+                taken = active & ~taken;
+            }
+            if (taken == active) {
+                next_pc = pc + insn.imm;
+            } else if (taken) {
+                diverge(taken, pc + insn.imm, active & ~taken, pc + 4, reconvergence[index]);
+                return;
+            }
+            break;
+        }
+        case JALP:
+            result = splat(pc + 4);
+            writes = true;
+            next_pc = pc + insn.imm;
+            break;
+        case JALR:
+            targets = s1 + (uint32_t)insn.imm;
+            result = splat(pc + 4);
+            writes = true;
+            indirect = true;
+            break;
+        case JUMP:
+            targets = s1 + (uint32_t)insn.imm;
+            indirect = true;
+            break;
+        case RET:
+            targets = s1;
+            indirect = true;
+            break;
+        case HALT:
+            halted |= active;
+            break;
+        default:
+            break;
+    }
+
+    if (writes) {
+        regs[rd] = (result & m) | (regs[rd] & ~m);
+        regs[32] = Vec{};
+    }
+    if (flags) {
+        Vec zero = (Vec)(result == Vec{});
+        Vec negative = (Vec)((SVec)result < SVec{});
+        Vec flag = (zero & splat(CC_ZERO)) | (negative & splat(CC_NEGATIVE)) |
+                   (~(zero | negative) & splat(CC_POSITIVE));
+        cc = (flag & m) | (cc & ~m);
+    }
+    if (!indirect) {
+        top.pc = next_pc;
+        return;
+    }
+
+    // One frame per distinct target
+    uint32_t target = targets[__builtin_ctz(active)];
+    LaneMask group = to_mask((SVec)(targets == splat(target)), active);
+    if (group == active) {
+        top.pc = target;
+        return;
+    }
+    uint32_t reconverge_pc = reconvergence[index] != NO_RECONVERGENCE ? reconvergence[index]
+                                                                     : top.reconverge;
+    stack.back().pc = reconverge_pc;
+    for (LaneMask rest = active; rest; rest &= ~group) {
+        target = targets[__builtin_ctz(rest)];
+        group = to_mask((SVec)(targets == splat(target)), rest);
+        Frame frame;
+        frame.pc = target;
+        frame.reconverge = reconverge_pc;
+        frame.mask = group;
+        stack.push_back(frame);
+    }
+}
+
+template <int W>
+uint64_t LockstepCore<W>::run(uint64_t max_steps) {
+    uint64_t start = steps;
+    while (!stack.empty() && (max_steps == 0 || steps - start < max_steps)) {
+        Frame& top = stack.back();
+        LaneMask active = top.mask & ~halted;
+        if (!active || top.pc == top.reconverge) {
+            stack.pop_back();
+            continue;
+        }
+        step(top, active);
+    }
+    return steps - start;
+}
+
+template class LockstepCore<8>;
+template class LockstepCore<16>;
@@ -0,0 +1,183 @@
+// src/lockstep_tool.cpp
+// Runs one APEX program over many data inputs, W inputs per vector batch.
+#include "lockstep.h"
+#include "functional_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <time.h>
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s <input_file> <data_file>... [options]\n", prog);
+    fprintf(stderr, "  --inputs=FILE      Read data file names from FILE, one per line\n");
+    fprintf(stderr, "  --width=8|16       Instances per vector batch (default 8)\n");
+    fprintf(stderr, "  --steps=N          Stop each batch after N vector steps (0 = until HALT)\n");
+    fprintf(stderr, "  --memory-size=N    Data memory words per instance (default 4096)\n");
+    fprintf(stderr, "  --dump=A:B         Print memory words [A, B) of every instance\n");
+    fprintf(stderr, "  --check            Re-run every input on FunctionalCore and compare\n");
+}
+
+struct LockstepTotals {
+    uint64_t batches;
+    uint64_t steps;
+    uint64_t lane_insns;
+    uint64_t mismatches;
+    double seconds;           // Lockstep execution only, without loading or checks
+};
+
+// Registers, memory and retired count of one lane against FunctionalCore
+template <int W>
+static bool check_lane(const LockstepCore<W>& core, int lane,
+                       const std::vector<APEX_Instruction>& program, const char* data_file,
+                       int memory_words) {
+    FunctionalCore reference(program, memory_words);
+    if (reference.load_data(data_file) < 0) {
+        return false;
+    }
+    reference.run(0);
+    if (reference.get_retired() != core.get_retired(lane)) {
+        printf("  check %s: retired %lu, functional %lu\n", data_file,
+               (unsigned long)core.get_retired(lane), (unsigned long)reference.get_retired());
+        return false;
+    }
+    for (int r = 0; r < 32; r++) {
+        if (reference.get_reg(r) != core.get_reg(lane, r)) {
+            printf("  check %s: R%d = %d, functional %d\n", data_file, r,
+                   (int)core.get_reg(lane, r), (int)reference.get_reg(r));
+            return false;
+        }
+    }
+    for (int a = 0; a < memory_words; a++) {
+        if (reference.get_memory()[a] != core.get_memory(lane, a)) {
+            printf("  check %s: MEM[%d] = %d, functional %d\n", data_file, a,
+                   (int)core.get_memory(lane, a), (int)reference.get_memory()[a]);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int W>
+static bool run_batches(const std::vector<APEX_Instruction>& program,
+                        const std::vector<std::string>& inputs, int memory_words,
+                        uint64_t max_steps, unsigned long dump_from, unsigned long dump_to,
+                        bool check, LockstepTotals& totals) {
+    std::vector<uint32_t> reconvergence = compute_reconvergence(program);
+    for (size_t first = 0; first < inputs.size(); first += W) {
+        int count = (int)std::min(inputs.size() - first, (size_t)W);
+        LockstepCore<W> core(program, reconvergence, memory_words, count);
+        for (int lane = 0; lane < count; lane++) {
+            if (core.load_data(lane, inputs[first + lane].c_str()) < 0) {
+                return false;
+            }
+        }
+        double begin = host_now();
+        core.run(max_steps);
+        totals.seconds += host_now() - begin;
+        totals.batches++;
+        totals.steps += core.get_steps();
+        totals.lane_insns += core.get_lane_insns();
+
+        for (int lane = 0; lane < count; lane++) {
+            const char* name = inputs[first + lane].c_str();
+            printf("%-40s instructions %10lu%s\n", name, (unsigned long)core.get_retired(lane),
+                   core.is_halted(lane) ? "" : " (not halted)");
+            for (unsigned long a = dump_from; a < dump_to; a++) {
+                printf("  MEM[%lu] = %d\n", a, (int)core.get_memory(lane, (uint32_t)a));
+            }
+            if (check && !check_lane(core, lane, program, name, memory_words)) {
+                totals.mismatches++;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const char* input_file = NULL;
+    const char* input_list = NULL;
+    std::vector<std::string> inputs;
+    int width = 8, memory_words = 4096;
+    unsigned long max_steps = 0, dump_from = 0, dump_to = 0;
+    bool check = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--width=%d", &width) == 1) continue;
+        if (sscanf(arg, "--steps=%lu", &max_steps) == 1) continue;
+        if (sscanf(arg, "--memory-size=%d", &memory_words) == 1) continue;
+        if (sscanf(arg, "--dump=%lu:%lu", &dump_from, &dump_to) == 2) continue;
+        if (strncmp(arg, "--inputs=", 9) == 0) {
+            input_list = arg + 9;
+        } else if (strcmp(arg, "--check") == 0) {
+            check = true;
+        } else if (arg[0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else if (!input_file) {
+            input_file = arg;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (!input_file || (width != 8 && width != 16) || memory_words <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (input_list) {
+        FILE* list = fopen(input_list, "r");
+        if (!list) {
+            fprintf(stderr, "APEX_Error: Unable to open input list %s\n", input_list);
+            return 1;
+        }
+        char line[1024];
+        while (fgets(line, sizeof(line), list)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] != '\0' && line[0] != '#') {
+                inputs.push_back(line);
+            }
+        }
+        fclose(list);
+    }
+    if (inputs.empty()) {
+        fprintf(stderr, "APEX_Error: No data files given\n");
+        return 1;
+    }
+
+    std::vector<APEX_Instruction> program;
+    if (!create_code_memory(input_file, program)) {
+        return 1;
+    }
+
+    LockstepTotals totals;
+    memset(&totals, 0, sizeof(totals));
+    bool ok = width == 16
+        ? run_batches<16>(program, inputs, memory_words, max_steps, dump_from, dump_to, check, totals)
+        : run_batches<8>(program, inputs, memory_words, max_steps, dump_from, dump_to, check, totals);
+    double seconds = totals.seconds;
+    if (!ok) {
+        return 1;
+    }
+
+    printf("Lockstep: %d instances, width %d, %lu batches, %.3f s\n", (int)inputs.size(), width,
+           (unsigned long)totals.batches, seconds);
+    printf("  vector steps %lu, instance instructions %lu (%.1f M/s)\n",
+           (unsigned long)totals.steps, (unsigned long)totals.lane_insns,
+           seconds > 0 ? totals.lane_insns / seconds * 1e-6 : 0.0);
+    printf("  SIMD efficiency %.1f%%\n",
+           totals.steps ? 100.0 * totals.lane_insns / ((double)totals.steps * width) : 0.0);
+    if (check) {
+        printf("  check against FunctionalCore: %s (%lu mismatches)\n",
+               totals.mismatches ? "FAILED" : "passed", (unsigned long)totals.mismatches);
+        return totals.mismatches ? 1 : 0;
+    }
+    return 0;
+}
@@ -1,15 +1,20 @@
 #include "lsq.h"
+#include "apex_log.h"
 #include <stdio.h>
 
-LSQ::LSQ() {
+template <class Capacity>
+LSQ_T<Capacity>::LSQ_T(int lsq_size) : capacity(lsq_size) {
+    capacity.allocate(entries);
     head = 0;
     tail = 0;
     count = 0;
+    now = 0;
 }
 
-int LSQ::add_entry(bool is_store, uint32_t rob_idx) {
+template <class Capacity>
+int LSQ_T<Capacity>::add_entry(bool is_store, uint32_t rob_idx) {
     if (is_full()) {
-        printf("LSQ: Cannot add entry - queue full\n");
+        APEX_WARN(LOG_LSQ, "LSQ: Cannot add entry - queue full\n");
         return -1;
     }
 
@@ -18,18 +23,20 @@ int LSQ::add_entry(bool is_store, uint32_t rob_idx) {
     entry.is_store = is_store;
     entry.rob_index = rob_idx;
     entry.age = count;  // Age for ordering
+    entry.dispatch_cycle = now;
 
     int allocated_index = tail;
-    tail = (tail + 1) % 6;
+    tail = capacity.next(tail);
     count++;
 
-    printf("LSQ: Added %s at index %d (ROB: %d)\n", 
+    APEX_DEBUG(LOG_LSQ, "LSQ: Added %s at index %d (ROB: %d)\n", 
            is_store ? "STORE" : "LOAD", allocated_index, rob_idx);
     return allocated_index;
 }
 
-bool LSQ::can_execute(int index) {
-    if (index < 0 || index >= 6) {
+template <class Capacity>
+bool LSQ_T<Capacity>::can_execute(int index) {
+    if (index < 0 || index >= capacity.size()) {
         return false;
     }
 
@@ -37,120 +44,177 @@ bool LSQ::can_execute(int index) {
     
     // Check if this is the head entry
     if (index != head) {
-        printf("LSQ: Entry %d cannot execute - not at head\n", index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Entry %d cannot execute - not at head\n", index);
         return false;
     }
 
     // Check if address is ready
     if (!entry.address_ready) {
-        printf("LSQ: Entry %d cannot execute - address not ready\n", index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Entry %d cannot execute - address not ready\n", index);
         return false;
     }
 
     // For stores, need data value ready
     if (entry.is_store && !entry.data_ready) {
-        printf("LSQ: Entry %d cannot execute - store data not ready\n", index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Entry %d cannot execute - store data not ready\n", index);
         return false;
     }
 
     return true;  // All conditions met
 }
 
-void LSQ::set_address(int index, uint32_t addr) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_address(int index, uint32_t addr) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].address = addr;
         entries[index].address_ready = true;
-        printf("LSQ: Set address 0x%x for entry %d\n", addr, index);
+        entries[index].address_cycle = now;
+        APEX_DEBUG(LOG_LSQ, "LSQ: Set address 0x%x for entry %d\n", addr, index);
     }
 }
 
-void LSQ::set_data(int index, uint32_t data) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_data(int index, uint32_t data) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].data = data;
         entries[index].data_ready = true;
-        printf("LSQ: Set data 0x%x for entry %d\n", data, index);
+        APEX_DEBUG(LOG_LSQ, "LSQ: Set data 0x%x for entry %d\n", data, index);
     }
 }
 
-void LSQ::complete_entry(int index) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::complete_entry(int index) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].completed = true;
-        printf("LSQ: Completed entry %d\n", index);
+        APEX_DEBUG(LOG_LSQ, "LSQ: Completed entry %d\n", index);
     }
 }
 
-void LSQ::remove_entry() {
+template <class Capacity>
+void LSQ_T<Capacity>::mark_issued(int index) {
+    if (index >= 0 && index < capacity.size()) {
+        entries[index].issued = true;
+        entries[index].issue_cycle = now;
+    }
+}
+
+template <class Capacity>
+void LSQ_T<Capacity>::remove_entry() {
     if (!is_empty()) {
         if (entries[head].completed) {
-            printf("LSQ: Removing entry %d (ROB: %d)\n", 
+            APEX_DEBUG(LOG_LSQ, "LSQ: Removing entry %d (ROB: %d)\n", 
                    head, entries[head].rob_index);
             entries[head] = LSQ_Entry();  // Clear entry
-            head = (head + 1) % 6;
+            head = capacity.next(head);
             count--;
         } else {
-            printf("LSQ: Cannot remove uncompleted entry at head\n");
+            APEX_WARN(LOG_LSQ, "LSQ: Cannot remove uncompleted entry at head\n");
         }
     }
 }
 
+template <class Capacity>
+void LSQ_T<Capacity>::rollback(int num_squashed) {
+    // Entries are allocated in program order, so wrong-path ones sit at the tail
+    while (num_squashed > 0 && !is_empty()) {
+        tail = capacity.prev(tail);
+        APEX_DEBUG(LOG_LSQ, "LSQ: Squashing entry %d (ROB: %d)\n", tail, entries[tail].rob_index);
+        entries[tail] = LSQ_Entry();
+        count--;
+        num_squashed--;
+    }
+}
+
 // Dependency Management
-void LSQ::set_base_tag(int index, uint32_t tag) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_base_tag(int index, uint32_t tag) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].base_reg_tag = tag;
-        printf("LSQ: Set base tag %d for entry %d\n", tag, index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Set base tag %d for entry %d\n", tag, index);
     }
 }
 
-void LSQ::set_offset_tag(int index, uint32_t tag) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_offset_tag(int index, uint32_t tag) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].offset_reg_tag = tag;
-        printf("LSQ: Set offset tag %d for entry %d\n", tag, index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Set offset tag %d for entry %d\n", tag, index);
     }
 }
 
-void LSQ::set_data_tag(int index, uint32_t tag) {
-    if (index >= 0 && index < 6) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_data_tag(int index, uint32_t tag) {
+    if (index >= 0 && index < capacity.size()) {
         entries[index].data_reg_tag = tag;
-        printf("LSQ: Set data tag %d for entry %d\n", tag, index);
+        APEX_TRACE(LOG_LSQ, "LSQ: Set data tag %d for entry %d\n", tag, index);
     }
 }
 
-void LSQ::update_tag(uint32_t tag, uint32_t value) {
-    for (int i = 0; i < 6; i++) {
+template <class Capacity>
+void LSQ_T<Capacity>::set_base_value(int index, uint32_t value) {
+    if (index >= 0 && index < capacity.size()) {
+        entries[index].base_value = value;
+        entries[index].base_ready = true;
+        try_calculate_address(index);
+    }
+}
+
+template <class Capacity>
+void LSQ_T<Capacity>::set_offset_value(int index, uint32_t value) {
+    if (index >= 0 && index < capacity.size()) {
+        entries[index].offset_value = value;
+        entries[index].offset_ready = true;
+        try_calculate_address(index);
+    }
+}
+
+template <class Capacity>
+void LSQ_T<Capacity>::try_calculate_address(int index) {
+    LSQ_Entry& entry = entries[index];
+    if (!entry.address_ready && entry.base_ready && entry.offset_ready) {
+        entry.address = entry.base_value + entry.offset_value;
+        entry.address_ready = true;
+        entry.address_cycle = now;
+        APEX_DEBUG(LOG_LSQ, "LSQ: Calculated address 0x%x for entry %d\n", 
+               entry.address, index);
+    }
+}
+
+template <class Capacity>
+void LSQ_T<Capacity>::update_tag(uint32_t tag, uint32_t value) {
+    // Live entries only, free slots hold no pending tags
+    int i = head;
+    for (int n = 0; n < count; n++, i = capacity.next(i)) {
         LSQ_Entry& entry = entries[i];
         
         // Update base register
         if (!entry.base_ready && entry.base_reg_tag == tag) {
             entry.base_value = value;
             entry.base_ready = true;
-            printf("LSQ: Updated base value for entry %d\n", i);
+            APEX_TRACE(LOG_LSQ, "LSQ: Updated base value for entry %d\n", i);
         }
         
         // Update offset register
         if (!entry.offset_ready && entry.offset_reg_tag == tag) {
             entry.offset_value = value;
             entry.offset_ready = true;
-            printf("LSQ: Updated offset value for entry %d\n", i);
+            APEX_TRACE(LOG_LSQ, "LSQ: Updated offset value for entry %d\n", i);
         }
         
         // Update data register (for stores)
         if (entry.is_store && !entry.data_ready && entry.data_reg_tag == tag) {
             entry.data = value;
             entry.data_ready = true;
-            printf("LSQ: Updated data value for entry %d\n", i);
+            APEX_TRACE(LOG_LSQ, "LSQ: Updated data value for entry %d\n", i);
         }
         
         // Try to calculate address if both base and offset are ready
-        if (!entry.address_ready && entry.base_ready && entry.offset_ready) {
-            entry.address = entry.base_value + entry.offset_value;
-            entry.address_ready = true;
-            printf("LSQ: Calculated address 0x%x for entry %d\n", 
-                   entry.address, i);
-        }
+        try_calculate_address(i);
     }
 }
 
-void LSQ::display_status() {
+template <class Capacity>
+void LSQ_T<Capacity>::display_status() {
     printf("\nLSQ Status:\n");
     printf("Head: %d, Tail: %d, Count: %d\n", head, tail, count);
     
@@ -174,8 +238,10 @@ void LSQ::display_status() {
                        entry.data_ready);
             }
             
-            current = (current + 1) % 6;
+            current = capacity.next(current);
             entries_shown++;
         }
     }
-}
\ No newline at end of file
+}
+
+template class LSQ_T<CoreVariant::LsqCapacity>;
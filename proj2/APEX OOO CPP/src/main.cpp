@@ -1,11 +1,23 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
 #include "apex_cpu.h"
+#include "apex_log.h"
 #include "rob.h"
 #include "register_manager.h"
 #include "control_predictor.h"
 #include "lsq.h"  
 #include "memory_fu.h"
 #include "int_fu.h"
+#include "result_bus.h"
+#include "physical_register_file.h"
+#include "functional_core.h"
+#include "bbv.h"
+#include "sampled_sim.h"
+#include "what_if.h"
 
 // Test function to verify ROB operations
 void test_rob() {
@@ -98,6 +110,21 @@ void test_rob() {
     printf("Last successful entry index: %d\n", last_idx);
     printf("ROB state after filling:\n");
     rob.display_status();
+
+    printf("\nTest 7: Rollback in a full ROB (head == tail)\n");
+    ROB small(8);
+    int small_idx[8];
+    for (int i = 0; i < 8; i++) {
+        small_idx[i] = small.add_entry(0x4000 + i * 4, INT, i, 40 + i, 60 + i, 0);
+    }
+    small.rollback(small_idx[2]);
+    int kept = small.get_count();
+    int refilled = 0;
+    while (small.add_entry(0x5000 + refilled * 4, INT, 1, 50, 70, 0) != -1) {
+        refilled++;
+    }
+    printf("Expected: Count=3 after rollback, 5 entries refilled\n");
+    printf("Result: Count=%d after rollback, %d entries refilled\n", kept, refilled);
 }
 
 void test_register_manager() {
@@ -541,15 +568,589 @@ void test_integer_fu() {
     printf("Positive Result CC Flags: 0x%x (Expected: 0x1)\n", pos_result.cc_flags);
 }
 
+void test_result_bus() {
+    printf("\n=== Testing Result Bus ===\n");
+
+    ControlPredictor predictor;
+    IntegerFU int_fu(predictor);
+    IssueQueue iq;
+    PhysicalRegisterFile uprf(60, false);
+    ResultBus bus(1);  // Single writeback port
+    bus.subscribe(&uprf);
+    bus.subscribe(&iq);
+    bus.subscribe(&int_fu);
+
+    // Consumer of P40 waits in the IQ
+    RS_Entry rs;
+    rs.pc = 0x1004;
+    rs.operation = INT_ADD;
+    rs.src1_tag = 40;
+    rs.src1_ready = false;
+    rs.src2_tag = REG_NONE;
+    rs.imm = 1;
+    rs.rob_index = 1;
+    rs.timestamp = 2;
+    iq.add_entry(rs);
+    uprf.allocate(40);
+
+    printf("\nTest 1: Port Arbitration\n");
+    BusResult older = {0, 1, 40, 0x10, REG_NONE, 0, false};
+    BusResult younger = {2, 3, 41, 0x20, REG_NONE, 0, false};
+    bus.request(younger);
+    bus.request(older);
+    bus.broadcast_tags();
+    printf("Waiting after tag phase: %d (Expected: 1)\n", bus.get_pending_count());
+
+    printf("\nTest 2: Tag Broadcast Wakes Consumer\n");
+    int index = iq.select_ready(true, false);
+    printf("Selected IQ entry: %d (Expected: 0), P40 ready: %d (Expected: 0)\n",
+           index, uprf.is_ready(40));
+    int_fu.issue(rs.pc, rs.operation, 0, rs.imm, rs.rob_index, rs.src1_tag);
+    iq.remove_entry(index);
+    printf("FU operands ready: %d (Expected: 0)\n", int_fu.operands_ready());
+
+    printf("\nTest 3: Value Broadcast Next Cycle\n");
+    bus.broadcast_values();
+    printf("P40 = 0x%x ready: %d (Expected: 0x10, 1)\n", uprf.read(40), uprf.is_ready(40));
+    IntFUResult result = int_fu.execute();
+    printf("Dependent ADD Result: 0x%x (Expected: 0x11)\n", result.value);
+}
+
 void test_rob();  // Existing function
 void test_register_manager();  // New function
 
-int main() {
+// A fixed variant must be the machine of its config file: applying the
+// variant to the loaded file may not change any field
+template <class Variant>
+void check_variant_config(const char* config_file) {
+    SimConfig loaded;
+    if (!loaded.load_file(config_file)) {
+        printf("Result: %s not found, skipped\n", config_file);
+        return;
+    }
+    SimConfig pinned = loaded;
+    Variant::apply(pinned, true);
+    printf("Expected: %s build matches %s\n", Variant::name(), config_file);
+    printf("Result: %s\n", memcmp(&loaded, &pinned, sizeof(SimConfig)) == 0 ? "match" : "MISMATCH");
+}
+
+void test_core_variants() {
+    printf("\n=== Testing Core Variants ===\n");
+    printf("\nTest 1: apex variant against configs/default.cfg\n");
+    check_variant_config<ApexVariant>("configs/default.cfg");
+    printf("\nTest 2: wide4 variant against configs/wide4.json\n");
+    check_variant_config<Wide4Variant>("configs/wide4.json");
+}
+
+static APEX_Instruction test_insn(const char* opcode, InstructionType type, uint32_t rd,
+                                  uint32_t rs1, uint32_t rs2, int32_t imm) {
+    APEX_Instruction insn;
+    snprintf(insn.opcode_str, sizeof(insn.opcode_str), "%s", opcode);
+    insn.type = type;
+    insn.rd = rd;
+    insn.rs1 = rs1;
+    insn.rs2 = rs2;
+    insn.rs3 = REG_NONE;
+    insn.imm = imm;
+    return insn;
+}
+
+static double test_stat(const APEX_CPU& cpu, const char* name) {
+    std::vector<StatValue> values;
+    cpu.get_stats().collect(values);
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i].name == name) return values[i].value;
+    }
+    return -1.0;
+}
+
+void test_functional_warming() {
+    printf("\n=== Testing Functional Warming ===\n");
+    // Loop over 16 words: 3 setup instructions, then 5 per iteration
+    std::vector<APEX_Instruction> code;
+    code.push_back(test_insn("MOVC", MOVC, 1, REG_NONE, REG_NONE, 0));
+    code.push_back(test_insn("MOVC", MOVC, 2, REG_NONE, REG_NONE, 200));
+    code.push_back(test_insn("MOVC", MOVC, 7, REG_NONE, REG_NONE, 15));
+    code.push_back(test_insn("LOAD", LOAD, 4, 1, REG_NONE, 0));
+    code.push_back(test_insn("ADDL", INT_ADD, 1, 1, REG_NONE, 1));
+    code.push_back(test_insn("AND", INT_AND, 1, 1, 7, 0));
+    code.push_back(test_insn("SUBL", INT_SUB, 2, 2, REG_NONE, 1));
+    code.push_back(test_insn("BNZ", BNZ, REG_NONE, REG_NONE, REG_NONE, -16));
+    code.push_back(test_insn("HALT", HALT, REG_NONE, REG_NONE, REG_NONE, 0));
+
+    SimConfig config;
+    config.dcache_sets = 4;
+    config.dcache_ways = 2;
+    config.dcache_line = 4;
+
+    FunctionalCore core(code, config.memory_size);
+    FunctionalWarmer warmer(code, config);
+    warmer.run(core, 503);
+    ArchCheckpoint checkpoint;
+    core.save_checkpoint(checkpoint);
+
+    printf("\nTest 1: Warmer observed the fast-forward\n");
+    printf("Expected: Warmed=503, Control=100, Memory=100\n");
+    printf("Result: Warmed=%lu, Control=%lu, Memory=%lu\n",
+           (unsigned long)warmer.get_warmed(), (unsigned long)warmer.get_branches(),
+           (unsigned long)warmer.get_accesses());
+
+    printf("\nTest 2: Detailed core after the checkpoint, cold and warmed\n");
+    Logger::set_level(LOG_WARN);  // Two full pipelines, too much to trace
+    APEX_CPU cold(config);
+    cold.load_checkpoint(code, checkpoint);
+    cold.run_until(100);
+    APEX_CPU warm(config);
+    warm.load_checkpoint(code, checkpoint);
+    warmer.apply(warm);
+    warm.run_until(100);
+    Logger::set_level(LOG_TRACE);
+    printf("Expected: Warmed core has no D-cache or BTB misses, the cold core has both\n");
+    printf("Result: cold load_misses=%.0f btb_misses=%.0f, warm load_misses=%.0f btb_misses=%.0f\n",
+           test_stat(cold, "dcache.load_misses"), test_stat(cold, "predictor.btb_misses"),
+           test_stat(warm, "dcache.load_misses"), test_stat(warm, "predictor.btb_misses"));
+}
+
+void test_functional_reload() {
+    printf("\n=== Testing Functional Program Reload ===\n");
+    // R1 += step, 50 times, long enough for the loop to be translated
+    std::vector<APEX_Instruction> code;
+    code.push_back(test_insn("MOVC", MOVC, 1, REG_NONE, REG_NONE, 0));
+    code.push_back(test_insn("MOVC", MOVC, 2, REG_NONE, REG_NONE, 50));
+    code.push_back(test_insn("ADDL", INT_ADD, 1, 1, REG_NONE, 3));
+    code.push_back(test_insn("SUBL", INT_SUB, 2, 2, REG_NONE, 1));
+    code.push_back(test_insn("BNZ", BNZ, REG_NONE, REG_NONE, REG_NONE, -8));
+    code.push_back(test_insn("HALT", HALT, REG_NONE, REG_NONE, REG_NONE, 0));
+
+    FunctionalCore core(code);
+    core.enable_translation(4);
+    ArchCheckpoint start;
+    core.save_checkpoint(start);
+    core.run(0);
+    printf("\nTest 1: First image\n");
+    printf("Expected: R1=150, translated > 0\n");
+    printf("Result: R1=%u, translated %lu\n", core.get_reg(1), (unsigned long)core.get_translated());
+
+    printf("\nTest 2: Same-length image changed in place, then reloaded\n");
+    code[2].imm = 5;
+    core.load_program(code);
+    core.restore_checkpoint(start);
+    core.run(0);
+    printf("Expected: R1=250\n");
+    printf("Result: R1=%u\n", core.get_reg(1));
+
+    printf("\nTest 3: Another vector of the same length\n");
+    std::vector<APEX_Instruction> other = code;
+    other[2].imm = 7;
+    core.load_program(other);
+    core.restore_checkpoint(start);
+    core.run(0);
+    printf("Expected: R1=350\n");
+    printf("Result: R1=%u\n", core.get_reg(1));
+}
+
+// Parses a one-line program from a scratch file
+static bool test_parse(const char* line, std::vector<APEX_Instruction>& code) {
+    char path[] = "/tmp/apex_parse_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    FILE* fp = fdopen(fd, "w");
+    fprintf(fp, "%s\n", line);
+    fclose(fp);
+    bool ok = create_code_memory(path, code);
+    unlink(path);
+    return ok;
+}
+
+void test_file_parser() {
+    printf("\n=== Testing File Parser ===\n");
+    std::vector<APEX_Instruction> code;
+    printf("\nTest 1: Registers R0..R31 are accepted\n");
+    bool ok = test_parse("ADD R31,R0,R15", code);
+    printf("Expected: parsed, rd=31 rs1=0 rs2=15\n");
+    printf("Result: %s, rd=%u rs1=%u rs2=%u\n", ok ? "parsed" : "rejected",
+           ok ? code[0].rd : 0, ok ? code[0].rs1 : 0, ok ? code[0].rs2 : 0);
+
+    const char* bad[] = {"MOVC R40,#7", "ADD R1,R2,R99", "LOAD R1,R2x,#0", "JUMP #4000,#0"};
+    for (int i = 0; i < 4; i++) {
+        printf("\nTest %d: %s is rejected\n", i + 2, bad[i]);
+        ok = test_parse(bad[i], code);
+        printf("Expected: rejected\n");
+        printf("Result: %s\n", ok ? "parsed" : "rejected");
+    }
+}
+
+void run_component_tests() {
     test_rob();
     test_register_manager();
     test_control_predictor();
     test_lsq();
     test_memory_fu();
     test_integer_fu();
+    test_result_bus();
+    test_core_variants();
+    test_functional_warming();
+    test_functional_reload();
+    test_file_parser();
+}
+
+/*
+ * Functional run writing basic-block vectors for apex_simpoint, no
+ * detailed simulation. max_insns = 0 runs to HALT.
+ */
+int run_bbv(const char* input_file, const char* data_file, const SimConfig& config,
+            const char* bbv_file, uint64_t interval, uint64_t max_insns) {
+    std::vector<APEX_Instruction> code;
+    if (!create_code_memory(input_file, code)) {
+        return 1;
+    }
+    FunctionalCore core(code, config.memory_size);
+    if (data_file && core.load_data(data_file) < 0) {
+        return 1;
+    }
+    BbvCollector bbv;
+    if (!bbv.open(bbv_file, interval)) {
+        return 1;
+    }
+
+    FunctionalStep step;
+    while ((max_insns == 0 || core.get_retired() < max_insns) && core.step(step)) {
+        bbv.on_instruction(step.pc, is_control_op(step.type) || step.type == HALT);
+    }
+    bbv.close();
+    printf("APEX_Functional: %lu instructions, %lu intervals of %lu, %d basic blocks\n",
+           (unsigned long)core.get_retired(), (unsigned long)bbv.get_intervals(),
+           (unsigned long)interval, bbv.get_blocks());
     return 0;
-}
\ No newline at end of file
+}
+
+/*
+ * Functional run only, hot blocks translated to host code unless
+ * hot_threshold is 0. max_insns = 0 runs to HALT.
+ */
+int run_functional(const char* input_file, const char* data_file, const SimConfig& config,
+                   uint32_t hot_threshold, uint64_t max_insns, bool display) {
+    std::vector<APEX_Instruction> code;
+    if (!create_code_memory(input_file, code)) {
+        return 1;
+    }
+    FunctionalCore core(code, config.memory_size);
+    if (data_file && core.load_data(data_file) < 0) {
+        return 1;
+    }
+    core.enable_translation(hot_threshold);
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    core.run(max_insns);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) * 1e-9;
+
+    printf("APEX_Functional: %lu instructions, %.3f s, %.1f MIPS\n",
+           (unsigned long)core.get_retired(), seconds,
+           seconds > 0 ? core.get_retired() / seconds * 1e-6 : 0.0);
+    const BlockTranslator* translator = core.get_translator();
+    if (translator && translator->is_available()) {
+        printf("  translated: %lu blocks, %lu chained exits, %lu bytes, %.1f%% of instructions\n",
+               (unsigned long)translator->get_blocks(), (unsigned long)translator->get_linked(),
+               (unsigned long)translator->get_code_bytes(),
+               core.get_retired() ? 100.0 * core.get_translated() / core.get_retired() : 0.0);
+    }
+    if (display) {
+        for (int r = 0; r < 32; r++) {
+            printf("  R%-2d = %d%s", r, (int)core.get_reg(r), r % 8 == 7 ? "\n" : "");
+        }
+    }
+    return 0;
+}
+
+/*
+ * Detailed simulation of the given start points only, from checkpoints
+ * taken in one functional pass, one host thread per sample.
+ */
+int run_sampled(const char* input_file, const char* data_file, const SimConfig& config,
+                const char* samples_file, const char* weights_file, uint64_t size,
+                uint64_t warmup, uint64_t functional_warming, int jobs, const char* stats_file) {
+    std::vector<APEX_Instruction> code;
+    std::vector<SimPointChoice> points;
+    if (!create_code_memory(input_file, code) ||
+        !read_simpoints(samples_file, weights_file, points)) {
+        return 1;
+    }
+    SampledSim sampled(code, config, size, warmup);
+    sampled.set_functional_warming(functional_warming);
+    if (!sampled.capture(points, data_file)) {
+        return 1;
+    }
+    Logger::start();
+    sampled.run(jobs);
+    Logger::stop();
+    sampled.print(stdout);
+    if (stats_file) {
+        // Per-counter estimate from the same rows apex_simpoint --combine reads
+        std::vector<SimPointChoice> simulated;
+        for (size_t i = 0; i < sampled.get_results().size(); i++) {
+            simulated.push_back(sampled.get_results()[i].choice);
+        }
+        if (!sampled.write_csv(stats_file) ||
+            !combine_interval_stats(stats_file, simulated, stdout)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s <input_file> [data_file] [options]\n", prog);
+    fprintf(stderr, "  --config=FILE     Load parameters from a key=value or JSON file\n");
+    fprintf(stderr, "  --set key=value   Override one parameter (applied after --config)\n");
+    fprintf(stderr, "  --key=value       Same as --set, e.g. --fetch-width=4 --rob-size=128\n");
+    fprintf(stderr, "  --cycles=N        Stop after N cycles (0 = run to HALT)\n");
+    fprintf(stderr, "  --display         Print the CPU state at the end of the run\n");
+    fprintf(stderr, "  --show-config     Print the configuration before running\n");
+    fprintf(stderr, "  --log=SPEC        Log levels, e.g. debug or lsq=trace,rob=off (default warn)\n");
+    fprintf(stderr, "                    components: cpu rob rename iq lsq intfu mulfu memfu predictor bus\n");
+    fprintf(stderr, "  --branch-top=N    Number of worst static branches to report (default 10)\n");
+    fprintf(stderr, "  --stats=FILE      Dump every statistic as JSON, or CSV for a .csv name\n");
+    fprintf(stderr, "  --intervals=FILE  Write counter deltas per interval (CSV for .csv, else JSON)\n");
+    fprintf(stderr, "  --interval=N      Interval length in cycles (default 1000)\n");
+    fprintf(stderr, "  --interval-insns=N  ... or in committed instructions\n");
+    fprintf(stderr, "  --critical-path[=N]  Critical path by cause over N instruction windows (256)\n");
+    fprintf(stderr, "  --bbv=FILE        Functional run only, write basic-block vectors for apex_simpoint\n");
+    fprintf(stderr, "  --bbv-interval=N  Instructions per BBV interval (default 100000)\n");
+    fprintf(stderr, "  --functional      Functional run only (--cycles=N then counts instructions)\n");
+    fprintf(stderr, "  --translate=N     Translate blocks to host code after N entries (default 16, 0 = off)\n");
+    fprintf(stderr, "  --samples=FILE    Simulate only these intervals (SimPoint .simpoints format)\n");
+    fprintf(stderr, "  --sample-weights=FILE  Their weights (.weights format, default equal)\n");
+    fprintf(stderr, "  --sample-size=N   Instructions per sample interval (default 100000)\n");
+    fprintf(stderr, "  --sample-warmup=N Detailed warm-up before each sample (default 10000)\n");
+    fprintf(stderr, "  --functional-warming=N  Train predictor and D-cache over the last N fast-forward\n");
+    fprintf(stderr, "                    instructions before each sample (default 4 x sample size,\n");
+    fprintf(stderr, "                    all = the whole fast-forward, 0 = off)\n");
+    fprintf(stderr, "  --sample-stats=FILE  Write per-sample counter deltas as CSV\n");
+    fprintf(stderr, "  --jobs=N          Host threads for samples (default all)\n");
+    fprintf(stderr, "  --fork-at=N       Run to cycle N, then fork one process per --what-if\n");
+    fprintf(stderr, "  --what-if=SPEC    Variant after the fork, e.g. fetch_width=1,commit_width=2\n");
+    fprintf(stderr, "                    (repeatable, empty = baseline; widths and dcache_miss_penalty)\n");
+    fprintf(stderr, "  --stage-timers    Report host time per pipeline stage\n");
+    fprintf(stderr, "  --trace=FILE      Write an O3PipeView (Konata) pipeline trace\n");
+    fprintf(stderr, "  --trace-bin=FILE  Write the same trace in the compact binary format\n");
+    fprintf(stderr, "  --trace-from=N    Trace instructions fetched from cycle N (default 0)\n");
+    fprintf(stderr, "  --trace-to=N      ... up to but not including cycle N (default end of run)\n");
+    SimConfig().print(stderr);
+    fprintf(stderr, "Core variant: %s\n", CoreVariant::name());
+    fprintf(stderr, "Without arguments the component tests are run.\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        Logger::set_level(LOG_TRACE);  // Tests show every component message
+        run_component_tests();
+        return 0;
+    }
+
+    SimConfig config;
+    CoreVariant::apply(config, false);  // Fixed builds start from their own sizes
+    std::vector<const char*> overrides;
+    const char* config_file = NULL;
+    const char* input_file = NULL;
+    const char* data_file = NULL;
+    unsigned long max_cycles = 0;
+    bool display = false;
+    bool show_config = false;
+    const char* trace_file = NULL;
+    const char* trace_bin_file = NULL;
+    unsigned long trace_from = 0, trace_to = 0;
+    int branch_top = 10;
+    bool stage_timers = false;
+    int critical_window = 0;
+    const char* bbv_file = NULL;
+    unsigned long bbv_interval = 100000;
+    bool functional = false;
+    unsigned int translate_threshold = 16;
+    const char* samples_file = NULL;
+    const char* sample_weights = NULL;
+    const char* sample_stats = NULL;
+    unsigned long sample_size = 100000, sample_warmup = 10000;
+    unsigned long functional_warming = 0;
+    bool warming_given = false;   // Default: 4 samples' worth before each sample
+    int jobs = 0;
+    std::vector<const char*> stats_files;
+    const char* interval_file = NULL;
+    unsigned long interval_cycles = 1000, interval_insns = 0;
+    unsigned long fork_at = 0;
+    std::vector<const char*> what_ifs;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--cycles=%lu", &max_cycles) == 1) continue;
+        if (sscanf(arg, "--trace-from=%lu", &trace_from) == 1) continue;
+        if (sscanf(arg, "--branch-top=%d", &branch_top) == 1) continue;
+        if (sscanf(arg, "--trace-to=%lu", &trace_to) == 1) continue;
+        if (sscanf(arg, "--interval=%lu", &interval_cycles) == 1) continue;
+        if (sscanf(arg, "--critical-path=%d", &critical_window) == 1) continue;
+        if (sscanf(arg, "--bbv-interval=%lu", &bbv_interval) == 1) continue;
+        if (strncmp(arg, "--bbv=", 6) == 0) {
+            bbv_file = arg + 6;
+            continue;
+        }
+        if (sscanf(arg, "--interval-insns=%lu", &interval_insns) == 1) continue;
+        if (sscanf(arg, "--sample-size=%lu", &sample_size) == 1) continue;
+        if (sscanf(arg, "--sample-warmup=%lu", &sample_warmup) == 1) continue;
+        if (strcmp(arg, "--functional-warming=all") == 0) {
+            functional_warming = ~0UL;  // The whole fast-forward
+            warming_given = true;
+            continue;
+        }
+        if (sscanf(arg, "--functional-warming=%lu", &functional_warming) == 1) {
+            warming_given = true;
+            continue;
+        }
+        if (sscanf(arg, "--jobs=%d", &jobs) == 1) continue;
+        if (sscanf(arg, "--translate=%u", &translate_threshold) == 1) continue;
+        if (sscanf(arg, "--fork-at=%lu", &fork_at) == 1) continue;
+        if (strncmp(arg, "--what-if=", 10) == 0) {
+            what_ifs.push_back(arg + 10);
+            continue;
+        }
+        if (strncmp(arg, "--samples=", 10) == 0) {
+            samples_file = arg + 10;
+            continue;
+        }
+        if (strncmp(arg, "--sample-weights=", 17) == 0) {
+            sample_weights = arg + 17;
+            continue;
+        }
+        if (strncmp(arg, "--sample-stats=", 15) == 0) {
+            sample_stats = arg + 15;
+            continue;
+        }
+        if (strncmp(arg, "--intervals=", 12) == 0) {
+            interval_file = arg + 12;
+            continue;
+        }
+        if (strncmp(arg, "--stats=", 8) == 0) {
+            stats_files.push_back(arg + 8);
+            continue;
+        }
+        if (strncmp(arg, "--trace=", 8) == 0) {
+            trace_file = arg + 8;
+            continue;
+        }
+        if (strncmp(arg, "--trace-bin=", 12) == 0) {
+            trace_bin_file = arg + 12;
+            continue;
+        }
+        if (strncmp(arg, "--config=", 9) == 0) {
+            config_file = arg + 9;
+        } else if (strcmp(arg, "--set") == 0 && i + 1 < argc) {
+            overrides.push_back(argv[++i]);
+        } else if (strncmp(arg, "--log=", 6) == 0) {
+            if (!Logger::configure(arg + 6)) {
+                return 1;
+            }
+        } else if (strcmp(arg, "--display") == 0) {
+            display = true;
+        } else if (strcmp(arg, "--show-config") == 0) {
+            show_config = true;
+        } else if (strcmp(arg, "--stage-timers") == 0) {
+            stage_timers = true;
+        } else if (strcmp(arg, "--critical-path") == 0) {
+            critical_window = 256;
+        } else if (strcmp(arg, "--functional") == 0) {
+            functional = true;
+        } else if (strncmp(arg, "--", 2) == 0 && strchr(arg, '=')) {
+            overrides.push_back(arg + 2);
+        } else if (arg[0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else if (!input_file) {
+            input_file = arg;
+        } else if (!data_file) {
+            data_file = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Config file first, then command line overrides in order
+    if (config_file && !config.load_file(config_file)) {
+        return 1;
+    }
+    for (size_t i = 0; i < overrides.size(); i++) {
+        if (!config.set(overrides[i])) {
+            return 1;
+        }
+    }
+    if (!input_file) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    CoreVariant::apply(config);
+    if (!config.validate()) {
+        fprintf(stderr, "APEX_Error: Invalid configuration\n");
+        return 1;
+    }
+    if (show_config) {
+        config.print();
+    }
+    if (bbv_file) {
+        return run_bbv(input_file, data_file, config, bbv_file, bbv_interval, max_cycles);
+    }
+    if (functional) {
+        return run_functional(input_file, data_file, config, translate_threshold, max_cycles,
+                              display);
+    }
+    if (samples_file) {
+        if (!warming_given) {
+            functional_warming = 4 * sample_size;
+        }
+        return run_sampled(input_file, data_file, config, samples_file, sample_weights,
+                           sample_size, sample_warmup, functional_warming, jobs, sample_stats);
+    }
+
+    APEX_CPU cpu(config);
+    if (!cpu.initialize(input_file, data_file)) {
+        fprintf(stderr, "APEX_Error: Unable to initialize CPU\n");
+        return 1;
+    }
+    if (fork_at > 0 || !what_ifs.empty()) {
+        // No log thread: only the forking thread would exist in the children
+        WhatIfFork what_if(config, fork_at, max_cycles);
+        for (size_t i = 0; i < what_ifs.size(); i++) {
+            what_if.add_variant(what_ifs[i]);
+        }
+        bool ok = what_if.run(cpu);
+        what_if.print(stdout);
+        return ok ? 0 : 1;
+    }
+    cpu.set_branch_report_size(branch_top);
+    cpu.set_stage_timers(stage_timers);
+    if (critical_window > 0) {
+        cpu.enable_critical_path(critical_window);
+    }
+    if ((trace_file || trace_bin_file) &&
+        !cpu.enable_trace(trace_file, trace_bin_file, trace_from, trace_to)) {
+        return 1;
+    }
+    if (interval_file &&
+        !cpu.enable_interval_stats(interval_file, interval_insns ? interval_insns : interval_cycles,
+                                   interval_insns != 0)) {
+        return 1;
+    }
+
+    // Log records are formatted by a background thread while the core runs
+    Logger::start();
+    cpu.run_cpu(max_cycles);
+    for (size_t i = 0; i < stats_files.size(); i++) {
+        cpu.dump_stats(stats_files[i]);
+    }
+    if (display) {
+        cpu.show_state();
+    }
+    Logger::stop();
+    return 0;
+}
@@ -1,23 +1,36 @@
 #include "memory_fu.h"
+#include "apex_log.h"
+#include "file_parser.h"
 #include <stdio.h>
 
-MemoryFU::MemoryFU(LSQ& lsq_ref) : lsq(lsq_ref) {
+MemoryFU::MemoryFU(LSQ& lsq_ref, int num_stages, int memory_words, int cache_sets,
+                   int cache_ways, int line_words, int miss_penalty)
+    : lsq(lsq_ref), dcache(cache_sets, cache_ways, line_words, miss_penalty) {
     // Initialize stages
-    for(int i = 0; i < 3; i++) {
+    stages.resize(num_stages);
+    for(int i = 0; i < num_stages; i++) {
         stages[i].busy = false;
         stages[i].lsq_index = -1;
+        stages[i].stall = 0;
     }
     
     // Initialize memory (for simulation)
-    for(uint32_t i = 0; i < 4096; i++) {
-        memory[i] = 0;
-    }
+    memory.assign(memory_words, 0);
+    port = NULL;
 }
 
 bool MemoryFU::can_accept() {
     return !stages[0].busy;
 }
 
+int MemoryFU::get_busy_count() const {
+    int busy = 0;
+    for(int i = 0; i < (int)stages.size(); i++) {
+        busy += stages[i].busy;
+    }
+    return busy;
+}
+
 bool MemoryFU::issue(int lsq_index) {
     if(!can_accept()) {
         return false;
@@ -34,62 +47,87 @@ bool MemoryFU::issue(int lsq_index) {
     stages[0].address = address;
     stages[0].is_store = is_store;
     stages[0].data = data;
+    stages[0].stall = port ? port->access(address, is_store) : dcache.access(address, is_store);
     
-    printf("MemFU: Issued LSQ entry %d to stage 0 (%s Addr:0x%x)\n", 
+    APEX_DEBUG(LOG_MEMFU, "MemFU: Issued LSQ entry %d to stage 0 (%s Addr:0x%x)\n", 
            lsq_index, is_store ? "STORE" : "LOAD", address);
     return true;
 }
 
-void MemoryFU::advance_stages() {
-    // Move from stage 2 to completion
-    if(stages[2].busy) {
-        if(stages[2].is_store) {
-            write_memory(stages[2].address, stages[2].data);
+MemFUResult MemoryFU::advance_stages() {
+    MemFUResult result = {0};
+
+    const int last = (int)stages.size() - 1;
+
+    // Move from the last stage to completion, a miss holds it and blocks
+    // everything behind it
+    if(stages[last].busy && stages[last].stall > 0) {
+        stages[last].stall--;
+    } else if(stages[last].busy) {
+        MemStage& done = stages[last];
+        if(last == 0 && !done.is_store) {
+            done.data = read_memory(done.address);  // Single stage FU
         }
-        stages[2].busy = false;
-        printf("MemFU: Completed %s operation at address 0x%x\n", 
-               stages[2].is_store ? "STORE" : "LOAD",
-               stages[2].address);
-    }
-    
-    // Move from stage 1 to 2
-    if(stages[1].busy) {
-        stages[2] = stages[1];
-        stages[1].busy = false;
-        printf("MemFU: Advanced stage 1 to 2\n");
+        if(done.is_store) {
+            write_memory(done.address, done.data);
+        }
+        result.valid = true;
+        result.lsq_index = done.lsq_index;
+        result.address = done.address;
+        result.data = done.data;
+        result.is_store = done.is_store;
+        done.busy = false;
+        APEX_DEBUG(LOG_MEMFU, "MemFU: Completed %s operation at address 0x%x\n", 
+               done.is_store ? "STORE" : "LOAD",
+               done.address);
     }
     
-    // Move from stage 0 to 1
-    if(stages[0].busy) {
-        stages[1] = stages[0];
-        stages[0].busy = false;
-        
-        // If LOAD, perform the read in stage 1
-        if(!stages[1].is_store) {
-            stages[1].data = read_memory(stages[1].address);
+    // Move remaining operations one stage forward
+    for(int i = last; i > 0; i--) {
+        if(stages[i - 1].busy && !stages[i].busy) {
+            stages[i] = stages[i - 1];
+            stages[i - 1].busy = false;
+
+            // If LOAD, perform the read in stage 1
+            if(i == 1 && !stages[1].is_store) {
+                stages[1].data = read_memory(stages[1].address);
+            }
+            APEX_TRACE(LOG_MEMFU, "MemFU: Advanced stage %d to %d\n", i - 1, i);
         }
-        printf("MemFU: Advanced stage 0 to 1\n");
     }
+    return result;
 }
 
-void MemoryFU::execute() {
-    printf("\nMemFU Execute Cycle:\n");
+MemFUResult MemoryFU::execute() {
+    APEX_TRACE(LOG_MEMFU, "\nMemFU Execute Cycle:\n");
     
     // First advance existing operations
-    advance_stages();
+    MemFUResult result = advance_stages();
     
     // Process each stage
-    for(int i = 0; i < 3; i++) {
+    for(int i = 0; i < (int)stages.size(); i++) {
         if(stages[i].busy) {
-            printf("Stage %d: Processing LSQ entry %d\n", 
+            APEX_TRACE(LOG_MEMFU, "Stage %d: Processing LSQ entry %d\n", 
                    i, stages[i].lsq_index);
         }
     }
+    return result;
+}
+
+void MemoryFU::squash(int lsq_index) {
+    for(int i = 0; i < (int)stages.size(); i++) {
+        if(stages[i].busy && stages[i].lsq_index == lsq_index) {
+            stages[i].busy = false;
+        }
+    }
 }
 
 uint32_t MemoryFU::read_memory(uint32_t address) {
-    if(address < 4096) {
-        printf("MemFU: Reading 0x%x from address 0x%x\n", 
+    if(port) {
+        return port->read(address);
+    }
+    if(address < memory.size()) {
+        APEX_TRACE(LOG_MEMFU, "MemFU: Reading 0x%x from address 0x%x\n", 
                memory[address], address);
         return memory[address];
     }
@@ -97,16 +135,30 @@ uint32_t MemoryFU::read_memory(uint32_t address) {
 }
 
 void MemoryFU::write_memory(uint32_t address, uint32_t data) {
-    if(address < 4096) {
-        printf("MemFU: Writing 0x%x to address 0x%x\n", 
+    if(port) {
+        port->write(address, data);
+        return;
+    }
+    if(address < memory.size()) {
+        APEX_TRACE(LOG_MEMFU, "MemFU: Writing 0x%x to address 0x%x\n", 
                data, address);
         memory[address] = data;
     }
 }
 
+int MemoryFU::load_data(const char* filename) {
+    return load_data_memory(filename, memory.data(), (int)memory.size());
+}
+
+void MemoryFU::load_image(const std::vector<uint32_t>& image) {
+    for(size_t i = 0; i < memory.size() && i < image.size(); i++) {
+        memory[i] = image[i];
+    }
+}
+
 void MemoryFU::display_status() {
     printf("\nMemory FU Status:\n");
-    for(int i = 0; i < 3; i++) {
+    for(int i = 0; i < (int)stages.size(); i++) {
         printf("Stage %d: %s", i, stages[i].busy ? "BUSY" : "FREE");
         if(stages[i].busy) {
             printf(" - LSQ:%d %s Addr:0x%x", 
@@ -0,0 +1,46 @@
+// src/memory_profile.cpp
+#include "memory_profile.h"
+#include "stats_registry.h"
+#include <stdio.h>
+
+MemoryProfile::MemoryProfile(int mem_stages)
+    : address_wait("address_wait", LOAD_LATENCY_LIMIT)
+    , issue_wait("issue_wait", LOAD_LATENCY_LIMIT)
+    , access("access", LOAD_LATENCY_LIMIT)
+    , latency("total", LOAD_LATENCY_LIMIT)
+    , outstanding("outstanding", mem_stages)
+{
+    loads = 0;
+    active_cycles = 0;
+    outstanding_sum = 0;
+}
+
+void MemoryProfile::register_stats(StatsRegistry& stats) const {
+    stats.add_counter("lsq.loads", "Loads that returned data", &loads);
+    stats.add_histogram("lsq.load.address_wait", "Cycles from dispatch to address ready",
+                        &address_wait);
+    stats.add_histogram("lsq.load.issue_wait", "Cycles from address ready to issue",
+                        &issue_wait);
+    stats.add_histogram("memfu.load.access", "Cycles from issue to data return", &access);
+    stats.add_histogram("lsq.load.latency", "Cycles from dispatch to data return", &latency);
+    stats.add_histogram("memfu.outstanding", "Memory ops in flight per cycle", &outstanding);
+    stats.add_counter("memfu.active_cycles", "Cycles with a memory op in flight",
+                      &active_cycles);
+    stats.add_formula("memfu.mlp", "Average memory ops in flight while any is", [this]() {
+        return get_mlp();
+    });
+}
+
+void MemoryProfile::print() const {
+    printf("Load latency (%lu loads, cycles):\n", (unsigned long)loads);
+    if (loads > 0) {
+        printf("  %-12s %5s %7s %5s %5s %5s %5s %7s\n",
+               "phase", "limit", "mean", "p50", "p90", "p99", "max", "limit%");
+        address_wait.print();
+        issue_wait.print();
+        access.print();
+        latency.print();
+    }
+    printf("Memory-level parallelism: average %.2f over %lu busy cycles, peak %d\n", get_mlp(),
+           (unsigned long)active_cycles, get_peak_mlp());
+}
@@ -0,0 +1,107 @@
+// src/mul_fu.cpp
+#include "mul_fu.h"
+#include "apex_log.h"
+#include <stdio.h>
+
+MultiplyFU::MultiplyFU(int num_stages) {
+    stages.resize(num_stages);
+    clear();
+}
+
+bool MultiplyFU::can_accept() {
+    return !stages[0].busy;
+}
+
+bool MultiplyFU::issue(uint32_t pc, uint32_t s1, uint32_t s2, uint32_t rob_idx,
+                       uint32_t s1_tag, uint32_t s2_tag) {
+    if (!can_accept()) {
+        return false;
+    }
+
+    stages[0].busy = true;
+    stages[0].pc = pc;
+    stages[0].src1_value = s1;
+    stages[0].src2_value = s2;
+    stages[0].src1_tag = s1_tag;
+    stages[0].src2_tag = s2_tag;
+    stages[0].rob_index = rob_idx;
+
+    APEX_DEBUG(LOG_MULFU, "MulFU: Issued PC=0x%x, src1=0x%x, src2=0x%x\n", pc, s1, s2);
+    return true;
+}
+
+// Operands are captured in whichever stage the instruction has reached
+void MultiplyFU::on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) {
+    if (is_cc) {
+        return;
+    }
+    for (int i = 0; i < (int)stages.size(); i++) {
+        if (!stages[i].busy) continue;
+        if (stages[i].src1_tag == tag) {
+            stages[i].src1_value = value;
+            stages[i].src1_tag = REG_NONE;
+        }
+        if (stages[i].src2_tag == tag) {
+            stages[i].src2_value = value;
+            stages[i].src2_tag = REG_NONE;
+        }
+    }
+}
+
+MulFUResult MultiplyFU::execute() {
+    MulFUResult result = {0};
+
+    // Last stage produces the product
+    const int last = (int)stages.size() - 1;
+    if (stages[last].busy) {
+        result.valid = true;
+        result.value = stages[last].src1_value * stages[last].src2_value;
+        result.rob_index = stages[last].rob_index;
+        if (result.value == 0) result.cc_flags = CC_ZERO;
+        else if ((int32_t)result.value < 0) result.cc_flags = CC_NEGATIVE;
+        else result.cc_flags = CC_POSITIVE;
+        stages[last].busy = false;
+        APEX_DEBUG(LOG_MULFU, "MulFU: Completed PC=0x%x, result=0x%x\n", stages[last].pc, result.value);
+    }
+
+    // Move remaining operations one stage forward
+    for (int i = last; i > 0; i--) {
+        if (stages[i - 1].busy) {
+            stages[i] = stages[i - 1];
+            stages[i - 1].busy = false;
+        }
+    }
+    return result;
+}
+
+bool MultiplyFU::is_busy() const {
+    for (int i = 0; i < (int)stages.size(); i++) {
+        if (stages[i].busy) return true;
+    }
+    return false;
+}
+
+void MultiplyFU::clear() {
+    for (int i = 0; i < (int)stages.size(); i++) {
+        stages[i].busy = false;
+    }
+}
+
+void MultiplyFU::squash(uint32_t rob_idx) {
+    for (int i = 0; i < (int)stages.size(); i++) {
+        if (stages[i].busy && stages[i].rob_index == rob_idx) {
+            stages[i].busy = false;
+        }
+    }
+}
+
+void MultiplyFU::display_status() {
+    printf("\nMultiply FU Status:\n");
+    for (int i = 0; i < (int)stages.size(); i++) {
+        printf("Stage %d: %s", i, stages[i].busy ? "BUSY" : "FREE");
+        if (stages[i].busy) {
+            printf(" - PC=0x%x ROB=%d", stages[i].pc, stages[i].rob_index);
+        }
+        printf("\n");
+    }
+}
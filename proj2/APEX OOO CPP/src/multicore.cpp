@@ -0,0 +1,149 @@
+// src/multicore.cpp
+#include "multicore.h"
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <time.h>
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Reusable barrier whose last arriving thread runs the quantum step
+// before anyone continues
+class QuantumBarrier {
+private:
+    std::mutex lock;
+    std::condition_variable released;
+    int count;
+    int waiting;
+    uint64_t generation;
+
+public:
+    QuantumBarrier(int threads) {
+        count = threads;
+        waiting = 0;
+        generation = 0;
+    }
+
+    template <typename Step>
+    void arrive(Step step) {
+        std::unique_lock<std::mutex> guard(lock);
+        uint64_t arrived = generation;
+        if (++waiting == count) {
+            step();
+            waiting = 0;
+            generation++;
+            released.notify_all();
+        } else {
+            released.wait(guard, [&]() { return generation != arrived; });
+        }
+    }
+};
+
+MulticoreSim::MulticoreSim(const SimConfig& sim_config, int num_cores, uint64_t quantum_cycles,
+                           int transfer_cycles, int upgrade_cycles)
+    : config(sim_config),
+      memory(num_cores, sim_config.memory_size,
+             sim_config.dcache_sets > 0 ? sim_config.dcache_sets : 16, sim_config.dcache_ways,
+             sim_config.dcache_line, sim_config.dcache_miss_penalty, transfer_cycles,
+             upgrade_cycles) {
+    quantum = quantum_cycles > 0 ? quantum_cycles : 1;
+    threads = 0;
+    host_seconds = 0.0;
+    for (int c = 0; c < memory.get_cores(); c++) {
+        cores.push_back(std::unique_ptr<APEX_CPU>(new APEX_CPU(config)));
+        cores[c]->attach_memory(&memory.get_port(c));
+    }
+}
+
+void MulticoreSim::load_program(int core, const std::vector<APEX_Instruction>& program,
+                                int id_reg) {
+    ArchCheckpoint start;
+    memset(start.regs, 0, sizeof(start.regs));
+    start.insns = 0;
+    start.pc = CODE_BASE_ADDRESS;
+    start.cc = 0;
+    start.halted = false;
+    if (id_reg >= 0 && id_reg < 32) {
+        start.regs[id_reg] = core;
+    }
+    cores[core]->load_checkpoint(program, start);  // Memory is shared, no image
+}
+
+void MulticoreSim::run(int jobs, uint64_t max_cycles) {
+    int n = (int)cores.size();
+    if (jobs <= 0) {
+        jobs = (int)std::thread::hardware_concurrency();
+    }
+    threads = std::max(1, std::min(jobs, n));
+
+    QuantumBarrier barrier(threads);
+    uint64_t quantum_end = max_cycles > 0 ? std::min(quantum, max_cycles) : quantum;
+    bool done = false;
+
+    // Thread t simulates cores t, t + threads, ...
+    auto worker = [&](int t) {
+        while (true) {
+            for (int c = t; c < n; c += threads) {
+                APEX_CPU& cpu = *cores[c];
+                CoherentL1& port = memory.get_port(c);
+                while (!cpu.is_halted() && cpu.get_cycles() < quantum_end) {
+                    port.set_cycle(cpu.get_cycles());
+                    cpu.single_step();
+                }
+            }
+            barrier.arrive([&]() {
+                memory.synchronize();
+                bool running = false;
+                for (int c = 0; c < n; c++) {
+                    running = running || !cores[c]->is_halted();
+                }
+                done = !running || (max_cycles > 0 && quantum_end >= max_cycles);
+                quantum_end += quantum;
+                if (max_cycles > 0 && quantum_end > max_cycles) {
+                    quantum_end = max_cycles;
+                }
+            });
+            if (done) break;
+        }
+    };
+
+    double begin = host_now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+    host_seconds = host_now() - begin;
+}
+
+void MulticoreSim::print(FILE* out) const {
+    fprintf(out, "Multicore: %d cores, quantum %lu cycles, %d threads, %.3f s\n",
+            (int)cores.size(), (unsigned long)quantum, threads, host_seconds);
+    uint64_t last = 0;
+    for (size_t c = 0; c < cores.size(); c++) {
+        const APEX_CPU& cpu = *cores[c];
+        uint64_t cycles = cpu.get_cycles();
+        fprintf(out, "  core %-3d cycles %10lu instructions %10lu IPC %.3f%s\n", (int)c,
+                (unsigned long)cycles, (unsigned long)cpu.get_committed(),
+                cycles ? (double)cpu.get_committed() / cycles : 0.0,
+                cpu.is_halted() ? "" : " (not halted)");
+        last = std::max(last, cycles);
+    }
+    fprintf(out, "  parallel run time %lu cycles\n", (unsigned long)last);
+    memory.print(out);
+}
+
+void MulticoreSim::dump_memory(FILE* out, uint32_t from, uint32_t to) const {
+    for (uint32_t a = from; a < to; a++) {
+        fprintf(out, "  MEM[%u] = %d\n", a, (int)memory.read(a));
+    }
+}
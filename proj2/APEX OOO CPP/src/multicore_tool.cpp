@@ -0,0 +1,113 @@
+// src/multicore_tool.cpp
+// Runs N APEX cores on one shared, coherent data memory.
+#include "multicore.h"
+#include "apex_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s <input_file>[,input_file...] [data_file] [options]\n", prog);
+    fprintf(stderr, "  --cores=N          Number of cores (default one per input file)\n");
+    fprintf(stderr, "                     core i runs input file i modulo the number given\n");
+    fprintf(stderr, "  --id-reg=N         Register holding the core id at start (default 31, -1 = none)\n");
+    fprintf(stderr, "  --quantum=N        Cycles between coherence barriers (default 10)\n");
+    fprintf(stderr, "  --transfer-latency=N  Extra cycles of a miss served by another L1 (default 4)\n");
+    fprintf(stderr, "  --upgrade-latency=N   Extra cycles of a write to a shared line (default 2)\n");
+    fprintf(stderr, "  --jobs=N           Host threads (default all)\n");
+    fprintf(stderr, "  --cycles=N         Stop after N cycles (0 = until every core halts)\n");
+    fprintf(stderr, "  --dump=A:B         Print shared memory words [A, B) at the end\n");
+    fprintf(stderr, "  --config=FILE, --set key=value, --key=value  Per-core parameters as in apex_sim;\n");
+    fprintf(stderr, "                     the L1s use the dcache_* keys (16 sets when dcache_sets = 0)\n");
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    std::vector<const char*> overrides;
+    const char* config_file = NULL;
+    const char* input_list = NULL;
+    const char* data_file = NULL;
+    int cores = 0, id_reg = 31, transfer = 4, upgrade = 2, jobs = 0;
+    unsigned long quantum = 10, max_cycles = 0, dump_from = 0, dump_to = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--cores=%d", &cores) == 1) continue;
+        if (sscanf(arg, "--id-reg=%d", &id_reg) == 1) continue;
+        if (sscanf(arg, "--quantum=%lu", &quantum) == 1) continue;
+        if (sscanf(arg, "--transfer-latency=%d", &transfer) == 1) continue;
+        if (sscanf(arg, "--upgrade-latency=%d", &upgrade) == 1) continue;
+        if (sscanf(arg, "--jobs=%d", &jobs) == 1) continue;
+        if (sscanf(arg, "--cycles=%lu", &max_cycles) == 1) continue;
+        if (sscanf(arg, "--dump=%lu:%lu", &dump_from, &dump_to) == 2) continue;
+        if (strncmp(arg, "--config=", 9) == 0) {
+            config_file = arg + 9;
+        } else if (strcmp(arg, "--set") == 0 && i + 1 < argc) {
+            overrides.push_back(argv[++i]);
+        } else if (strncmp(arg, "--", 2) == 0 && strchr(arg, '=')) {
+            overrides.push_back(arg + 2);
+        } else if (arg[0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else if (!input_list) {
+            input_list = arg;
+        } else if (!data_file) {
+            data_file = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!input_list) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (config_file && !config.load_file(config_file)) {
+        return 1;
+    }
+    for (size_t i = 0; i < overrides.size(); i++) {
+        if (!config.set(overrides[i])) {
+            return 1;
+        }
+    }
+    if (!config.validate()) {
+        fprintf(stderr, "APEX_Error: Invalid configuration\n");
+        return 1;
+    }
+
+    std::vector<std::vector<APEX_Instruction> > programs;
+    char names[1024];
+    strncpy(names, input_list, sizeof(names) - 1);
+    names[sizeof(names) - 1] = '\0';
+    for (char* name = strtok(names, ","); name; name = strtok(NULL, ",")) {
+        programs.push_back(std::vector<APEX_Instruction>());
+        if (!create_code_memory(name, programs.back())) {
+            return 1;
+        }
+    }
+    if (cores <= 0) {
+        cores = (int)programs.size();
+    }
+    if (cores > MAX_COHERENT_CORES) {
+        fprintf(stderr, "APEX_Error: At most %d cores\n", MAX_COHERENT_CORES);
+        return 1;
+    }
+
+    MulticoreSim sim(config, cores, quantum, transfer, upgrade);
+    if (data_file && sim.load_data(data_file) < 0) {
+        return 1;
+    }
+    for (int c = 0; c < cores; c++) {
+        sim.load_program(c, programs[c % programs.size()], id_reg);
+    }
+
+    Logger::start();
+    sim.run(jobs, max_cycles);
+    Logger::stop();
+    sim.print(stdout);
+    if (dump_to > dump_from) {
+        printf("Shared memory:\n");
+        sim.dump_memory(stdout, (uint32_t)dump_from, (uint32_t)dump_to);
+    }
+    return 0;
+}
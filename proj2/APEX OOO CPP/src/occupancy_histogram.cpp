@@ -0,0 +1,48 @@
+// src/occupancy_histogram.cpp
+#include "occupancy_histogram.h"
+
+OccupancyHistogram::OccupancyHistogram(const char* name, int capacity) {
+    this->name = name;
+    this->capacity = capacity > 0 ? capacity : 1;
+    bucket_width = (this->capacity + MAX_BUCKETS) / MAX_BUCKETS;
+    buckets.assign(this->capacity / bucket_width + 1, 0);
+    samples = 0;
+    sum = 0;
+    at_full = 0;
+    max_seen = 0;
+}
+
+double OccupancyHistogram::get_mean() const {
+    return samples ? (double)sum / samples : 0.0;
+}
+
+int OccupancyHistogram::get_percentile(double pct) const {
+    if (samples == 0) return 0;
+    uint64_t target = (uint64_t)(pct / 100.0 * samples + 0.5);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            int upper = (int)(i + 1) * bucket_width - 1;
+            return upper < max_seen ? upper : max_seen;
+        }
+    }
+    return max_seen;
+}
+
+double OccupancyHistogram::get_full_fraction() const {
+    return samples ? (double)at_full / samples : 0.0;
+}
+
+void OccupancyHistogram::print_header() {
+    printf("  %-12s %5s %7s %5s %5s %5s %5s %7s\n",
+           "structure", "size", "mean", "p50", "p90", "p99", "max", "full%");
+}
+
+void OccupancyHistogram::print() const {
+    printf("  %-12s %5d %7.2f %5d %5d %5d %5d %6.1f%%\n", name, capacity, get_mean(),
+           get_percentile(50), get_percentile(90), get_percentile(99), max_seen,
+           100.0 * get_full_fraction());
+}
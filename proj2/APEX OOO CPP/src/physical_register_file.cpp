@@ -0,0 +1,38 @@
+// src/physical_register_file.cpp
+#include "physical_register_file.h"
+#include <stdio.h>
+
+PhysicalRegisterFile::PhysicalRegisterFile(int size, bool cc_file) {
+    values.assign(size, 0);
+    ready.assign(size, true);
+    holds_cc = cc_file;
+}
+
+void PhysicalRegisterFile::write(uint32_t tag, uint32_t value) {
+    if (tag < values.size()) {
+        values[tag] = value;
+        ready[tag] = true;
+    }
+}
+
+void PhysicalRegisterFile::allocate(uint32_t tag) {
+    if (tag < ready.size()) {
+        ready[tag] = false;
+    }
+}
+
+void PhysicalRegisterFile::on_value_broadcast(uint32_t tag, uint32_t value, bool is_cc) {
+    if (is_cc == holds_cc) {
+        write(tag, value);
+    }
+}
+
+void PhysicalRegisterFile::display_status() {
+    printf("\n%s Status:\n", holds_cc ? "UCRF" : "UPRF");
+    for (size_t i = 0; i < values.size(); i++) {
+        printf("%c%-3d[%-5d]%c ", holds_cc ? 'C' : 'P', (int)i, (int)values[i],
+               ready[i] ? ' ' : '*');
+        if (i % 8 == 7) printf("\n");
+    }
+    printf("\n");
+}
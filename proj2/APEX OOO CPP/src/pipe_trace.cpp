@@ -0,0 +1,167 @@
+// src/pipe_trace.cpp
+#include "pipe_trace.h"
+#include <string.h>
+
+PipeTrace::PipeTrace(int rob_size) {
+    inflight.resize(rob_size > 0 ? rob_size : 1);
+    for (size_t i = 0; i < inflight.size(); i++) {
+        inflight[i].active = false;
+    }
+    text_file = NULL;
+    binary_file = NULL;
+    from_cycle = 0;
+    to_cycle = 0;
+    records = 0;
+}
+
+PipeTrace::~PipeTrace() {
+    close();
+}
+
+bool PipeTrace::open(const char* text_path, const char* binary_path, uint64_t from, uint64_t to) {
+    close();
+    from_cycle = from;
+    to_cycle = to;
+
+    if (text_path) {
+        text_file = fopen(text_path, "w");
+        if (!text_file) {
+            fprintf(stderr, "PipeTrace: Unable to open %s\n", text_path);
+            return false;
+        }
+        setvbuf(text_file, NULL, _IOFBF, 1 << 16);
+    }
+    if (binary_path) {
+        binary_file = fopen(binary_path, "wb");
+        if (!binary_file) {
+            fprintf(stderr, "PipeTrace: Unable to open %s\n", binary_path);
+            close();
+            return false;
+        }
+        setvbuf(binary_file, NULL, _IOFBF, 1 << 16);
+
+        uint32_t header[2] = { PIPE_TRACE_VERSION, (uint32_t)sizeof(PipeBinaryRecord) };
+        fwrite(PIPE_TRACE_MAGIC, 1, 8, binary_file);
+        fwrite(header, sizeof(header), 1, binary_file);
+    }
+    return true;
+}
+
+// Instructions still in flight were neither retired nor squashed, drop them
+void PipeTrace::close() {
+    if (text_file) {
+        fclose(text_file);
+        text_file = NULL;
+    }
+    if (binary_file) {
+        fclose(binary_file);
+        binary_file = NULL;
+    }
+    for (size_t i = 0; i < inflight.size(); i++) {
+        inflight[i].active = false;
+    }
+}
+
+void PipeTrace::on_dispatch(int rob_idx, uint64_t seq, uint32_t pc, const APEX_Instruction& insn,
+                            uint64_t fetch, uint64_t decode, uint64_t cycle) {
+    PipeRecord& rec = inflight[rob_idx];
+    rec.active = is_enabled() && fetch >= from_cycle && (to_cycle == 0 || fetch < to_cycle);
+    if (!rec.active) {
+        return;
+    }
+    rec.seq = seq;
+    rec.pc = pc;
+    rec.type = insn.type;
+    format_instruction(insn, rec.disasm, sizeof(rec.disasm));
+    rec.fetch = fetch;
+    rec.decode = decode;
+    rec.dispatch = cycle;
+    rec.issue = 0;
+    rec.complete = 0;
+}
+
+void PipeTrace::on_retire(int rob_idx, uint64_t cycle) {
+    if (inflight[rob_idx].active) {
+        write_record(inflight[rob_idx], cycle, false);
+        inflight[rob_idx].active = false;
+    }
+}
+
+void PipeTrace::on_squash(int rob_idx, uint64_t cycle) {
+    if (inflight[rob_idx].active) {
+        write_record(inflight[rob_idx], cycle, true);
+        inflight[rob_idx].active = false;
+    }
+}
+
+void PipeTrace::on_frontend_squash(uint64_t seq, uint32_t pc, const APEX_Instruction& insn,
+                                   uint64_t fetch, uint64_t decode, uint64_t cycle) {
+    if (!is_enabled() || fetch < from_cycle || (to_cycle != 0 && fetch >= to_cycle)) {
+        return;
+    }
+    PipeRecord rec;
+    rec.active = false;
+    rec.seq = seq;
+    rec.pc = pc;
+    rec.type = insn.type;
+    format_instruction(insn, rec.disasm, sizeof(rec.disasm));
+    rec.fetch = fetch;
+    rec.decode = decode;
+    rec.dispatch = 0;
+    rec.issue = 0;
+    rec.complete = 0;
+    write_record(rec, cycle, true);
+}
+
+// Stages that were never reached are written as tick 0, which is how
+// O3PipeView marks a squashed instruction
+void PipeTrace::write_record(const PipeRecord& rec, uint64_t end_cycle, bool squashed) {
+    records++;
+
+    if (text_file) {
+        const uint64_t t = PIPE_TRACE_TICKS_PER_CYCLE;
+        fprintf(text_file, "O3PipeView:fetch:%lu:0x%08x:0:%lu:%s\n",
+                (unsigned long)(rec.fetch * t), rec.pc, (unsigned long)rec.seq, rec.disasm);
+        fprintf(text_file, "O3PipeView:decode:%lu\n", (unsigned long)(rec.decode * t));
+        fprintf(text_file, "O3PipeView:rename:%lu\n", (unsigned long)(rec.dispatch * t));
+        fprintf(text_file, "O3PipeView:dispatch:%lu\n", (unsigned long)(rec.dispatch * t));
+        fprintf(text_file, "O3PipeView:issue:%lu\n", (unsigned long)(rec.issue * t));
+        fprintf(text_file, "O3PipeView:complete:%lu\n", (unsigned long)(rec.complete * t));
+        fprintf(text_file, "O3PipeView:retire:%lu:store:%lu\n",
+                squashed ? 0UL : (unsigned long)(end_cycle * t),
+                (!squashed && rec.type == STORE) ? (unsigned long)(end_cycle * t) : 0UL);
+    }
+
+    if (binary_file) {
+        PipeBinaryRecord out;
+        memset(&out, 0, sizeof(out));
+        out.seq = rec.seq;
+        out.pc = rec.pc;
+        out.type = (uint8_t)rec.type;
+        out.squashed = squashed ? 1 : 0;
+        out.fetch = rec.fetch;
+        out.decode = rec.decode ? (uint32_t)(rec.decode - rec.fetch) : PIPE_TRACE_NOT_REACHED;
+        out.rename = rec.dispatch ? (uint32_t)(rec.dispatch - rec.fetch) : PIPE_TRACE_NOT_REACHED;
+        out.dispatch = out.rename;
+        out.issue = rec.issue ? (uint32_t)(rec.issue - rec.fetch) : PIPE_TRACE_NOT_REACHED;
+        out.complete = rec.complete ? (uint32_t)(rec.complete - rec.fetch) : PIPE_TRACE_NOT_REACHED;
+        out.retire = (uint32_t)(end_cycle - rec.fetch);
+        fwrite(&out, sizeof(out), 1, binary_file);
+    }
+}
+
+void PipeTrace::format_instruction(const APEX_Instruction& insn, char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "%s", insn.opcode_str);
+    const uint32_t regs[4] = { insn.rd, insn.rs1, insn.rs2, insn.rs3 };
+    const char* sep = " ";
+
+    for (int i = 0; i < 4 && len < (int)size; i++) {
+        if (regs[i] != REG_NONE) {
+            len += snprintf(buffer + len, size - len, "%sR%u", sep, regs[i]);
+            sep = ",";
+        }
+    }
+    if (len < (int)size && (insn.imm != 0 || insn.type == MOVC)) {
+        snprintf(buffer + len, size - len, "%s#%d", sep, insn.imm);
+    }
+}
@@ -1,7 +1,11 @@
 #include "register_manager.h"
+#include "apex_log.h"
 #include <stdio.h>
 
-RegisterManager::RegisterManager() {
+RegisterManager::RegisterManager(int uprf_size, int ucrf_size, int checkpoint_limit)
+    : free_list_uprf(uprf_size), free_list_ucrf(ucrf_size) {
+    max_checkpoints = checkpoint_limit;
+
     // Initialize frontend and backend RATs
     for (int i = 0; i < 32; i++) {
         frontend_rat[i].phys_reg = i;
@@ -16,20 +20,16 @@ RegisterManager::RegisterManager() {
     backend_cc_rat[0].valid = true;
 
     // Initialize free lists
-    for (uint32_t i = 32; i < 60; i++) {
+    for (uint32_t i = 32; i < (uint32_t)uprf_size; i++) {
         free_list_uprf.push(i);
     }
-    for (uint32_t i = 1; i < 10; i++) {
+    for (uint32_t i = 1; i < (uint32_t)ucrf_size; i++) {
         free_list_ucrf.push(i);
     }
 
     // Initialize valid bits
-    for (int i = 0; i < 60; i++) {
-        uprf_valid[i] = true;
-    }
-    for (int i = 0; i < 10; i++) {
-        ucrf_valid[i] = true;
-    }
+    uprf_valid.assign(uprf_size, true);
+    ucrf_valid.assign(ucrf_size, true);
 }
 
 RegisterManager::~RegisterManager() {
@@ -47,6 +47,17 @@ uint32_t RegisterManager::allocate_physical_register() {
     return reg;
 }
 
+uint32_t RegisterManager::allocate_cc_register() {
+    if (free_list_ucrf.empty()) {
+        return -1;  // No free CC registers
+    }
+
+    uint32_t reg = free_list_ucrf.front();
+    free_list_ucrf.pop();
+    ucrf_valid[reg] = false;  // Mark as allocated
+    return reg;
+}
+
 void RegisterManager::update_frontend_table(uint32_t arch_reg, uint32_t phys_reg) {
     if (arch_reg < 32) {
         frontend_rat[arch_reg].phys_reg = phys_reg;
@@ -66,13 +77,62 @@ void RegisterManager::update_backend_table(uint32_t arch_reg, uint32_t phys_reg)
     }
 }
 
+void RegisterManager::update_frontend_cc(uint32_t phys_reg) {
+    frontend_cc_rat[0].phys_reg = phys_reg;
+    frontend_cc_rat[0].valid = true;
+}
+
+void RegisterManager::update_backend_cc(uint32_t phys_reg) {
+    // Free the old CC register
+    free_cc_register(backend_cc_rat[0].phys_reg);
+
+    backend_cc_rat[0].phys_reg = phys_reg;
+    backend_cc_rat[0].valid = true;
+}
+
 void RegisterManager::free_physical_register(uint32_t phys_reg) {
-    if (phys_reg >= 32 && phys_reg < 60) {
+    if (phys_reg < uprf_valid.size()) {
         free_list_uprf.push(phys_reg);
         uprf_valid[phys_reg] = true;
+
+        // Registers freed at commit are also free on every younger speculative path
+        for (size_t i = 0; i < checkpoints.size(); i++) {
+            if (checkpoints[i].valid) {
+                checkpoints[i].free_list_uprf.push(phys_reg);
+            }
+        }
+    }
+}
+
+void RegisterManager::free_cc_register(uint32_t phys_reg) {
+    if (phys_reg < ucrf_valid.size()) {
+        free_list_ucrf.push(phys_reg);
+        ucrf_valid[phys_reg] = true;
+
+        for (size_t i = 0; i < checkpoints.size(); i++) {
+            if (checkpoints[i].valid) {
+                checkpoints[i].free_list_ucrf.push(phys_reg);
+            }
+        }
     }
 }
 
+bool RegisterManager::is_register_available() {
+    return !free_list_uprf.empty();
+}
+
+bool RegisterManager::is_cc_available() {
+    return !free_list_ucrf.empty();
+}
+
+uint32_t RegisterManager::get_physical_register(uint32_t arch_reg) {
+    return arch_reg < 32 ? frontend_rat[arch_reg].phys_reg : REG_NONE;
+}
+
+uint32_t RegisterManager::get_cc_register() {
+    return frontend_cc_rat[0].phys_reg;
+}
+
 int RegisterManager::create_checkpoint(uint32_t control_tag) {
     Checkpoint cp;
     
@@ -87,23 +147,28 @@ int RegisterManager::create_checkpoint(uint32_t control_tag) {
     cp.free_list_ucrf = free_list_ucrf;
 
     // Save valid bits
-    for (int i = 0; i < 60; i++) {
-        cp.valid_bits[i] = uprf_valid[i];
-    }
-    for (int i = 0; i < 10; i++) {
-        cp.cc_valid_bits[i] = ucrf_valid[i];
-    }
+    cp.valid_bits = uprf_valid;
+    cp.cc_valid_bits = ucrf_valid;
 
     cp.control_tag = control_tag;
+    cp.valid = true;
 
+    // Reuse a released slot so checkpoint IDs stay stable while in flight
+    for (size_t i = 0; i < checkpoints.size(); i++) {
+        if (!checkpoints[i].valid) {
+            checkpoints[i] = cp;
+            return i;
+        }
+    }
     checkpoints.push_back(cp);
     return checkpoints.size() - 1;
 }
 
 // Add this to src/register_manager.cpp
 void RegisterManager::restore_checkpoint(int checkpoint_id) {
-    if (checkpoint_id < 0 || checkpoint_id >= (int)checkpoints.size()) {
-        printf("Invalid checkpoint ID\n");
+    if (checkpoint_id < 0 || checkpoint_id >= (int)checkpoints.size() ||
+        !checkpoints[checkpoint_id].valid) {
+        APEX_WARN(LOG_RENAME, "Invalid checkpoint ID\n");
         return;
     }
 
@@ -119,21 +184,34 @@ void RegisterManager::restore_checkpoint(int checkpoint_id) {
     free_list_uprf = cp.free_list_uprf;
     free_list_ucrf = cp.free_list_ucrf;
 
-    // Restore valid bits
-    for (int i = 0; i < 60; i++) {
-        uprf_valid[i] = cp.valid_bits[i];
-    }
-    for (int i = 0; i < 10; i++) {
-        ucrf_valid[i] = cp.cc_valid_bits[i];
+    // Valid bits are not restored: registers that survive the rollback may
+    // have been written since the checkpoint was taken
+
+    APEX_DEBUG(LOG_RENAME, "Restored checkpoint %d\n", checkpoint_id);
+}
+
+void RegisterManager::free_checkpoint(int checkpoint_id) {
+    if (checkpoint_id >= 0 && checkpoint_id < (int)checkpoints.size()) {
+        checkpoints[checkpoint_id].valid = false;
     }
+}
 
-    printf("Restored checkpoint %d\n", checkpoint_id);
+bool RegisterManager::is_checkpoint_available() {
+    return get_checkpoint_count() < max_checkpoints;  // One checkpoint per unresolved control instruction
+}
+
+int RegisterManager::get_checkpoint_count() {
+    int live = 0;
+    for (size_t i = 0; i < checkpoints.size(); i++) {
+        if (checkpoints[i].valid) live++;
+    }
+    return live;
 }
 
 void RegisterManager::display_status() {
     printf("\nRegister Manager Status:\n");
-    printf("Free Physical Registers: %lu\n", free_list_uprf.size());
-    printf("Free CC Registers: %lu\n", free_list_ucrf.size());
+    printf("Free Physical Registers: %d\n", free_list_uprf.size());
+    printf("Free CC Registers: %d\n", free_list_ucrf.size());
     
     printf("\nFrontend RAT:\n");
     for (int i = 0; i < 32; i++) {
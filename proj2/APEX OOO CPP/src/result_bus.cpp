@@ -0,0 +1,75 @@
+// src/result_bus.cpp
+#include "result_bus.h"
+#include <stdio.h>
+#include <algorithm>
+
+ResultBus::ResultBus(int ports) {
+    num_ports = ports > 0 ? ports : 1;
+}
+
+void ResultBus::subscribe(ResultBusListener* listener) {
+    listeners.push_back(listener);
+}
+
+void ResultBus::request(const BusResult& result) {
+    pending.push_back(result);
+}
+
+void ResultBus::broadcast_tags() {
+    // Oldest results win the writeback ports, the rest retry next cycle
+    std::sort(pending.begin(), pending.end(),
+              [](const BusResult& a, const BusResult& b) { return a.seq < b.seq; });
+
+    int granted = std::min(num_ports, (int)pending.size());
+    for (int i = 0; i < granted; i++) {
+        const BusResult& result = pending[i];
+        for (size_t l = 0; l < listeners.size(); l++) {
+            if (result.dest_tag != REG_NONE) {
+                listeners[l]->on_tag_broadcast(result.dest_tag, false);
+            }
+            if (result.cc_tag != REG_NONE) {
+                listeners[l]->on_tag_broadcast(result.cc_tag, true);
+            }
+        }
+        tag_stage.push_back(result);
+    }
+    pending.erase(pending.begin(), pending.begin() + granted);
+}
+
+std::vector<BusResult> ResultBus::broadcast_values() {
+    std::vector<BusResult> delivered;
+    delivered.swap(tag_stage);
+
+    for (size_t i = 0; i < delivered.size(); i++) {
+        const BusResult& result = delivered[i];
+        for (size_t l = 0; l < listeners.size(); l++) {
+            if (result.dest_tag != REG_NONE) {
+                listeners[l]->on_value_broadcast(result.dest_tag, result.value, false);
+            }
+            if (result.cc_tag != REG_NONE) {
+                listeners[l]->on_value_broadcast(result.cc_tag, result.cc_flags, true);
+            }
+        }
+    }
+    return delivered;
+}
+
+void ResultBus::flush(uint64_t seq) {
+    std::vector<BusResult>* stages[2] = {&pending, &tag_stage};
+    for (int s = 0; s < 2; s++) {
+        std::vector<BusResult>& list = *stages[s];
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [seq](const BusResult& r) { return r.seq > seq; }),
+                   list.end());
+    }
+}
+
+void ResultBus::display_status() {
+    printf("\nResult Bus Status:\n");
+    printf("Ports: %d, Waiting: %d, Tag Broadcast: %d\n",
+           num_ports, (int)pending.size(), (int)tag_stage.size());
+    for (size_t i = 0; i < tag_stage.size(); i++) {
+        printf("  ROB=%d Tag=%d CC=%d Value=0x%x\n", tag_stage[i].rob_index,
+               (int)tag_stage[i].dest_tag, (int)tag_stage[i].cc_tag, tag_stage[i].value);
+    }
+}
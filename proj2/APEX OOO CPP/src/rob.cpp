@@ -1,31 +1,38 @@
 #include "rob.h"
+#include "apex_log.h"
 #include "apex_cpu.h"
 #include <stdio.h>
 
-ROB::ROB() {
+template <class Capacity>
+ROB_T<Capacity>::ROB_T(int rob_size) : capacity(rob_size) {
+    capacity.allocate(entries);
     head = 0;
     tail = 0;
     count = 0;
 }
 
-bool ROB::is_full() {
-    return count == 80;
+template <class Capacity>
+bool ROB_T<Capacity>::is_full() {
+    return count == capacity.size();
 }
 
-bool ROB::is_empty() {
+template <class Capacity>
+bool ROB_T<Capacity>::is_empty() {
     bool empty = (count == 0);
-    printf("is_empty check - Count: %d, Result: %d\n", count, empty);
+    APEX_TRACE(LOG_ROB, "is_empty check - Count: %d, Result: %d\n", count, empty);
     return empty;
 }
 
-ROB_Entry* ROB::get_entry(int index) {
-    if (index >= 0 && index < 80) {
+template <class Capacity>
+ROB_Entry* ROB_T<Capacity>::get_entry(int index) {
+    if (index >= 0 && index < capacity.size()) {
         return &entries[index];
     }
     return nullptr;
 }
 
-int ROB::add_entry(uint32_t pc, InstructionType type, 
+template <class Capacity>
+int ROB_T<Capacity>::add_entry(uint32_t pc, InstructionType type, 
                    uint32_t dest_arch_reg, uint32_t dest_phys_reg,
                    uint32_t old_phys_reg, uint32_t control_tag) {
     if (is_full()) {
@@ -33,6 +40,7 @@ int ROB::add_entry(uint32_t pc, InstructionType type,
     }
 
     // Create new entry
+    entries[tail] = ROB_Entry();
     entries[tail].pc = pc;
     entries[tail].type = type;
     entries[tail].dest_arch_reg = dest_arch_reg;
@@ -45,94 +53,87 @@ int ROB::add_entry(uint32_t pc, InstructionType type,
     int allocated_index = tail;
     
     // Update tail pointer
-    tail = (tail + 1) % 80;
+    tail = capacity.next(tail);
     count++;
 
     return allocated_index;
 }
 
-void ROB::write_result(int rob_idx, uint32_t value, bool mispredict) {
-    if (rob_idx >= 0 && rob_idx < 80) {
+template <class Capacity>
+void ROB_T<Capacity>::write_result(int rob_idx, uint32_t value, bool mispredict) {
+    if (rob_idx >= 0 && rob_idx < capacity.size()) {
         entries[rob_idx].value = value;
         entries[rob_idx].completed = true;
         entries[rob_idx].mispredicted = mispredict;
     }
 }
 
-bool ROB::commit_entry() {
-    printf("Commit Entry - Head: %d, Tail: %d, Count: %d\n", head, tail, count);
+template <class Capacity>
+bool ROB_T<Capacity>::commit_entry() {
+    APEX_TRACE(LOG_ROB, "Commit Entry - Head: %d, Tail: %d, Count: %d\n", head, tail, count);
     
     if (is_empty()) {
-        printf("Cannot commit: ROB is empty\n");
+        APEX_WARN(LOG_ROB, "Cannot commit: ROB is empty\n");
         return false;
     }
     
     if (!entries[head].completed) {
-        printf("Cannot commit: Entry at head (index %d) is not completed\n", head);
+        APEX_WARN(LOG_ROB, "Cannot commit: Entry at head (index %d) is not completed\n", head);
         return false;
     }
 
     // Entry is ready to commit
-    printf("Committing entry at index %d\n", head);
+    APEX_DEBUG(LOG_ROB, "Committing entry at index %d\n", head);
     
     // Clear the entry
     entries[head] = ROB_Entry();  // Reset entry to default state
 
     // Update head pointer
-    head = (head + 1) % 80;
+    head = capacity.next(head);
     count--;
 
-    printf("After commit - Head: %d, Tail: %d, Count: %d\n", head, tail, count);
+    APEX_TRACE(LOG_ROB, "After commit - Head: %d, Tail: %d, Count: %d\n", head, tail, count);
     return true;
 }
 
-void ROB::rollback(int rob_idx) {
-    if (rob_idx < 0 || rob_idx >= 80) {
+template <class Capacity>
+void ROB_T<Capacity>::rollback(int rob_idx) {
+    if (rob_idx < 0 || rob_idx >= capacity.size()) {
         return; // Invalid index
     }
 
-    // First, verify this is a valid entry within our current ROB bounds
-    bool valid_idx = false;
-    if (head <= tail) {
-        valid_idx = (rob_idx >= head && rob_idx < tail);
-    } else {
-        valid_idx = (rob_idx >= head || rob_idx < tail);
-    }
-
-    if (!valid_idx) {
+    // Valid entries are the count oldest from head; head == tail holds for
+    // both an empty and a full ROB, so the age decides
+    int age = get_age(rob_idx);
+    if (age >= count) {
         return; // Index not in current ROB window
     }
 
-    printf("\nRollback Details (Before):\n");
-    printf("Head: %d, Tail: %d, Count: %d, Rollback Index: %d\n", 
+    APEX_DEBUG(LOG_ROB, "\nRollback Details (Before):\n");
+    APEX_DEBUG(LOG_ROB, "Head: %d, Tail: %d, Count: %d, Rollback Index: %d\n", 
            head, tail, count, rob_idx);
 
     // Calculate new tail position (one after rob_idx)
-    int new_tail = (rob_idx + 1) % 80;
+    int new_tail = capacity.next(rob_idx);
     
     // Clear all entries from new_tail to old tail
     int idx = new_tail;
     while (idx != tail) {
         // Clear the entry
         entries[idx] = ROB_Entry(); // Reset to default state
-        idx = (idx + 1) % 80;
+        idx = capacity.next(idx);
     }
 
-    // Update tail and recalculate count
+    // rob_idx stays the youngest entry
     tail = new_tail;
-    
-    // Recalculate count based on new tail position
-    if (head <= tail) {
-        count = tail - head;
-    } else {
-        count = (80 - head) + tail;
-    }
+    count = age + 1;
 
-    printf("Rollback Details (After):\n");
-    printf("Head: %d, Tail: %d, Count: %d\n", head, tail, count);
+    APEX_DEBUG(LOG_ROB, "Rollback Details (After):\n");
+    APEX_DEBUG(LOG_ROB, "Head: %d, Tail: %d, Count: %d\n", head, tail, count);
 }
 
-void ROB::display_status() {
+template <class Capacity>
+void ROB_T<Capacity>::display_status() {
     printf("ROB Status:\n");
     printf("Head: %d, Tail: %d, Count: %d\n", head, tail, count);
     
@@ -143,8 +144,10 @@ void ROB::display_status() {
         while (entries_shown < count) {
             printf("Index %d: PC=0x%x, Type=%d, Completed=%d\n",
                    i, entries[i].pc, entries[i].type, entries[i].completed);
-            i = (i + 1) % 80;
+            i = capacity.next(i);
             entries_shown++;
         }
     }
-}
\ No newline at end of file
+}
+
+template class ROB_T<CoreVariant::RobCapacity>;
@@ -0,0 +1,196 @@
+// src/sampled_sim.cpp
+#include "sampled_sim.h"
+#include "apex_cpu.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <time.h>
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+SampledSim::SampledSim(const std::vector<APEX_Instruction>& program,
+                       const SimConfig& sim_config, uint64_t interval_insns,
+                       uint64_t warmup_insns)
+    : code(program), config(sim_config) {
+    interval_size = interval_insns;
+    warmup = warmup_insns;
+    threads = 0;
+    host_seconds = 0.0;
+    functional_warming = 0;
+    capture_seconds = 0.0;
+}
+
+// Checkpoints are taken in start order, so one pass covers every sample
+bool SampledSim::capture(const std::vector<SimPointChoice>& points, const char* data_file) {
+    samples = points;
+    std::sort(samples.begin(), samples.end(),
+              [](const SimPointChoice& a, const SimPointChoice& b) {
+                  return a.interval < b.interval;
+              });
+    checkpoints.clear();
+    warm_states.clear();
+
+    FunctionalCore core(code, config.memory_size);
+    if (data_file && core.load_data(data_file) < 0) {
+        return false;
+    }
+    core.enable_translation();  // Fast-forward runs translated hot blocks
+    FunctionalWarmer warmer(code, config);
+    double begin = host_now();
+    std::vector<SimPointChoice> reached;
+    for (size_t i = 0; i < samples.size(); i++) {
+        uint64_t start = samples[i].interval * interval_size;
+        uint64_t warm_start = start > warmup ? start - warmup : 0;
+        if (warm_start > core.get_retired()) {
+            // Full speed up to the warming window, one step at a time inside it
+            uint64_t gap = warm_start - core.get_retired();
+            if (gap > functional_warming) {
+                core.run(gap - functional_warming);
+            }
+            if (functional_warming > 0 && !core.is_halted()) {
+                warmer.run(core, warm_start - core.get_retired());
+            }
+        }
+        if (core.is_halted() || core.get_retired() < warm_start) {
+            printf("Warning: Program ends after %lu instructions, before interval %lu\n",
+                   (unsigned long)core.get_retired(), (unsigned long)samples[i].interval);
+            break;
+        }
+        ArchCheckpoint checkpoint;
+        core.save_checkpoint(checkpoint);
+        checkpoints.push_back(checkpoint);
+        if (functional_warming > 0) {
+            warm_states.push_back(warmer);
+        }
+        reached.push_back(samples[i]);
+    }
+    capture_seconds = host_now() - begin;
+    samples.swap(reached);
+    return !samples.empty();
+}
+
+void SampledSim::simulate(size_t index) {
+    const ArchCheckpoint& checkpoint = checkpoints[index];
+    SampleResult& result = results[index];
+    result.choice = samples[index];
+    result.start = samples[index].interval * interval_size;
+    result.warmup = result.start - checkpoint.insns;
+
+    APEX_CPU cpu(config);
+    cpu.load_checkpoint(code, checkpoint);
+    if (index < warm_states.size()) {
+        warm_states[index].apply(cpu);
+    }
+    cpu.run_until(result.warmup);
+    std::vector<StatValue> before;
+    cpu.get_stats().collect(before);
+    uint64_t cycles = cpu.get_cycles();
+    uint64_t committed = cpu.get_committed();
+
+    cpu.run_until(result.warmup + interval_size);
+    cpu.get_stats().collect(result.deltas);
+    result.cycles = cpu.get_cycles() - cycles;
+    result.insns = cpu.get_committed() - committed;
+    for (size_t i = 0; i < result.deltas.size() && i < before.size(); i++) {
+        result.deltas[i].desc = NULL;  // Owned by this core's registry
+        if (result.deltas[i].is_counter) {
+            result.deltas[i].value -= before[i].value;
+        }
+    }
+}
+
+void SampledSim::run(int jobs) {
+    if (jobs <= 0) {
+        jobs = (int)std::thread::hardware_concurrency();
+    }
+    threads = std::max(1, std::min(jobs, (int)samples.size()));
+    results.assign(samples.size(), SampleResult());
+
+    // Samples take very different times, so workers pull the next one
+    std::atomic<size_t> next(0);
+    auto worker = [this, &next]() {
+        for (size_t i = next++; i < samples.size(); i = next++) {
+            simulate(i);
+        }
+    };
+    double begin = host_now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+    host_seconds = host_now() - begin;
+}
+
+// CPI combines linearly across samples, IPC is its inverse
+double SampledSim::get_cpi() const {
+    double cpi = 0.0, covered = 0.0;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results[i].insns == 0) continue;
+        cpi += results[i].choice.weight * results[i].cycles / results[i].insns;
+        covered += results[i].choice.weight;
+    }
+    return covered > 0.0 ? cpi / covered : 0.0;
+}
+
+void SampledSim::print(FILE* out) const {
+    fprintf(out, "Sampled simulation: %d samples of %lu instructions, %lu warm-up, "
+            "%d threads, %.3f s\n", (int)results.size(), (unsigned long)interval_size,
+            (unsigned long)warmup, threads, host_seconds);
+    if (functional_warming > 0) {
+        // The snapshot at the last checkpoint holds the totals of the pass
+        const FunctionalWarmer* last = warm_states.empty() ? NULL : &warm_states.back();
+        fprintf(out, "Functional pass %.3f s, warmed %lu instructions (%lu control, %lu memory)\n",
+                capture_seconds, (unsigned long)(last ? last->get_warmed() : 0),
+                (unsigned long)(last ? last->get_branches() : 0),
+                (unsigned long)(last ? last->get_accesses() : 0));
+    } else {
+        fprintf(out, "Functional pass %.3f s, no functional warming\n", capture_seconds);
+    }
+    fprintf(out, "  %8s %7s %8s %12s %10s %10s %7s\n", "interval", "cluster", "weight",
+            "start", "insns", "cycles", "IPC");
+    for (size_t i = 0; i < results.size(); i++) {
+        const SampleResult& r = results[i];
+        fprintf(out, "  %8lu %7d %8.4f %12lu %10lu %10lu %7.3f\n",
+                (unsigned long)r.choice.interval, r.choice.cluster, r.choice.weight,
+                (unsigned long)r.start, (unsigned long)r.insns, (unsigned long)r.cycles,
+                r.cycles ? (double)r.insns / r.cycles : 0.0);
+    }
+    double cpi = get_cpi();
+    fprintf(out, "Weighted estimate: CPI %.4f, IPC %.4f\n", cpi, cpi > 0.0 ? 1.0 / cpi : 0.0);
+}
+
+bool SampledSim::write_csv(const char* path) const {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        printf("Error: Unable to open sample stats file %s\n", path);
+        return false;
+    }
+    fprintf(out, "interval,cluster,weight,start,warmup,ipc");
+    if (!results.empty()) {
+        const std::vector<StatValue>& values = results[0].deltas;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i].is_counter) fprintf(out, ",%s", values[i].name.c_str());
+        }
+    }
+    fprintf(out, "\n");
+    for (size_t s = 0; s < results.size(); s++) {
+        const SampleResult& r = results[s];
+        fprintf(out, "%lu,%d,%.6g,%lu,%lu,%.6g", (unsigned long)r.choice.interval,
+                r.choice.cluster, r.choice.weight, (unsigned long)r.start,
+                (unsigned long)r.warmup, r.cycles ? (double)r.insns / r.cycles : 0.0);
+        for (size_t i = 0; i < r.deltas.size(); i++) {
+            if (r.deltas[i].is_counter) fprintf(out, ",%.0f", r.deltas[i].value);
+        }
+        fprintf(out, "\n");
+    }
+    fclose(out);
+    return true;
+}
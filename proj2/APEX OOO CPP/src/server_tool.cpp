@@ -0,0 +1,109 @@
+// src/server_tool.cpp
+// Simulation daemon on a Unix socket, and a client that sends it one request.
+#include "sim_server.h"
+#include "apex_log.h"
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s --socket=PATH [options]               (server)\n", prog);
+    fprintf(stderr, "           %s --socket=PATH <request words...>        (client)\n", prog);
+    fprintf(stderr, "  --jobs=N           Worker threads (default all)\n");
+    fprintf(stderr, "  --keep-jobs=N      Finished jobs kept until fetched (default 1000)\n");
+    fprintf(stderr, "  --program-cache=N  Resident parsed programs, least recently used out (default 16)\n");
+    fprintf(stderr, "  --checkpoint-cache=N  Resident --skip checkpoints, least recently used out (default 16)\n");
+    fprintf(stderr, "  --config=FILE, --set key=value, --key=value  Base parameters of every job\n");
+    fprintf(stderr, "Requests, one per connection, each answered with JSON:\n");
+    fprintf(stderr, "  submit <program> [data] [--cycles=N] [--insns=N] [--skip=N] [--priority=P] [--key=value ...]\n");
+    fprintf(stderr, "  status <id> | result <id> | cancel <id> | list | cache | shutdown\n");
+}
+
+// Client side: files are sent as absolute paths, since the server has its own cwd
+static int run_client(const char* socket_path, int argc, char* argv[], int first) {
+    std::string request;
+    for (int i = first; i < argc; i++) {
+        char resolved[PATH_MAX];
+        const char* word = argv[i];
+        if (word[0] != '-' && i > first && realpath(word, resolved)) {
+            word = resolved;
+        }
+        request += i > first ? " \"" : "\"";
+        request += word;
+        request += "\"";
+    }
+    std::string reply;
+    if (!send_server_request(socket_path, request, reply)) {
+        return 1;
+    }
+    fputs(reply.c_str(), stdout);
+    return strstr(reply.c_str(), "\"error\"") ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    std::vector<const char*> overrides;
+    const char* config_file = NULL;
+    const char* socket_path = NULL;
+    int jobs = 0;
+    int keep_jobs = 1000;
+    int cached_programs = 16;
+    int cached_checkpoints = 16;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--jobs=%d", &jobs) == 1) continue;
+        if (sscanf(arg, "--keep-jobs=%d", &keep_jobs) == 1) continue;
+        if (sscanf(arg, "--program-cache=%d", &cached_programs) == 1) continue;
+        if (sscanf(arg, "--checkpoint-cache=%d", &cached_checkpoints) == 1) continue;
+        if (strncmp(arg, "--socket=", 9) == 0) {
+            socket_path = arg + 9;
+        } else if (strncmp(arg, "--config=", 9) == 0) {
+            config_file = arg + 9;
+        } else if (strcmp(arg, "--set") == 0 && i + 1 < argc) {
+            overrides.push_back(argv[++i]);
+        } else if (strncmp(arg, "--", 2) == 0 && strchr(arg, '=')) {
+            overrides.push_back(arg + 2);
+        } else if (arg[0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            break;  // The rest is a client request
+        }
+    }
+    if (!socket_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (i < argc) {
+        return run_client(socket_path, argc, argv, i);
+    }
+
+    if (config_file && !config.load_file(config_file)) {
+        return 1;
+    }
+    for (size_t o = 0; o < overrides.size(); o++) {
+        if (!config.set(overrides[o])) {
+            return 1;
+        }
+    }
+    if (!config.validate()) {
+        fprintf(stderr, "APEX_Error: Invalid configuration\n");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);  // A client that went away must not stop the server
+    SimServer server(config, socket_path, jobs);
+    server.set_limits(keep_jobs, cached_programs, cached_checkpoints);
+    if (!server.start()) {
+        return 1;
+    }
+    Logger::start();
+    server.run();
+    Logger::stop();
+    return 0;
+}
@@ -0,0 +1,205 @@
+// src/sim_config.cpp
+#include "sim_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+struct ConfigField {
+    const char* name;
+    int SimConfig::*field;
+    int min_value;
+    int max_value;            // Far above any real design, catches typos and overflow
+    bool power_of_two;        // 0 still allowed where min_value is 0
+};
+
+static const ConfigField config_fields[] = {
+    {"fetch_width",    &SimConfig::fetch_width,    1, 64,      false},
+    {"rename_width",   &SimConfig::rename_width,   1, 64,      false},
+    {"issue_width",    &SimConfig::issue_width,    1, 64,      false},
+    {"commit_width",   &SimConfig::commit_width,   1, 64,      false},
+    {"int_fus",        &SimConfig::int_fus,        1, 64,      false},
+    {"mul_stages",     &SimConfig::mul_stages,     1, 64,      false},
+    {"mem_stages",     &SimConfig::mem_stages,     1, 64,      false},
+    {"wb_ports",       &SimConfig::wb_ports,       1, 64,      false},
+    {"rob_size",       &SimConfig::rob_size,       2, 65536,   false},
+    {"iq_size",        &SimConfig::iq_size,        1, 65536,   false},
+    {"lsq_size",       &SimConfig::lsq_size,       1, 65536,   false},
+    {"uprf_size",      &SimConfig::uprf_size,      33, 65536,  false},  // 32 architectural + 1 to rename
+    {"ucrf_size",      &SimConfig::ucrf_size,      2, 65536,   false},
+    {"checkpoints",    &SimConfig::checkpoints,    1, 4096,    false},
+    {"predictor_size", &SimConfig::predictor_size, 1, 65536,   false},
+    {"ras_size",       &SimConfig::ras_size,       1, 4096,    false},
+    {"memory_size",    &SimConfig::memory_size,    1, 1 << 26, false},  // 256 MB of words
+    {"dcache_sets",    &SimConfig::dcache_sets,    0, 1 << 20, true},   // 0 = no cache, fixed latency
+    {"dcache_ways",    &SimConfig::dcache_ways,    1, 64,      true},
+    {"dcache_line",    &SimConfig::dcache_line,    1, 1024,    true},
+    {"dcache_miss_penalty", &SimConfig::dcache_miss_penalty, 0, 100000, false},
+};
+
+static const int num_config_fields = sizeof(config_fields) / sizeof(config_fields[0]);
+
+SimConfig::SimConfig() {
+    fetch_width = 1;
+    rename_width = 1;
+    issue_width = 1;
+    commit_width = 1;
+    int_fus = 1;
+    mul_stages = 4;
+    mem_stages = 3;
+    wb_ports = 2;
+    rob_size = 80;
+    iq_size = 16;
+    lsq_size = 6;
+    uprf_size = 60;
+    ucrf_size = 10;
+    checkpoints = 8;
+    predictor_size = 8;
+    ras_size = 4;
+    memory_size = 4096;
+    dcache_sets = 0;
+    dcache_ways = 2;
+    dcache_line = 4;
+    dcache_miss_penalty = 10;
+}
+
+bool SimConfig::set(const char* key, const char* value) {
+    // Command line spelling "fetch-width" maps to "fetch_width"
+    char name[64];
+    size_t len = strlen(key);
+    if (len == 0 || len >= sizeof(name)) {
+        printf("Config: Invalid key '%s'\n", key);
+        return false;
+    }
+    for (size_t i = 0; i <= len; i++) {
+        name[i] = (key[i] == '-') ? '_' : key[i];
+    }
+
+    char* end;
+    long parsed = strtol(value, &end, 0);
+    while (isspace((unsigned char)*end)) end++;
+    if (end == value || *end != '\0') {
+        printf("Config: Invalid value '%s' for %s\n", value, name);
+        return false;
+    }
+    if (parsed < INT_MIN || parsed > INT_MAX) {
+        printf("Config: Value '%s' for %s is out of range\n", value, name);
+        return false;
+    }
+
+    for (int i = 0; i < num_config_fields; i++) {
+        if (strcmp(name, config_fields[i].name) == 0) {
+            this->*(config_fields[i].field) = (int)parsed;
+            return true;
+        }
+    }
+    printf("Config: Unknown key '%s'\n", name);
+    return false;
+}
+
+// Trims whitespace and optional JSON quotes in place
+static char* trim_token(char* token) {
+    while (isspace((unsigned char)*token)) token++;
+    char* end = token + strlen(token);
+    while (end > token && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    if (end - token >= 2 && token[0] == '"' && end[-1] == '"') {
+        end[-1] = '\0';
+        token++;
+    }
+    return token;
+}
+
+static bool set_pair(SimConfig& config, char* pair, char separator) {
+    char* split = strchr(pair, separator);
+    if (!split) {
+        printf("Config: Expected key%cvalue, got '%s'\n", separator, pair);
+        return false;
+    }
+    *split = '\0';
+    return config.set(trim_token(pair), trim_token(split + 1));
+}
+
+bool SimConfig::set(const char* assignment) {
+    char buffer[128];
+    strncpy(buffer, assignment, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    return set_pair(*this, buffer, '=');
+}
+
+bool SimConfig::load_file(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Error: Unable to open config file %s\n", filename);
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* text = (char*)malloc(length + 1);
+    size_t read = fread(text, 1, length, fp);
+    text[read] = '\0';
+    fclose(fp);
+
+    bool ok = true;
+    char* start = text;
+    while (isspace((unsigned char)*start)) start++;
+
+    if (*start == '{') {
+        // Flat JSON object: { "key": value, ... }
+        char* close = strrchr(start, '}');
+        if (!close) {
+            printf("Config: Unterminated JSON object in %s\n", filename);
+            ok = false;
+        } else {
+            *close = '\0';
+            for (char* pair = strtok(start + 1, ","); pair && ok; pair = strtok(NULL, ",")) {
+                if (*trim_token(pair) == '\0') continue;
+                ok = set_pair(*this, pair, ':');
+            }
+        }
+    } else {
+        // key=value lines, '#' starts a comment
+        for (char* line = strtok(start, "\n"); line && ok; line = strtok(NULL, "\n")) {
+            char* comment = strchr(line, '#');
+            if (comment) *comment = '\0';
+            if (*trim_token(line) == '\0') continue;
+            ok = set_pair(*this, line, '=');
+        }
+    }
+
+    free(text);
+    if (!ok) {
+        printf("Config: Failed to load %s\n", filename);
+    }
+    return ok;
+}
+
+bool SimConfig::validate() const {
+    bool ok = true;
+    for (int i = 0; i < num_config_fields; i++) {
+        int value = this->*(config_fields[i].field);
+        if (value < config_fields[i].min_value) {
+            printf("Config: %s = %d is below the minimum of %d\n",
+                   config_fields[i].name, value, config_fields[i].min_value);
+            ok = false;
+        } else if (value > config_fields[i].max_value) {
+            printf("Config: %s = %d is above the maximum of %d\n",
+                   config_fields[i].name, value, config_fields[i].max_value);
+            ok = false;
+        } else if (config_fields[i].power_of_two && (value & (value - 1)) != 0) {
+            printf("Config: %s = %d is not a power of two\n", config_fields[i].name, value);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void SimConfig::print(FILE* out) const {
+    fprintf(out, "Configuration:\n");
+    for (int i = 0; i < num_config_fields; i++) {
+        fprintf(out, "  %-19s = %d\n", config_fields[i].name, this->*(config_fields[i].field));
+    }
+}
@@ -0,0 +1,578 @@
+// src/sim_server.cpp
+#include "sim_server.h"
+#include "apex_cpu.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+#define CANCEL_CHECK_CYCLES 4096
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char* state_name(JobState state) {
+    switch (state) {
+        case JOB_QUEUED:    return "queued";
+        case JOB_RUNNING:   return "running";
+        case JOB_DONE:      return "done";
+        case JOB_CANCELLED: return "cancelled";
+        default:            return "failed";
+    }
+}
+
+static std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Device, inode, mtime and size: a file edited in place or replaced gets
+// a new stamp; empty when the file cannot be read
+static std::string file_stamp(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return "";
+    }
+    char stamp[128];
+    snprintf(stamp, sizeof(stamp), "%lu:%lu:%ld.%09ld:%ld", (unsigned long)info.st_dev,
+             (unsigned long)info.st_ino, (long)info.st_mtim.tv_sec, (long)info.st_mtim.tv_nsec,
+             (long)info.st_size);
+    return stamp;
+}
+
+// Drops least recently used entries down to limit, returns how many
+template <class Cache>
+static uint64_t evict_lru(Cache& cache, int limit) {
+    uint64_t evicted = 0;
+    while ((int)cache.size() > limit) {
+        auto oldest = cache.begin();
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (it->second.last_use < oldest->second.last_use) oldest = it;
+        }
+        cache.erase(oldest);
+        evicted++;
+    }
+    return evicted;
+}
+
+static std::string error_json(const std::string& message) {
+    return "{\"error\": " + json_string(message) + "}\n";
+}
+
+// Whitespace separated, "double quotes" keep spaces in paths
+static std::vector<std::string> split_request(const std::string& line) {
+    std::vector<std::string> words;
+    std::string word;
+    bool quoted = false, any = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (c == '"') {
+            quoted = !quoted;
+            any = true;
+        } else if (!quoted && (c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+            if (any) words.push_back(word);
+            word.clear();
+            any = false;
+        } else {
+            word += c;
+            any = true;
+        }
+    }
+    if (any) words.push_back(word);
+    return words;
+}
+
+SimServer::SimServer(const SimConfig& base_config, const char* path, int worker_threads)
+    : base(base_config), socket_path(path) {
+    listen_fd = -1;
+    workers = worker_threads > 0 ? worker_threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, workers);
+    next_id = 1;
+    stopping = false;
+    clients = 0;
+    keep_jobs = 1000;
+    program_limit = 16;
+    checkpoint_limit = 16;
+    cache_clock = 0;
+    cache_hits = 0;
+    cache_misses = 0;
+    cache_reloads = 0;
+    cache_evictions = 0;
+}
+
+void SimServer::set_limits(int finished_jobs, int cached_programs, int cached_checkpoints) {
+    keep_jobs = std::max(0, finished_jobs);
+    program_limit = std::max(1, cached_programs);
+    checkpoint_limit = std::max(1, cached_checkpoints);
+}
+
+SimServer::~SimServer() {
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+}
+
+bool SimServer::start() {
+    struct sockaddr_un address;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        fprintf(stderr, "APEX_Error: Socket path too long: %s\n", socket_path.c_str());
+        return false;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path.c_str());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        fprintf(stderr, "APEX_Error: socket: %s\n", strerror(errno));
+        return false;
+    }
+    unlink(socket_path.c_str());  // Left over from a server that did not shut down
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(listen_fd, 64) < 0) {
+        fprintf(stderr, "APEX_Error: Unable to listen on %s: %s\n", socket_path.c_str(),
+                strerror(errno));
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+// Parsed once per version of the file; later jobs share the same vector
+std::shared_ptr<const std::vector<APEX_Instruction> > SimServer::get_program(
+    const std::string& path, std::string& stamp) {
+    stamp = file_stamp(path);
+    if (stamp.empty()) {
+        return NULL;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = programs.find(path);
+        if (found != programs.end() && found->second.stamp == stamp) {
+            cache_hits++;
+            found->second.last_use = ++cache_clock;
+            return found->second.code;
+        }
+    }
+    std::shared_ptr<std::vector<APEX_Instruction> > code(new std::vector<APEX_Instruction>());
+    if (!create_code_memory(path.c_str(), *code)) {
+        return NULL;
+    }
+    // Edited between the stat and the read: this version is not cached
+    if (file_stamp(path) != stamp) {
+        stamp.clear();
+        return code;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    cache_misses++;
+    if (programs.count(path)) {
+        cache_reloads++;
+    }
+    CachedProgram& entry = programs[path];
+    entry.code = code;
+    entry.stamp = stamp;
+    entry.last_use = ++cache_clock;
+    cache_evictions += evict_lru(programs, program_limit);
+    return code;
+}
+
+// Start state of a job: the data image after `skip` functional instructions
+std::shared_ptr<const ArchCheckpoint> SimServer::get_checkpoint(
+    const std::vector<APEX_Instruction>& code, const std::string& program_stamp,
+    const SimJob& job, int memory_words) {
+    std::string data_stamp;
+    if (!job.data.empty()) {
+        data_stamp = file_stamp(job.data);
+        if (data_stamp.empty()) {
+            return NULL;
+        }
+    }
+    char key[64];
+    snprintf(key, sizeof(key), "|%d|%lu", memory_words, (unsigned long)job.skip);
+    std::string name = program_stamp + "|" + data_stamp + key;
+    // An uncached program version gets an uncached checkpoint
+    bool cacheable = !program_stamp.empty();
+    if (cacheable) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = checkpoints.find(name);
+        if (found != checkpoints.end()) {
+            cache_hits++;
+            found->second.last_use = ++cache_clock;
+            return found->second.checkpoint;
+        }
+    }
+    FunctionalCore core(code, memory_words);
+    if (!job.data.empty() && core.load_data(job.data.c_str()) < 0) {
+        return NULL;
+    }
+    if (job.skip > 0) {
+        core.enable_translation();
+        core.run(job.skip);
+    }
+    std::shared_ptr<ArchCheckpoint> checkpoint(new ArchCheckpoint());
+    core.save_checkpoint(*checkpoint);
+    if (!cacheable || (!job.data.empty() && file_stamp(job.data) != data_stamp)) {
+        return checkpoint;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    cache_misses++;
+    CachedCheckpoint& entry = checkpoints[name];
+    entry.checkpoint = checkpoint;
+    entry.last_use = ++cache_clock;
+    // Running jobs keep their own reference to an evicted entry
+    cache_evictions += evict_lru(checkpoints, checkpoint_limit);
+    return checkpoint;
+}
+
+void SimServer::run_job(SimJob& job) {
+    double begin = host_now();
+    SimConfig config = base;
+    for (size_t i = 0; i < job.overrides.size(); i++) {
+        if (!config.set(job.overrides[i].c_str())) {
+            job.error = "bad parameter " + job.overrides[i];
+            return;
+        }
+    }
+    if (!config.validate()) {
+        job.error = "invalid configuration";
+        return;
+    }
+    std::string stamp;
+    std::shared_ptr<const std::vector<APEX_Instruction> > code = get_program(job.program, stamp);
+    if (!code) {
+        job.error = "unable to read program " + job.program;
+        return;
+    }
+    std::shared_ptr<const ArchCheckpoint> start =
+        get_checkpoint(*code, stamp, job, config.memory_size);
+    if (!start) {
+        job.error = "unable to read data " + job.data;
+        return;
+    }
+
+    APEX_CPU cpu(config);
+    cpu.load_checkpoint(*code, *start);
+    while (!cpu.is_halted() && (job.max_insns == 0 || cpu.get_committed() < job.max_insns) &&
+           (job.max_cycles == 0 || cpu.get_cycles() < job.max_cycles)) {
+        cpu.single_step();
+        if (cpu.get_cycles() % CANCEL_CHECK_CYCLES == 0 && job.cancel) {
+            break;
+        }
+    }
+
+    std::string stats;
+    char* text = NULL;
+    size_t length = 0;
+    FILE* out = open_memstream(&text, &length);
+    if (out) {
+        cpu.get_stats().dump_json(out);
+        fclose(out);
+        stats.assign(text, length);
+        free(text);
+    }
+    // status and list read these under the lock while the job runs
+    std::lock_guard<std::mutex> guard(lock);
+    job.cycles = cpu.get_cycles();
+    job.committed = cpu.get_committed();
+    job.halted = cpu.is_halted();
+    job.stats_json.swap(stats);
+    job.host_seconds = host_now() - begin;
+}
+
+// Highest priority first, then submission order
+std::shared_ptr<SimJob> SimServer::next_job() {
+    std::unique_lock<std::mutex> guard(lock);
+    work_ready.wait(guard, [this]() { return stopping || !queue.empty(); });
+    if (stopping) {
+        return NULL;
+    }
+    size_t best = 0;
+    for (size_t i = 1; i < queue.size(); i++) {
+        if (queue[i]->priority > queue[best]->priority) best = i;
+    }
+    std::shared_ptr<SimJob> job = queue[best];
+    queue.erase(queue.begin() + best);
+    job->state = JOB_RUNNING;
+    return job;
+}
+
+// Finished jobs nobody fetched are dropped oldest first beyond keep_jobs
+void SimServer::finish_job(SimJob& job) {
+    job.state = job.cancel ? JOB_CANCELLED : !job.error.empty() ? JOB_FAILED : JOB_DONE;
+    finished.push_back(job.id);
+    while ((int)finished.size() > keep_jobs) {
+        jobs.erase(finished.front());
+        finished.pop_front();
+    }
+    job_finished.notify_all();
+}
+
+void SimServer::worker_loop() {
+    while (std::shared_ptr<SimJob> job = next_job()) {
+        run_job(*job);
+        std::lock_guard<std::mutex> guard(lock);
+        finish_job(*job);
+    }
+}
+
+// Caller holds lock
+std::string SimServer::job_json(const SimJob& job, bool with_stats) const {
+    std::string out = "{\"job\": " + std::to_string(job.id) + ", \"state\": \"" +
+                      state_name(job.state) + "\", \"priority\": " +
+                      std::to_string(job.priority) + ", \"program\": " +
+                      json_string(job.program);
+    if (job.state == JOB_FAILED) {
+        out += ", \"error\": " + json_string(job.error);
+    }
+    if (job.state == JOB_DONE || job.state == JOB_CANCELLED) {
+        char numbers[256];
+        snprintf(numbers, sizeof(numbers),
+                 ", \"cycles\": %lu, \"committed\": %lu, \"halted\": %s, \"host_seconds\": %.6f",
+                 (unsigned long)job.cycles, (unsigned long)job.committed,
+                 job.halted ? "true" : "false", job.host_seconds);
+        out += numbers;
+    }
+    if (with_stats && job.state == JOB_DONE) {
+        out += ", \"stats\": " + job.stats_json;
+        while (!out.empty() && out[out.size() - 1] == '\n') {
+            out.erase(out.size() - 1);
+        }
+    }
+    return out + "}";
+}
+
+std::string SimServer::handle(const std::string& request) {
+    std::vector<std::string> words = split_request(request);
+    if (words.empty()) {
+        return error_json("empty request");
+    }
+    const std::string& command = words[0];
+
+    if (command == "submit") {
+        std::shared_ptr<SimJob> job(new SimJob());
+        job->priority = 0;
+        job->max_cycles = 0;
+        job->max_insns = 0;
+        job->skip = 0;
+        job->state = JOB_QUEUED;
+        job->cancel = false;
+        job->cycles = 0;
+        job->committed = 0;
+        job->halted = false;
+        job->host_seconds = 0.0;
+        for (size_t i = 1; i < words.size(); i++) {
+            const char* arg = words[i].c_str();
+            unsigned long value;
+            if (sscanf(arg, "--cycles=%lu", &value) == 1) {
+                job->max_cycles = value;
+            } else if (sscanf(arg, "--insns=%lu", &value) == 1) {
+                job->max_insns = value;
+            } else if (sscanf(arg, "--skip=%lu", &value) == 1) {
+                job->skip = value;
+            } else if (sscanf(arg, "--priority=%d", &job->priority) == 1) {
+                continue;
+            } else if (strncmp(arg, "--", 2) == 0 && strchr(arg, '=')) {
+                job->overrides.push_back(arg + 2);
+            } else if (arg[0] == '-') {
+                return error_json("unknown option " + words[i]);
+            } else if (job->program.empty()) {
+                job->program = arg;
+            } else if (job->data.empty()) {
+                job->data = arg;
+            } else {
+                return error_json("unexpected argument " + words[i]);
+            }
+        }
+        if (job->program.empty()) {
+            return error_json("submit needs a program");
+        }
+        // Refused here rather than queued to fail
+        SimConfig config = base;
+        for (size_t i = 0; i < job->overrides.size(); i++) {
+            if (!config.set(job->overrides[i].c_str())) {
+                return error_json("bad parameter " + job->overrides[i]);
+            }
+        }
+        if (!config.validate()) {
+            return error_json("invalid configuration");
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (stopping) {
+            return error_json("server is shutting down");
+        }
+        job->id = next_id++;
+        jobs[job->id] = job;
+        queue.push_back(job);
+        work_ready.notify_one();
+        return job_json(*job, false) + "\n";
+    }
+
+    if (command == "list" || command == "cache") {
+        std::lock_guard<std::mutex> guard(lock);
+        if (command == "cache") {
+            return "{\"programs\": " + std::to_string(programs.size()) +
+                   ", \"program_limit\": " + std::to_string(program_limit) +
+                   ", \"checkpoints\": " + std::to_string(checkpoints.size()) +
+                   ", \"checkpoint_limit\": " + std::to_string(checkpoint_limit) +
+                   ", \"hits\": " + std::to_string(cache_hits) +
+                   ", \"misses\": " + std::to_string(cache_misses) +
+                   ", \"reloads\": " + std::to_string(cache_reloads) +
+                   ", \"evictions\": " + std::to_string(cache_evictions) + "}\n";
+        }
+        std::string out = "[";
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            out += (it == jobs.begin() ? "\n  " : ",\n  ") + job_json(*it->second, false);
+        }
+        return out + "\n]\n";
+    }
+
+    if (command == "shutdown") {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            it->second->cancel = true;
+        }
+        work_ready.notify_all();
+        ::shutdown(listen_fd, SHUT_RDWR);  // Wakes accept()
+        return "{\"shutdown\": true}\n";
+    }
+
+    if (command != "status" && command != "result" && command != "cancel") {
+        return error_json("unknown command " + command);
+    }
+    if (words.size() != 2) {
+        return error_json(command + " needs a job id");
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    auto found = jobs.find(strtoull(words[1].c_str(), NULL, 10));
+    if (found == jobs.end()) {
+        return error_json("no job " + words[1]);
+    }
+    std::shared_ptr<SimJob> job = found->second;
+    if (command == "cancel") {
+        job->cancel = true;
+        auto queued = std::find(queue.begin(), queue.end(), job);
+        if (queued != queue.end()) {
+            queue.erase(queued);
+            finish_job(*job);
+        }
+    } else if (command == "result") {
+        job_finished.wait(guard, [&job]() {
+            return job->state != JOB_QUEUED && job->state != JOB_RUNNING;
+        });
+        jobs.erase(job->id);  // Delivered, a later status or result finds nothing
+    }
+    return job_json(*job, command == "result") + "\n";
+}
+
+// One request line in, one reply out
+void SimServer::serve(int fd) {
+    std::string request;
+    char buffer[1024];
+    ssize_t n;
+    while (request.find('\n') == std::string::npos && (n = read(fd, buffer, sizeof(buffer))) > 0) {
+        request.append(buffer, n);
+    }
+    std::string reply = handle(request.substr(0, request.find('\n')));
+    for (size_t sent = 0; sent < reply.size();) {
+        n = write(fd, reply.data() + sent, reply.size() - sent);
+        if (n <= 0) break;
+        sent += n;
+    }
+    close(fd);
+
+    std::lock_guard<std::mutex> guard(lock);
+    clients--;
+    job_finished.notify_all();
+}
+
+void SimServer::run() {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < workers; t++) {
+        pool.push_back(std::thread(&SimServer::worker_loop, this));
+    }
+    printf("Server: listening on %s with %d workers\n", socket_path.c_str(), workers);
+    fflush(stdout);
+
+    // Connections get their own thread, a result request may wait for long
+    while (true) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        clients++;
+        std::thread(&SimServer::serve, this, fd).detach();
+        if (stopping) break;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        work_ready.notify_all();
+    }
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+    {
+        // Jobs that never started are reported as cancelled to waiting clients
+        std::unique_lock<std::mutex> guard(lock);
+        for (size_t i = 0; i < queue.size(); i++) {
+            queue[i]->state = JOB_CANCELLED;
+        }
+        queue.clear();
+        job_finished.notify_all();
+        job_finished.wait(guard, [this]() { return clients == 0; });
+    }
+    printf("Server: stopped after %lu jobs\n", (unsigned long)(next_id - 1));
+}
+
+bool send_server_request(const char* path, const std::string& request, std::string& reply) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        fprintf(stderr, "APEX_Error: Unable to connect to %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    std::string line = request + "\n";
+    for (size_t sent = 0; sent < line.size();) {
+        ssize_t n = write(fd, line.data() + sent, line.size() - sent);
+        if (n <= 0) break;
+        sent += n;
+    }
+    reply.clear();
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        reply.append(buffer, n);
+    }
+    close(fd);
+    return true;
+}
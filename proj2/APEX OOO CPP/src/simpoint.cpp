@@ -0,0 +1,405 @@
+// src/simpoint.cpp
+#include "simpoint.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+static const int KMEANS_RUNS = 5;
+static const int KMEANS_ITERATIONS = 100;
+
+// Deterministic on every host, unlike the <random> distributions
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static double unit_random(uint64_t& state) {
+    state = splitmix64(state);
+    return (double)(state >> 11) / (double)(1ULL << 53);
+}
+
+static double distance2(const std::vector<double>& a, const std::vector<double>& b) {
+    double d = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        d += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return d;
+}
+
+SimPoint::SimPoint(int projected_dims, uint64_t random_seed) {
+    dims = projected_dims > 0 ? projected_dims : 1;
+    seed = random_seed;
+}
+
+bool SimPoint::load_bbv(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("Error: Unable to open BBV file %s\n", path);
+        return false;
+    }
+    vectors.clear();
+    lengths.clear();
+
+    // T:id:count :id:count ...
+    std::string line;
+    int c;
+    do {
+        c = fgetc(fp);
+        if (c != '\n' && c != EOF) {
+            line += (char)c;
+            continue;
+        }
+        if (!line.empty() && line[0] == 'T') {
+            std::vector<std::pair<int, double> > bbv;
+            uint64_t total = 0;
+            const char* p = line.c_str() + 1;
+            int id;
+            unsigned long count;
+            int used;
+            while (sscanf(p, " :%d:%lu%n", &id, &count, &used) == 2) {
+                bbv.push_back(std::make_pair(id, (double)count));
+                total += count;
+                p += used;
+            }
+            for (size_t i = 0; i < bbv.size(); i++) {
+                bbv[i].second /= total ? (double)total : 1.0;
+            }
+            vectors.push_back(bbv);
+            lengths.push_back(total);
+        }
+        line.clear();
+    } while (c != EOF);
+    fclose(fp);
+
+    if (vectors.empty()) {
+        printf("Error: No intervals in %s\n", path);
+        return false;
+    }
+    project();
+    return true;
+}
+
+// Every block gets a fixed random direction in [-1, 1]^dims
+void SimPoint::project() {
+    points.assign(vectors.size(), std::vector<double>(dims, 0.0));
+    for (size_t i = 0; i < vectors.size(); i++) {
+        for (size_t j = 0; j < vectors[i].size(); j++) {
+            uint64_t state = seed ^ ((uint64_t)vectors[i][j].first * 0x100000001B3ULL);
+            for (int d = 0; d < dims; d++) {
+                points[i][d] += vectors[i][j].second * (2.0 * unit_random(state) - 1.0);
+            }
+        }
+    }
+}
+
+// k-means++ seeding then Lloyd iterations, returns the squared error
+double SimPoint::kmeans(int k, uint64_t run_seed, std::vector<int>& assign,
+                        std::vector<std::vector<double> >& centroids) const {
+    int n = (int)points.size();
+    uint64_t state = run_seed;
+    centroids.assign(1, points[(int)(unit_random(state) * n) % n]);
+
+    std::vector<double> nearest(n);
+    while ((int)centroids.size() < k) {
+        double total = 0.0;
+        for (int i = 0; i < n; i++) {
+            nearest[i] = distance2(points[i], centroids[0]);
+            for (size_t c = 1; c < centroids.size(); c++) {
+                double d = distance2(points[i], centroids[c]);
+                if (d < nearest[i]) nearest[i] = d;
+            }
+            total += nearest[i];
+        }
+        double pick = unit_random(state) * total;
+        int chosen = n - 1;
+        for (int i = 0; i < n; i++) {
+            pick -= nearest[i];
+            if (pick < 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+        centroids.push_back(points[chosen]);
+    }
+
+    assign.assign(n, -1);
+    double sse = 0.0;
+    for (int iter = 0; iter < KMEANS_ITERATIONS; iter++) {
+        bool changed = false;
+        sse = 0.0;
+        for (int i = 0; i < n; i++) {
+            int best = 0;
+            double best_d = distance2(points[i], centroids[0]);
+            for (int c = 1; c < k; c++) {
+                double d = distance2(points[i], centroids[c]);
+                if (d < best_d) {
+                    best_d = d;
+                    best = c;
+                }
+            }
+            sse += best_d;
+            if (assign[i] != best) {
+                assign[i] = best;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+
+        std::vector<int> sizes(k, 0);
+        for (int c = 0; c < k; c++) {
+            centroids[c].assign(dims, 0.0);
+        }
+        for (int i = 0; i < n; i++) {
+            sizes[assign[i]]++;
+            for (int d = 0; d < dims; d++) {
+                centroids[assign[i]][d] += points[i][d];
+            }
+        }
+        for (int c = 0; c < k; c++) {
+            for (int d = 0; d < dims && sizes[c] > 0; d++) {
+                centroids[c][d] /= sizes[c];
+            }
+        }
+    }
+    return sse;
+}
+
+// Bayesian information criterion of a spherical Gaussian mixture (Pelleg
+// and Moore's X-means), higher is better
+double SimPoint::bic(int k, const std::vector<int>& assign, double sse) const {
+    double n = (double)points.size();
+    if (n <= k) {
+        return 0.0;
+    }
+    double variance = sse / (n - k);
+    if (variance < 1e-12) variance = 1e-12;
+
+    std::vector<int> sizes(k, 0);
+    for (size_t i = 0; i < assign.size(); i++) {
+        sizes[assign[i]]++;
+    }
+    double likelihood = 0.0;
+    for (int c = 0; c < k; c++) {
+        double rn = sizes[c];
+        if (rn == 0) continue;
+        likelihood += rn * log(rn) - rn * log(n) - rn / 2.0 * log(2.0 * M_PI)
+                      - rn * dims / 2.0 * log(variance) - (rn - k) / 2.0;
+    }
+    double parameters = (k - 1) + (double)dims * k + 1;
+    return likelihood - parameters / 2.0 * log(n);
+}
+
+int SimPoint::cluster(int max_k, int fixed_k, bool verbose) {
+    int n = (int)points.size();
+    int low = fixed_k > 0 ? fixed_k : 1;
+    int high = fixed_k > 0 ? fixed_k : max_k;
+    if (high > n) high = n;
+    if (low > high) low = high;
+
+    std::vector<std::vector<int> > assigns;
+    std::vector<std::vector<std::vector<double> > > centers;
+    std::vector<double> scores;
+    for (int k = low; k <= high; k++) {
+        std::vector<int> best_assign, assign;
+        std::vector<std::vector<double> > best_centers, centroids;
+        double best_sse = 0.0;
+        for (int run = 0; run < KMEANS_RUNS; run++) {
+            double sse = kmeans(k, splitmix64(seed + 7919 * k + run), assign, centroids);
+            if (run == 0 || sse < best_sse) {
+                best_sse = sse;
+                best_assign = assign;
+                best_centers = centroids;
+            }
+        }
+        assigns.push_back(best_assign);
+        centers.push_back(best_centers);
+        scores.push_back(bic(k, best_assign, best_sse));
+        if (verbose) {
+            printf("  k=%-3d sse=%-12.6g bic=%.6g\n", k, best_sse, scores.back());
+        }
+    }
+
+    double lo = scores[0], hi = scores[0];
+    for (size_t i = 1; i < scores.size(); i++) {
+        if (scores[i] < lo) lo = scores[i];
+        if (scores[i] > hi) hi = scores[i];
+    }
+    size_t pick = scores.size() - 1;
+    for (size_t i = 0; i < scores.size(); i++) {
+        if (scores[i] >= lo + 0.9 * (hi - lo)) {
+            pick = i;
+            break;
+        }
+    }
+    int k = low + (int)pick;
+    assignment = assigns[pick];
+
+    // Nearest interval to each centroid, weighted by instructions
+    uint64_t total = 0;
+    for (int i = 0; i < n; i++) {
+        total += lengths[i];
+    }
+    choices.clear();
+    for (int c = 0; c < k; c++) {
+        int best = -1;
+        double best_d = 0.0;
+        uint64_t insns = 0;
+        for (int i = 0; i < n; i++) {
+            if (assignment[i] != c) continue;
+            insns += lengths[i];
+            double d = distance2(points[i], centers[pick][c]);
+            if (best < 0 || d < best_d) {
+                best = i;
+                best_d = d;
+            }
+        }
+        if (best < 0) continue;  // Empty cluster
+        SimPointChoice choice;
+        choice.interval = (uint64_t)best;
+        choice.cluster = (int)choices.size();
+        choice.weight = total ? (double)insns / total : 0.0;
+        choices.push_back(choice);
+    }
+    return (int)choices.size();
+}
+
+bool SimPoint::write(const char* simpoints_path, const char* weights_path) const {
+    FILE* sp = fopen(simpoints_path, "w");
+    FILE* wp = sp ? fopen(weights_path, "w") : NULL;
+    if (!sp || !wp) {
+        printf("Error: Unable to write %s\n", sp ? weights_path : simpoints_path);
+        if (sp) fclose(sp);
+        return false;
+    }
+    for (size_t i = 0; i < choices.size(); i++) {
+        fprintf(sp, "%lu %d\n", (unsigned long)choices[i].interval, choices[i].cluster);
+        fprintf(wp, "%.6f %d\n", choices[i].weight, choices[i].cluster);
+    }
+    fclose(sp);
+    fclose(wp);
+    return true;
+}
+
+bool read_simpoints(const char* simpoints_path, const char* weights_path,
+                    std::vector<SimPointChoice>& choices) {
+    FILE* sp = fopen(simpoints_path, "r");
+    FILE* wp = sp && weights_path ? fopen(weights_path, "r") : NULL;
+    if (!sp || (weights_path && !wp)) {
+        printf("Error: Unable to open %s\n", sp ? weights_path : simpoints_path);
+        if (sp) fclose(sp);
+        return false;
+    }
+    choices.clear();
+    unsigned long interval;
+    int cluster;
+    while (fscanf(sp, "%lu %d", &interval, &cluster) == 2) {
+        SimPointChoice choice;
+        choice.interval = interval;
+        choice.cluster = cluster;
+        choice.weight = 0.0;
+        choices.push_back(choice);
+    }
+    fclose(sp);
+    if (!wp) {
+        // Plain start points, each stands for the same share
+        for (size_t i = 0; i < choices.size(); i++) {
+            choices[i].weight = 1.0 / choices.size();
+        }
+        return !choices.empty();
+    }
+    double weight;
+    while (fscanf(wp, "%lf %d", &weight, &cluster) == 2) {
+        for (size_t i = 0; i < choices.size(); i++) {
+            if (choices[i].cluster == cluster) choices[i].weight = weight;
+        }
+    }
+    fclose(wp);
+    return !choices.empty();
+}
+
+static void split_csv(const char* line, std::vector<std::string>& fields) {
+    fields.clear();
+    std::string field;
+    for (const char* p = line; *p && *p != '\n' && *p != '\r'; p++) {
+        if (*p == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else {
+            field += *p;
+        }
+    }
+    fields.push_back(field);
+}
+
+// CPI combines linearly across phases, IPC is its inverse
+bool combine_interval_stats(const char* csv_path, const std::vector<SimPointChoice>& choices,
+                            FILE* out) {
+    FILE* fp = fopen(csv_path, "r");
+    if (!fp) {
+        printf("Error: Unable to open %s\n", csv_path);
+        return false;
+    }
+    char line[1 << 16];
+    std::vector<std::string> header, fields;
+    if (!fgets(line, sizeof(line), fp)) {
+        fclose(fp);
+        return false;
+    }
+    split_csv(line, header);
+    int interval_col = -1, cycles_col = -1, committed_col = -1;
+    for (size_t i = 0; i < header.size(); i++) {
+        if (header[i] == "interval") interval_col = (int)i;
+        if (header[i] == "cpu.cycles") cycles_col = (int)i;
+        if (header[i] == "cpu.committed") committed_col = (int)i;
+    }
+    if (interval_col < 0 || cycles_col < 0 || committed_col < 0) {
+        printf("Error: %s needs interval, cpu.cycles and cpu.committed columns\n", csv_path);
+        fclose(fp);
+        return false;
+    }
+
+    // Counter columns come after the rates, from cpu.cycles on
+    std::vector<double> per_kilo(header.size(), 0.0);
+    double cpi = 0.0, covered = 0.0;
+    int found = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        split_csv(line, fields);
+        if (fields.size() != header.size()) continue;
+        uint64_t interval = strtoull(fields[interval_col].c_str(), NULL, 10);
+        double committed = atof(fields[committed_col].c_str());
+        for (size_t c = 0; c < choices.size(); c++) {
+            if (choices[c].interval != interval || committed <= 0.0) continue;
+            double w = choices[c].weight;
+            cpi += w * atof(fields[cycles_col].c_str()) / committed;
+            for (size_t i = cycles_col; i < fields.size(); i++) {
+                per_kilo[i] += w * 1000.0 * atof(fields[i].c_str()) / committed;
+            }
+            covered += w;
+            found++;
+        }
+    }
+    fclose(fp);
+
+    if (found < (int)choices.size()) {
+        printf("Warning: %d of %d simulation points found in %s\n", found,
+               (int)choices.size(), csv_path);
+    }
+    if (covered <= 0.0) {
+        return false;
+    }
+    // Renormalise when some points are missing
+    cpi /= covered;
+    fprintf(out, "SimPoint estimate from %d points (%.1f%% of instructions):\n", found,
+            100.0 * covered);
+    fprintf(out, "  %-40s %12.4f\n", "cpi", cpi);
+    fprintf(out, "  %-40s %12.4f\n", "ipc", cpi > 0.0 ? 1.0 / cpi : 0.0);
+    for (size_t i = cycles_col; i < header.size(); i++) {
+        if (i == (size_t)committed_col) continue;
+        fprintf(out, "  %-40s %12.4f\n", (header[i] + " per 1k insns").c_str(),
+                per_kilo[i] / covered);
+    }
+    return true;
+}
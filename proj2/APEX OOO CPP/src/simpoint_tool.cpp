@@ -0,0 +1,76 @@
+// src/simpoint_tool.cpp
+// Picks representative intervals from apex_sim --bbv output and combines
+// the detailed stats of those intervals into a whole-program estimate.
+#include "simpoint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s --bbv=FILE --simpoints=FILE --weights=FILE [options]\n", prog);
+    fprintf(stderr, "       %s --combine=STATS.csv --simpoints=FILE --weights=FILE\n", prog);
+    fprintf(stderr, "  --bbv=FILE        Basic-block vectors written by apex_sim --bbv\n");
+    fprintf(stderr, "  --simpoints=FILE  Chosen intervals, \"<interval> <cluster>\" per line\n");
+    fprintf(stderr, "  --weights=FILE    Cluster weights, \"<weight> <cluster>\" per line\n");
+    fprintf(stderr, "  --max-k=N         Largest number of clusters tried (default 10)\n");
+    fprintf(stderr, "  --k=N             Use exactly N clusters instead of the BIC choice\n");
+    fprintf(stderr, "  --dims=N          Random projection dimensions (default 15)\n");
+    fprintf(stderr, "  --seed=N          Projection and k-means seed (default 1)\n");
+    fprintf(stderr, "  --combine=FILE    Weight per-interval stats from apex_sim --intervals\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* bbv_file = NULL;
+    const char* simpoints_file = NULL;
+    const char* weights_file = NULL;
+    const char* combine_file = NULL;
+    int max_k = 10, fixed_k = 0, dims = 15;
+    unsigned long seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--max-k=%d", &max_k) == 1) continue;
+        if (sscanf(arg, "--k=%d", &fixed_k) == 1) continue;
+        if (sscanf(arg, "--dims=%d", &dims) == 1) continue;
+        if (sscanf(arg, "--seed=%lu", &seed) == 1) continue;
+        if (strncmp(arg, "--bbv=", 6) == 0) {
+            bbv_file = arg + 6;
+        } else if (strncmp(arg, "--simpoints=", 12) == 0) {
+            simpoints_file = arg + 12;
+        } else if (strncmp(arg, "--weights=", 10) == 0) {
+            weights_file = arg + 10;
+        } else if (strncmp(arg, "--combine=", 10) == 0) {
+            combine_file = arg + 10;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!simpoints_file || !weights_file || (!bbv_file == !combine_file)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (combine_file) {
+        std::vector<SimPointChoice> choices;
+        if (!read_simpoints(simpoints_file, weights_file, choices)) {
+            return 1;
+        }
+        return combine_interval_stats(combine_file, choices, stdout) ? 0 : 1;
+    }
+
+    SimPoint simpoint(dims, seed);
+    if (!simpoint.load_bbv(bbv_file)) {
+        return 1;
+    }
+    printf("SimPoint: %d intervals from %s\n", simpoint.get_intervals(), bbv_file);
+    int k = simpoint.cluster(max_k, fixed_k, true);
+
+    const std::vector<SimPointChoice>& choices = simpoint.get_choices();
+    printf("SimPoint: %d clusters\n", k);
+    for (size_t i = 0; i < choices.size(); i++) {
+        printf("  cluster %-3d interval %-8lu weight %.4f\n", choices[i].cluster,
+               (unsigned long)choices[i].interval, choices[i].weight);
+    }
+    return simpoint.write(simpoints_file, weights_file) ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+// src/stage_timer.cpp
+#include "stage_timer.h"
+#include "stats_registry.h"
+#include <stdio.h>
+
+static const char* stage_names[TIMED_STAGE_COUNT] = {
+    "commit", "writeback", "execute", "issue", "dispatch", "decode", "fetch", "stats"
+};
+
+StageTimers::StageTimers() {
+    enabled = false;
+    for (int i = 0; i < TIMED_STAGE_COUNT; i++) {
+        total_ns[i] = 0;
+    }
+}
+
+const char* StageTimers::get_name(TimedStage stage) {
+    return stage_names[stage];
+}
+
+void StageTimers::register_stats(StatsRegistry& stats, const std::string& prefix) const {
+    stats.add_vector(prefix + ".ns", "Host nanoseconds per stage (--stage-timers)", total_ns,
+                     TIMED_STAGE_COUNT, stage_names);
+}
+
+// Host cost of each stage per simulated cycle and per committed instruction
+void StageTimers::print(uint64_t cycles, uint64_t instructions) const {
+    if (!enabled) {
+        return;
+    }
+    if (!APEX_STAGE_TIMERS) {
+        printf("Host stage timers: compiled out (APEX_STAGE_TIMERS=0)\n");
+        return;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < TIMED_STAGE_COUNT; i++) {
+        total += total_ns[i];
+    }
+    double per_cycle = cycles ? 1.0 / cycles : 0.0;
+    double per_insn = instructions ? 1.0 / instructions : 0.0;
+
+    printf("Host stage timers (%lu cycles, %lu instructions):\n",
+           (unsigned long)cycles, (unsigned long)instructions);
+    printf("  %-10s %12s %10s %10s %7s\n", "stage", "total_us", "ns/cycle", "ns/insn", "share");
+    for (int i = 0; i < TIMED_STAGE_COUNT; i++) {
+        printf("  %-10s %12.1f %10.1f %10.1f %6.1f%%\n", get_name((TimedStage)i),
+               total_ns[i] / 1000.0, total_ns[i] * per_cycle, total_ns[i] * per_insn,
+               total ? 100.0 * total_ns[i] / total : 0.0);
+    }
+    printf("  %-10s %12.1f %10.1f %10.1f\n", "total", total / 1000.0, total * per_cycle,
+           total * per_insn);
+}
@@ -0,0 +1,155 @@
+// src/stats_registry.cpp
+#include "stats_registry.h"
+#include "occupancy_histogram.h"
+#include <string.h>
+
+StatsRegistry::Entry& StatsRegistry::add(const std::string& name, const char* desc, StatKind kind) {
+    Entry entry;
+    entry.name = name;
+    entry.desc = desc;
+    entry.kind = kind;
+    entry.counter = NULL;
+    entry.length = 0;
+    entry.labels = NULL;
+    entry.histogram = NULL;
+    entries.push_back(entry);
+    return entries.back();
+}
+
+void StatsRegistry::add_counter(const std::string& name, const char* desc, const uint64_t* counter) {
+    add(name, desc, STAT_COUNTER).counter = counter;
+}
+
+void StatsRegistry::add_counter(const std::string& name, const char* desc,
+                                std::function<uint64_t()> fn) {
+    add(name, desc, STAT_COUNTER_FN).fn = [fn]() { return (double)fn(); };
+}
+
+void StatsRegistry::add_vector(const std::string& name, const char* desc, const uint64_t* values,
+                               int length, const char* const* labels) {
+    Entry& entry = add(name, desc, STAT_VECTOR);
+    entry.counter = values;
+    entry.length = length;
+    entry.labels = labels;
+}
+
+void StatsRegistry::add_histogram(const std::string& name, const char* desc,
+                                  const OccupancyHistogram* histogram) {
+    add(name, desc, STAT_HISTOGRAM).histogram = histogram;
+}
+
+void StatsRegistry::add_formula(const std::string& name, const char* desc,
+                                std::function<double()> fn) {
+    add(name, desc, STAT_FORMULA).fn = fn;
+}
+
+void StatsRegistry::collect(std::vector<StatValue>& values) const {
+    values.clear();
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        StatValue v;
+        v.name = entry.name;
+        v.is_counter = true;
+        v.desc = entry.desc.c_str();
+
+        switch (entry.kind) {
+            case STAT_COUNTER:
+                v.value = (double)*entry.counter;
+                values.push_back(v);
+                break;
+
+            case STAT_COUNTER_FN:
+                v.value = entry.fn();
+                values.push_back(v);
+                break;
+
+            case STAT_VECTOR:
+                for (int j = 0; j < entry.length; j++) {
+                    v.name = entry.name + "." + entry.labels[j];
+                    v.value = (double)entry.counter[j];
+                    values.push_back(v);
+                }
+                break;
+
+            case STAT_HISTOGRAM: {
+                const OccupancyHistogram* h = entry.histogram;
+                const char* names[] = { "mean", "p50", "p90", "p99", "full_fraction" };
+                const double stats[] = { h->get_mean(), (double)h->get_percentile(50),
+                                         (double)h->get_percentile(90),
+                                         (double)h->get_percentile(99), h->get_full_fraction() };
+                // Raw sums are counters so interval deltas give a mean per interval
+                v.name = entry.name + ".samples";
+                v.value = (double)h->get_samples();
+                values.push_back(v);
+                v.name = entry.name + ".sum";
+                v.value = (double)h->get_sum();
+                values.push_back(v);
+
+                v.is_counter = false;
+                for (int j = 0; j < 5; j++) {
+                    v.name = entry.name + "." + names[j];
+                    v.value = stats[j];
+                    values.push_back(v);
+                }
+                break;
+            }
+
+            case STAT_FORMULA:
+                v.value = entry.fn();
+                v.is_counter = false;
+                values.push_back(v);
+                break;
+        }
+    }
+}
+
+// Counters print as integers, everything else with full precision
+static void print_value(FILE* out, const StatValue& v) {
+    if (v.is_counter) {
+        fprintf(out, "%.0f", v.value);
+    } else {
+        fprintf(out, "%.6g", v.value);
+    }
+}
+
+void StatsRegistry::dump_json(FILE* out) const {
+    std::vector<StatValue> values;
+    collect(values);
+
+    fprintf(out, "{\n");
+    for (size_t i = 0; i < values.size(); i++) {
+        fprintf(out, "  \"%s\": ", values[i].name.c_str());
+        print_value(out, values[i]);
+        fprintf(out, "%s\n", i + 1 < values.size() ? "," : "");
+    }
+    fprintf(out, "}\n");
+}
+
+void StatsRegistry::dump_csv(FILE* out) const {
+    std::vector<StatValue> values;
+    collect(values);
+
+    fprintf(out, "name,value,description\n");
+    for (size_t i = 0; i < values.size(); i++) {
+        fprintf(out, "%s,", values[i].name.c_str());
+        print_value(out, values[i]);
+        fprintf(out, ",\"%s\"\n", values[i].desc);
+    }
+}
+
+bool StatsRegistry::dump_file(const char* filename) const {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Error: Unable to open stats file %s\n", filename);
+        return false;
+    }
+
+    size_t len = strlen(filename);
+    if (len >= 4 && strcmp(filename + len - 4, ".csv") == 0) {
+        dump_csv(fp);
+    } else {
+        dump_json(fp);
+    }
+    fclose(fp);
+    return true;
+}
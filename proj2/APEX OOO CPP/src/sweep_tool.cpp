@@ -0,0 +1,125 @@
+// src/sweep_tool.cpp
+// Runs one program over a grid or Latin-hypercube sample of core
+// configurations in parallel and writes a single result table.
+#include "design_sweep.h"
+#include "apex_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* default_stats[] = {
+    "cpu.mpki", "predictor.btb_miss_rate", "rob.occupancy.mean", "lsq.occupancy.full_fraction",
+    "lsq.load.latency.mean", "memfu.mlp", "dcache.miss_rate"
+};
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "APEX_Help: Usage %s <input_file> [data_file] --param=KEY=VALUES... [options]\n",
+            prog);
+    fprintf(stderr, "  --param=KEY=a,b,c    Values of one config key (e.g. rob_size=32,64,128)\n");
+    fprintf(stderr, "  --param=KEY=lo:hi[:step]  Linear range, or lo:hi:*f for a geometric one\n");
+    fprintf(stderr, "  --lhs=N              Latin-hypercube sample of N points instead of the grid\n");
+    fprintf(stderr, "  --seed=N             Sampling seed (default 1)\n");
+    fprintf(stderr, "  --config=FILE        Base configuration, swept keys override it\n");
+    fprintf(stderr, "  --set key=value      Override one base parameter\n");
+    fprintf(stderr, "  --stat=NAME          Report this statistic (repeatable, replaces the defaults)\n");
+    fprintf(stderr, "  --insns=N            Stop each point after N committed instructions\n");
+    fprintf(stderr, "  --cycles=N           ... or after N cycles (default run to HALT)\n");
+    fprintf(stderr, "  --stall-limit=N      Give up a point after N cycles without a commit\n");
+    fprintf(stderr, "                       (default 100000, 0 = never)\n");
+    fprintf(stderr, "  --jobs=N             Host threads (default all)\n");
+    fprintf(stderr, "  --out=FILE           Result table, CSV for .csv else JSON (default CSV on stdout)\n");
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig base;
+    const char* input_file = NULL;
+    const char* data_file = NULL;
+    const char* out_file = NULL;
+    std::vector<const char*> param_specs;
+    std::vector<const char*> stats;
+    std::vector<const char*> overrides;
+    const char* config_file = NULL;
+    int lhs = 0, jobs = 0;
+    unsigned long seed = 1, max_insns = 0, max_cycles = 0, stall_limit = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (sscanf(arg, "--lhs=%d", &lhs) == 1) continue;
+        if (sscanf(arg, "--seed=%lu", &seed) == 1) continue;
+        if (sscanf(arg, "--jobs=%d", &jobs) == 1) continue;
+        if (sscanf(arg, "--insns=%lu", &max_insns) == 1) continue;
+        if (sscanf(arg, "--cycles=%lu", &max_cycles) == 1) continue;
+        if (sscanf(arg, "--stall-limit=%lu", &stall_limit) == 1) continue;
+        if (strncmp(arg, "--param=", 8) == 0) {
+            param_specs.push_back(arg + 8);
+        } else if (strncmp(arg, "--stat=", 7) == 0) {
+            stats.push_back(arg + 7);
+        } else if (strncmp(arg, "--out=", 6) == 0) {
+            out_file = arg + 6;
+        } else if (strncmp(arg, "--config=", 9) == 0) {
+            config_file = arg + 9;
+        } else if (strcmp(arg, "--set") == 0 && i + 1 < argc) {
+            overrides.push_back(argv[++i]);
+        } else if (arg[0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else if (!input_file) {
+            input_file = arg;
+        } else if (!data_file) {
+            data_file = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!input_file || param_specs.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (config_file && !base.load_file(config_file)) {
+        return 1;
+    }
+    for (size_t i = 0; i < overrides.size(); i++) {
+        if (!base.set(overrides[i])) {
+            return 1;
+        }
+    }
+
+    std::vector<APEX_Instruction> code;
+    if (!create_code_memory(input_file, code)) {
+        return 1;
+    }
+    DesignSweep sweep(code, data_file, base);
+    for (size_t i = 0; i < param_specs.size(); i++) {
+        if (!sweep.add_param(param_specs[i])) {
+            return 1;
+        }
+    }
+    if (stats.empty()) {
+        for (size_t i = 0; i < sizeof(default_stats) / sizeof(default_stats[0]); i++) {
+            sweep.add_stat(default_stats[i]);
+        }
+    }
+    for (size_t i = 0; i < stats.size(); i++) {
+        sweep.add_stat(stats[i]);
+    }
+    sweep.set_limits(max_insns, max_cycles);
+    sweep.set_stall_limit(stall_limit);
+    // Keep stdout to the table when it goes there
+    FILE* info = out_file ? stdout : stderr;
+    size_t count = lhs > 0 ? sweep.make_latin_hypercube(lhs, seed) : sweep.make_grid();
+    fprintf(info, "Sweep: %lu points\n", (unsigned long)count);
+
+    Logger::start();
+    sweep.run(jobs);
+    Logger::stop();
+    if (out_file) {
+        if (!sweep.write_file(out_file)) {
+            return 1;
+        }
+    } else {
+        sweep.write(stdout, false);
+    }
+    sweep.print_summary(info);
+    return 0;
+}
@@ -0,0 +1,210 @@
+// src/what_if.cpp
+#include "what_if.h"
+#include "apex_cpu.h"
+#include "core_variants.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static double host_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void write_all(int fd, const char* text) {
+    size_t left = strlen(text);
+    while (left > 0) {
+        ssize_t n = write(fd, text, left);
+        if (n <= 0) {
+            return;
+        }
+        text += n;
+        left -= (size_t)n;
+    }
+}
+
+WhatIfFork::WhatIfFork(const SimConfig& base_config, uint64_t at_cycle, uint64_t cycle_limit)
+    : base(base_config) {
+    fork_cycle = at_cycle;
+    max_cycles = cycle_limit;
+    fork_committed = 0;
+    prefix_seconds = 0.0;
+}
+
+// Runs in the child, which leaves with _exit so the parent's stdio
+// buffers and atexit handlers are not run twice
+bool WhatIfFork::run_child(APEX_CPU& cpu, const std::string& spec, int fd) {
+    char record[256];
+    SimConfig next = base;
+    std::string list = spec;
+    char* save = NULL;
+    for (char* item = strtok_r(&list[0], ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        if (!next.set(item)) {
+            snprintf(record, sizeof(record), "error bad override %s\n", item);
+            write_all(fd, record);
+            return false;
+        }
+    }
+    // A fixed build would silently run its own value instead of the override
+    SimConfig pinned = next;
+    CoreVariant::apply(pinned, true);
+    if (memcmp(&pinned, &next, sizeof(SimConfig)) != 0) {
+        snprintf(record, sizeof(record), "error the %s build is fixed, override ignored\n",
+                 CoreVariant::name());
+        write_all(fd, record);
+        return false;
+    }
+    if (!next.validate()) {
+        write_all(fd, "error invalid configuration\n");
+        return false;
+    }
+    if (!cpu.reconfigure(next)) {
+        write_all(fd, "error only widths and dcache_miss_penalty can change after the fork\n");
+        return false;
+    }
+
+    double begin = host_now();
+    while (!cpu.is_halted() && (max_cycles == 0 || cpu.get_cycles() < max_cycles)) {
+        cpu.single_step();
+    }
+    double seconds = host_now() - begin;
+
+    double mpki = 0.0;
+    std::vector<StatValue> values;
+    cpu.get_stats().collect(values);
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i].name == "cpu.mpki") {
+            mpki = values[i].value;
+        }
+    }
+    snprintf(record, sizeof(record), "ok %lu %lu %d %.6f %.6f\n",
+             (unsigned long)cpu.get_cycles(), (unsigned long)cpu.get_committed(),
+             cpu.is_halted() ? 1 : 0, mpki, seconds);
+    write_all(fd, record);
+    return true;
+}
+
+bool WhatIfFork::run(APEX_CPU& cpu) {
+    double begin = host_now();
+    while (!cpu.is_halted() && cpu.get_cycles() < fork_cycle) {
+        cpu.single_step();
+    }
+    prefix_seconds = host_now() - begin;
+    if (cpu.is_halted()) {
+        fprintf(stderr, "APEX_Error: Program halted at cycle %lu, before the fork\n",
+                (unsigned long)cpu.get_cycles());
+        return false;
+    }
+    fork_committed = cpu.get_committed();
+    if (specs.empty()) {
+        specs.push_back("");  // Baseline only
+    }
+
+    // Every child is started before any pipe is read, so variants run in
+    // parallel; a record fits the pipe buffer, so no child blocks on write
+    std::vector<pid_t> children(specs.size(), -1);
+    std::vector<int> pipes(specs.size(), -1);
+    fflush(stdout);
+    fflush(stderr);
+    for (size_t i = 0; i < specs.size(); i++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            perror("APEX_Error: pipe");
+            break;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("APEX_Error: fork");
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            for (size_t j = 0; j < i; j++) {
+                close(pipes[j]);
+            }
+            bool child_ok = run_child(cpu, specs[i], fds[1]);
+            close(fds[1]);
+            fflush(stdout);
+            _exit(child_ok ? 0 : 1);
+        }
+        close(fds[1]);
+        children[i] = pid;
+        pipes[i] = fds[0];
+    }
+
+    results.clear();
+    bool ok = true;
+    for (size_t i = 0; i < specs.size(); i++) {
+        WhatIfResult r;
+        r.spec = specs[i];
+        r.ok = false;
+        r.cycles = 0;
+        r.committed = 0;
+        r.halted = false;
+        r.mpki = 0.0;
+        r.host_seconds = 0.0;
+        if (children[i] < 0) {
+            r.error = "not started";
+            results.push_back(r);
+            ok = false;
+            continue;
+        }
+
+        std::string record;
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(pipes[i], buffer, sizeof(buffer))) > 0) {
+            record.append(buffer, (size_t)n);
+        }
+        close(pipes[i]);
+        int status = 0;
+        waitpid(children[i], &status, 0);
+
+        unsigned long cycles = 0, committed = 0;
+        int halted = 0;
+        bool exited_ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (exited_ok && sscanf(record.c_str(), "ok %lu %lu %d %lf %lf", &cycles, &committed,
+                                &halted, &r.mpki, &r.host_seconds) == 5) {
+            r.ok = true;
+            r.cycles = cycles;
+            r.committed = committed;
+            r.halted = halted != 0;
+        } else if (record.compare(0, 6, "error ") == 0) {
+            r.error = record.substr(6, record.find('\n') - 6);
+        } else {
+            r.error = WIFSIGNALED(status) ? "child killed by a signal" : "no result";
+        }
+        if (!r.ok) {
+            ok = false;
+        }
+        results.push_back(r);
+    }
+    return ok;
+}
+
+void WhatIfFork::print(FILE* out) const {
+    fprintf(out, "What-if: forked %d variants at cycle %lu (%lu committed), shared run %.3f s\n",
+            (int)results.size(), (unsigned long)fork_cycle, (unsigned long)fork_committed,
+            prefix_seconds);
+    fprintf(out, "  %-32s %10s %10s %7s %10s %7s %8s\n", "variant", "cycles", "committed",
+            "IPC", "IPC after", "MPKI", "host s");
+    for (size_t i = 0; i < results.size(); i++) {
+        const WhatIfResult& r = results[i];
+        const char* name = r.spec.empty() ? "(baseline)" : r.spec.c_str();
+        if (!r.ok) {
+            fprintf(out, "  %-32s failed: %s\n", name, r.error.c_str());
+            continue;
+        }
+        uint64_t after_cycles = r.cycles - fork_cycle;
+        fprintf(out, "  %-32s %10lu %10lu %7.3f %10.3f %7.2f %8.3f%s\n", name,
+                (unsigned long)r.cycles, (unsigned long)r.committed,
+                r.cycles ? (double)r.committed / r.cycles : 0.0,
+                after_cycles ? (double)(r.committed - fork_committed) / after_cycles : 0.0,
+                r.mpki, r.host_seconds, r.halted ? "" : " (not halted)");
+    }
+}